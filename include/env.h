@@ -14,21 +14,58 @@
 #define OTA_PASSWORD "marvinOTA2025"
 #define OTA_PORT 3232
 
+// Model-only OTA (KWS_MODEL_BLOB): POST a .kwsm blob to http://<ip>:MODEL_OTA_PORT/model
+#define MODEL_OTA_PORT 8080
+// Pipeline telemetry (lib/Telemetry): GET http://<ip>:TELEMETRY_PORT/telemetry returns a JSON snapshot
+#define TELEMETRY_PORT 8081
+#define MODEL_OTA_USER "marvin"   // password is OTA_PASSWORD
+
 // ===================== Debug / App =====================
 #define DEBUG_LEVEL 2
 #define ENABLE_SERIAL_PLOT 0
 
-// Detection behavior
-#define DETECTION_COOLDOWN_MS 1000
+// Hot-path trace events (lib/Trace): 0 compiles them out, 1 errors and
+// detections, 2 adds one event per inference, 3 several per 10 ms frame.
+// Batches go to UDP, or to the serial port between the text logs; decode
+// either with tools/trace_decode.py.
+#define TRACE_LEVEL 2
+#define TRACE_SINK_UART 1
+#define TRACE_SINK_UDP 2
+#define TRACE_SINK TRACE_SINK_UDP
+#define TRACE_UDP_HOST "255.255.255.255"  // broadcast; or the collector's address
+#define TRACE_UDP_PORT 9999
+
+// Detection behavior (DecisionEngine defaults)
+#define DETECTION_COOLDOWN_MS 1000   // refractory period after a detection, in stream time
+#define DETECTION_BEEP_MS 200
+#define DECISION_SMOOTH_N 3          // posteriors averaged per decision
+#define DECISION_PEAK_WAIT 5         // posteriors to wait for the smoothed one to peak
+#define DECISION_NEAR_MISS 0.15f     // smoothed peaks from here to WAKE_PROB_THRESH count as near misses
 #define COMMAND_LISTEN_DURATION_SEC 5
 #define COMMAND_CONFIDENCE_THRESHOLD 0.30f
 
+// Voice activity gate (VadGate defaults, see lib/VAD)
+#define VAD_ENABLED 1
+#define VAD_ENERGY_MARGIN_DB 6.0f
+#define VAD_FLATNESS_MAX 0.45f
+#define VAD_FLUX_MIN 0.35f
+#define VAD_ONSET_FRAMES 2
+#define VAD_HANGOVER_FRAMES 30   // 300 ms at a 10 ms hop
+#define VAD_PRE_ROLL_FRAMES 20   // must stay <= KWS_FRAMES
+
 // ===================== Hardware Pins (ESP32-S3 DevKitC-1) =====================
 // I2S Microphone (INMP441)
 #define I2S_BCLK_PIN 18
 #define I2S_LRCL_PIN 10
 #define I2S_DOUT_PIN 21
 
+// I2S capture (AudioCapture)
+#define AUDIO_DMA_BUF_COUNT   8      // DMA buffers the driver cycles through
+#define AUDIO_DMA_BUF_LEN     256    // samples per DMA buffer (16 ms)
+#define AUDIO_GAIN_SHIFT      8      // int16 = 24-in-32 sample >> shift; 16 is unity, 8 is +48 dB
+#define AUDIO_RING_SAMPLES    2048   // converted samples buffered ahead of the frontend; power of two
+#define AUDIO_READ_TIMEOUT_MS 100    // readHop() gives up after this long without DMA data
+
 // I2C (AHT10)
 #define I2C_SDA_PIN 8
 #define I2C_SCL_PIN 9
@@ -40,11 +77,24 @@
 // ===================== Wake Word Model =====================
 #define WAKE_CLASS_INDEX   0
 #define WAKE_PROB_THRESH   0.30f
+#define KWS_MODEL_INT8     1      // 1: full int8 DS-CNN (Int8DSCNN), 0: float ManualDSCNN
+#define KWS_MODEL_BLOB     0      // 1: ModelRuntime on the blob in the model_a/model_b partitions (overrides KWS_MODEL_INT8)
+
+// Pipeline: capture + frontend on core 0, inference + decision on core 1
+#define KWS_PIPELINE       1      // 0: one task reads, computes and infers in turn
+#define KWS_CAPTURE_PRIO   10     // above loop() and inference (1), below the Wi-Fi/lwIP tasks
+#define KWS_HOP_QUEUE_LEN  128    // hops inference may lag (1.28 s) before events drop; power of two
+
+// Inference cadence (InferenceScheduler defaults)
+#define KWS_IDLE_STRIDE_HOPS 4     // run every 4th hop (40 ms) while quiet
+#define KWS_SUSPICIOUS_PROB  0.10f // at or above: run every hop
+#define KWS_ALERT_HOLD_HOPS  50    // stay at the every-hop cadence for 500 ms
 
 // Buzzer (LEDC)
 #define BUZZER_CHANNEL 0
 
 // smoke test mode
 #define MIC_SMOKE_TEST 0  // Set to 0 to disable, 1 to enable
+#define AP_DUMMY_TONE  0  // 1: the frontend ignores its input and analyses a 440 Hz test tone
 
 // Notes: AP_FRAME_SAMPLES / AP_HOP_SAMPLES come from frontend_params.h only.
@@ -14,8 +14,21 @@
 #define AP_FRAME_SAMPLES   ((KWS_SAMPLE_RATE_HZ * KWS_FRAME_MS)  / 1000)   // e.g., 320 for 20ms @ 16k
 #define AP_HOP_SAMPLES     ((KWS_SAMPLE_RATE_HZ * KWS_STRIDE_MS) / 1000)   // e.g., 160 for 10ms @ 16k
 
-// FFT sizing for MFCC (power-of-two >= AP_FRAME_SAMPLES)
+// Input gain ahead of the analysis window. It is folded into the frontend
+// tables (FrontendTables.h) rather than applied per sample.
+#define AP_INPUT_GAIN      0.1
+
+// FFT sizing for MFCC. Default is power-of-two >= AP_FRAME_SAMPLES (zero-padded).
+// Set AP_FFT_MATCH_FRAME to 1 to run a mixed-radix FFT of exactly AP_FRAME_SAMPLES
+// points instead (320 = 4*4*2*5 complex stage, no padding).
+#ifndef AP_FFT_MATCH_FRAME
+#define AP_FFT_MATCH_FRAME 0
+#endif
+#if AP_FFT_MATCH_FRAME
+#define AP_FFT_SIZE        AP_FRAME_SAMPLES
+#else
 #define AP_FFT_SIZE        512
+#endif
 #define AP_FFT_BINS        (AP_FFT_SIZE/2 + 1)
 
 // Optional: index of the wake class if you want it centralized here
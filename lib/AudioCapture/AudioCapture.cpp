@@ -1,8 +1,20 @@
-#pragma once
 #include "AudioCapture.h"
-#include <driver/i2s.h>
+#include "DSPKernels.h"
 #include "frontend_params.h"
 #include "env.h"
+#include "Trace.h"
+#ifndef ARDUINO
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+// Events the driver may post before pump() runs; it drops the oldest beyond
+// that, so an overflow older than this many DMA buffers goes uncounted.
+static const int kEventQueueLen = 4 * AUDIO_DMA_BUF_COUNT;
+
+#ifdef ARDUINO
 
 bool AudioCapture::probe_() {
     i2s_driver_uninstall(I2S_NUM_0);
@@ -15,17 +27,18 @@ bool AudioCapture::probe_() {
         .channel_format = I2S_CHANNEL_FMT_RIGHT_LEFT,  // Test this
         .communication_format = I2S_COMM_FORMAT_STAND_I2S,
         .intr_alloc_flags = ESP_INTR_FLAG_LEVEL1,
-        .dma_buf_count = 8,
-        .dma_buf_len = 256,
+        .dma_buf_count = AUDIO_DMA_BUF_COUNT,
+        .dma_buf_len = AUDIO_DMA_BUF_LEN,
         .use_apll = true,
         .tx_desc_auto_clear = false,
         .fixed_mclk = 0,
     };
 
-    esp_err_t e = i2s_driver_install(I2S_NUM_0, &cfg, 0, nullptr);
+    esp_err_t e = i2s_driver_install(I2S_NUM_0, &cfg, kEventQueueLen, &events_);
     if (e != ESP_OK) {
         Serial.printf("ERROR: I2S install: %s\n", esp_err_to_name(e));
         Serial.flush();
+        events_ = nullptr;
         return false;
     }
 
@@ -43,9 +56,6 @@ bool AudioCapture::probe_() {
         Serial.flush();
         return false;
     }
-    Serial.printf("✅ INMP441 I2S init: SR=%d, LEFT, pins: BCLK=%d, WS=%d, DIN=%d\n",
-                KWS_SAMPLE_RATE_HZ, I2S_BCLK_PIN, I2S_LRCL_PIN, I2S_DOUT_PIN);
-    Serial.flush();
 
     e = i2s_set_clk(I2S_NUM_0, KWS_SAMPLE_RATE_HZ, I2S_BITS_PER_SAMPLE_32BIT, I2S_CHANNEL_MONO);
     if (e != ESP_OK) {
@@ -54,8 +64,9 @@ bool AudioCapture::probe_() {
         return false;
     }
 
-    Serial.printf("✅ INMP441 I2S init: SR=%d, LEFT, pins: BCLK=%d, WS=%d, DIN=%d\n",
-                  KWS_SAMPLE_RATE_HZ, I2S_BCLK_PIN, I2S_LRCL_PIN, I2S_DOUT_PIN);
+    Serial.printf("✅ INMP441 I2S init: SR=%d, LEFT, pins: BCLK=%d, WS=%d, DIN=%d, DMA %dx%d, gain shift %d\n",
+                  KWS_SAMPLE_RATE_HZ, I2S_BCLK_PIN, I2S_LRCL_PIN, I2S_DOUT_PIN,
+                  AUDIO_DMA_BUF_COUNT, AUDIO_DMA_BUF_LEN, AUDIO_GAIN_SHIFT);
     Serial.flush();
     return true;
 }
@@ -63,54 +74,224 @@ bool AudioCapture::probe_() {
 bool AudioCapture::begin() {
     i2s_driver_uninstall(I2S_NUM_0);  // Force uninstall even if error
     delay(100);
+    ring_.reset();
+    gaps_.reset();
+    stats_ = {};
     return probe_();
 }
 
-bool AudioCapture::readFrame(int16_t* pcm_out) {
-    if (!pcm_out) {
-        Serial.println("ERROR: pcm_out is null");
-        Serial.flush();
-        return false;
+size_t AudioCapture::pump(uint32_t wait_ms) {
+    if (!events_) return 0;
+
+    // Take every pending event before reading. On overflow the driver drops
+    // the oldest unread buffer, so everything lost since the last pump lies
+    // between what was already read and what is still queued: one gap at the
+    // current stream position, then the surviving buffers.
+    i2s_event_t ev;
+    uint32_t overflows = 0;
+    size_t lost = 0;
+    TickType_t wait = pdMS_TO_TICKS(wait_ms);
+    while (xQueueReceive(events_, &ev, wait) == pdTRUE) {
+        wait = 0;
+        if (ev.type == I2S_EVENT_RX_Q_OVF) {
+            overflows++;
+            lost += ev.size ? ev.size / sizeof(int32_t) : AUDIO_DMA_BUF_LEN;
+        }
     }
-    const size_t need_bytes = AP_FRAME_SAMPLES * sizeof(int32_t);
-    size_t got = 0;
-    int32_t raw32[AP_FRAME_SAMPLES];
+    if (overflows) onOverflow_(overflows, lost);
 
-    esp_err_t e = i2s_read(I2S_NUM_0, raw32, need_bytes, &got, portMAX_DELAY);
-    if (e != ESP_OK || got < need_bytes) {
-        Serial.printf("ERROR: I2S read: %s, got %d/%d\n", esp_err_to_name(e), got, need_bytes);
-        Serial.flush();
-        memset(pcm_out, 0, AP_FRAME_SAMPLES * sizeof(int16_t));
-        return false;
+    size_t added = 0;
+    size_t got;
+    do {
+        got = 0;
+        i2s_read(I2S_NUM_0, dma_, sizeof(dma_), &got, 0);
+        if (got) added += onBlock_(dma_, got / sizeof(int32_t));
+    } while (got == sizeof(dma_));
+    return added;
+}
+
+#else
+
+// Host stand-in: no driver. Blocks arrive through injectBlock() and
+// injectOverflow(), or from an open WAV file, and run the same conversion
+// and accounting.
+bool AudioCapture::probe_() {
+    return true;
+}
+
+bool AudioCapture::begin() {
+    ring_.reset();
+    gaps_.reset();
+    stats_ = {};
+    return probe_();
+}
+
+static bool wavError_(const char* path, const char* why) {
+    Serial.printf("ERROR: WAV %s: %s\n", path, why);
+    Serial.flush();
+    return false;
+}
+
+bool AudioCapture::openWav(const char* path) {
+    closeWav();
+    const int fd = open(path, O_RDONLY);
+    if (fd < 0) return wavError_(path, "cannot open");
+    struct stat st;
+    void* map = MAP_FAILED;
+    if (fstat(fd, &st) == 0 && st.st_size >= 12) {
+        map = mmap(nullptr, (size_t)st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
     }
+    close(fd);
+    if (map == MAP_FAILED) return wavError_(path, "cannot map");
+    wav_map_ = map;
+    wav_map_size_ = (size_t)st.st_size;
 
-    static int debug_count = 0;
-    bool show_debug = (DEBUG_LEVEL >= 3) && (debug_count % 10 == 0);  // Every 10th frame
-    if (show_debug) {
-        Serial.printf("DEBUG: Raw I2S bytes [0-4]: 0x%08x 0x%08x 0x%08x 0x%08x 0x%08x\n",
-                      raw32[0], raw32[1], raw32[2], raw32[3], raw32[4]);
-        int32_t sum_abs = 0;
-        for (int i = 0; i < AP_FRAME_SAMPLES; ++i) {
-            sum_abs += abs(raw32[i]);
+    // Walk the chunks (little-endian, like the host) for "fmt " and "data".
+    const uint8_t* p = static_cast<const uint8_t*>(map);
+    const size_t size = wav_map_size_;
+    if (memcmp(p, "RIFF", 4) != 0 || memcmp(p + 8, "WAVE", 4) != 0) {
+        closeWav();
+        return wavError_(path, "not a RIFF/WAVE file");
+    }
+    uint16_t format = 0, channels = 0, bits = 0;
+    uint32_t rate = 0;
+    for (size_t off = 12; off + 8 <= size;) {
+        uint32_t len;
+        memcpy(&len, p + off + 4, 4);
+        const uint8_t* body = p + off + 8;
+        const size_t avail = size - off - 8;
+        if (memcmp(p + off, "fmt ", 4) == 0 && avail >= 16) {
+            memcpy(&format, body, 2);
+            memcpy(&channels, body + 2, 2);
+            memcpy(&rate, body + 4, 4);
+            memcpy(&bits, body + 14, 2);
+        } else if (memcmp(p + off, "data", 4) == 0) {
+            const char* why = nullptr;
+            if (format != 1 && format != 0xFFFE) why = "not integer PCM";
+            else if (bits != 16 && bits != 24 && bits != 32) why = "unsupported sample size";
+            else if (channels == 0) why = "no channels";
+            else if (rate != KWS_SAMPLE_RATE_HZ) why = "wrong sample rate";
+            if (why) {
+                closeWav();
+                return wavError_(path, why);
+            }
+            wav_bytes_ = bits / 8;
+            wav_stride_ = wav_bytes_ * channels;
+            wav_data_ = body;
+            wav_frames_ = (len < avail ? len : avail) / wav_stride_;  // streamed files may overstate len
+            wav_pos_ = 0;
+            return true;
         }
-        Serial.printf("DEBUG: Raw I2S sum_abs=%d\n", sum_abs);
-        Serial.flush();
+        off += 8 + (size_t)len + (len & 1);
     }
+    closeWav();
+    return wavError_(path, "no data chunk");
+}
 
-    for (int i = 0; i < AP_FRAME_SAMPLES; ++i) {
-        int32_t s = raw32[i] >> 8;  // 24-bit to 16-bit
-        if (s > 32767) s = 32767;
-        if (s < -32768) s = -32768;
-        pcm_out[i] = (int16_t)s;
-        if (show_debug && i < 4) {
-            Serial.printf("DEBUG: Sample %d: raw=0x%08x shifted=%d\n", i, raw32[i], pcm_out[i]);
-        }
+void AudioCapture::closeWav() {
+    if (wav_map_) munmap(wav_map_, wav_map_size_);
+    wav_map_ = nullptr;
+    wav_map_size_ = 0;
+    wav_data_ = nullptr;
+    wav_frames_ = 0;
+    wav_pos_ = 0;
+}
+
+// One DMA buffer's worth of the file per call, no waiting. Each sample is
+// left-aligned to 32 bits and placed so the gain shift brings back its top
+// 16 bits: the frontend sees the file at its 16-bit level.
+size_t AudioCapture::pump(uint32_t wait_ms) {
+    (void)wait_ms;  // the file is always ready
+    const size_t left = wav_frames_ - wav_pos_;
+    const size_t n = left < AUDIO_DMA_BUF_LEN ? left : AUDIO_DMA_BUF_LEN;
+    if (n == 0) return 0;
+    const uint8_t* src = wav_data_ + wav_pos_ * wav_stride_;
+    for (size_t i = 0; i < n; ++i, src += wav_stride_) {
+        uint32_t x = 0;
+        memcpy(reinterpret_cast<uint8_t*>(&x) + 4 - wav_bytes_, src, wav_bytes_);
+        dma_[i] = (int32_t)x >> (16 - AUDIO_GAIN_SHIFT);
+    }
+    wav_pos_ += n;
+    return onBlock_(dma_, n);
+}
+
+#endif
+
+// Converts one DMA buffer straight into the ring's free space. A full ring
+// keeps the older samples and drops the tail of the block.
+size_t AudioCapture::onBlock_(const int32_t* raw, size_t n) {
+    const RingBuffer<int16_t, AUDIO_RING_SAMPLES>::WriteSpans w = ring_.reserve();
+    const size_t first = n < w.first_n ? n : w.first_n;
+    const size_t second = n - first < w.second_n ? n - first : w.second_n;
+    dspk::pcm24(raw, w.first, (int)first, AUDIO_GAIN_SHIFT);
+    if (second) dspk::pcm24(raw + first, w.second, (int)second, AUDIO_GAIN_SHIFT);
+    ring_.commit(first + second);
+    stats_.dma_blocks++;
+    stats_.samples += first + second;
+
+    const size_t lost = n - first - second;
+    if (lost) {
+        ring_.addOverruns(lost);
+        stats_.ring_overruns += lost;
+        onOverflow_(0, lost);
     }
+    clock_at_ = stats_.samples;
+    clock_us_ = micros();
+    return first + second;
+}
 
-    if (show_debug) {
-        Serial.println("DEBUG: readFrame succeeded");
+uint32_t AudioCapture::sampleTimeUs(uint64_t pos) const {
+#ifdef ARDUINO
+    const int64_t back = (int64_t)(clock_at_ - pos);
+    return clock_us_ - (uint32_t)(back * 1000000 / KWS_SAMPLE_RATE_HZ);
+#else
+    // Files and injected blocks arrive faster than real time: every sample
+    // of a block counts as taken when the block was read.
+    (void)pos;
+    return clock_us_;
+#endif
+}
+
+void AudioCapture::onOverflow_(uint32_t events, size_t samples) {
+    stats_.overflows += events;
+    // A full log keeps the oldest gaps; dropped still counts every sample.
+    gaps_.write(Gap{ stats_.samples, (uint32_t)samples, (uint32_t)micros() });
+    TRACE(CAPTURE_GAP, stats_.samples, samples);
+    stats_.dropped += samples;
+    stats_.samples += samples;
+}
+
+bool AudioCapture::readFrame(int16_t* pcm_out) {
+    return readSamples_(pcm_out, AP_FRAME_SAMPLES);
+}
+
+bool AudioCapture::readHop(int16_t* pcm_out) {
+    return readSamples_(pcm_out, AP_HOP_SAMPLES);
+}
+
+bool AudioCapture::readSamples_(int16_t* pcm_out, int n) {
+    if (!pcm_out) {
+        Serial.println("ERROR: pcm_out is null");
         Serial.flush();
+        return false;
+    }
+    if (n > AP_FRAME_SAMPLES) n = AP_FRAME_SAMPLES;
+
+#ifdef ARDUINO
+    const uint32_t start = millis();
+    while (ring_.available() < (size_t)n) {
+        const uint32_t waited = millis() - start;
+        if (waited >= AUDIO_READ_TIMEOUT_MS) break;
+        pump(AUDIO_READ_TIMEOUT_MS - waited);
+    }
+#else
+    while (ring_.available() < (size_t)n && pump(0)) {}
+#endif
+    if (ring_.available() < (size_t)n) {
+        TRACE(CAPTURE_READ_FAIL, ring_.available(), n);
+        memset(pcm_out, 0, n * sizeof(int16_t));
+        return false;
     }
-    debug_count++;
+    ring_.read(pcm_out, n);
     return true;
 }
@@ -1,18 +1,98 @@
 #pragma once
 #include <Arduino.h>
+#ifdef ARDUINO
 #include <driver/i2s.h>
+#include <freertos/queue.h>
+#endif
 #include "env.h"
 #include "frontend_params.h"
+#include "RingBuffer.h"
 
+// Event-driven I2S capture. The driver posts an event per completed DMA
+// buffer; pump() takes the finished buffers and converts them (dspk::pcm24)
+// straight into the free space of the sample ring. readHop()/readFrame()
+// pump until the ring holds enough and copy out.
+//
+// Lost audio is counted, not hidden. I2S_EVENT_RX_Q_OVF (no free DMA buffer,
+// i.e. nobody pumped for AUDIO_DMA_BUF_COUNT buffers) and a full ring both
+// add to stats().dropped, and each loss is logged as a Gap at its position in
+// the sample stream. samples counts the stream including lost samples, so
+// positions stay aligned with the microphone clock.
+//
+// Off target there is no driver: injectBlock()/injectOverflow() feed
+// synthetic DMA buffers through the same conversion and accounting, and
+// openWav() streams a memory-mapped WAV file as DMA-sized blocks, as fast as
+// they are read.
 class AudioCapture {
 public:
+	struct Stats {
+		uint64_t	samples;		// stream position: delivered + dropped
+		uint32_t	dma_blocks;
+		uint32_t	overflows;		// RX_Q_OVF events
+		uint32_t	dropped;		// samples lost to overflows or a full ring
+		uint32_t	ring_overruns;	// of which the ring refused
+	};
+	struct Gap {
+		uint64_t	at;			// stream position of the first lost sample
+		uint32_t	samples;
+		uint32_t	time_us;	// micros() when the loss was noticed
+	};
+
 	bool begin();
 	bool readFrame(int16_t* pcm_out);	// fills AP_FRAME_SAMPLES
+	bool readHop(int16_t* pcm_out);		// fills AP_HOP_SAMPLES
 
-private:
-	bool probe_();
-};
+	// Waits up to wait_ms for DMA events and converts every finished buffer.
+	// Returns how many samples were added to the ring.
+	size_t pump(uint32_t wait_ms);
+	size_t buffered() const { return ring_.available(); }
+	// Stream position of the next sample readHop()/readFrame() returns.
+	uint64_t position() const { return stats_.samples - ring_.available(); }
+	// micros() when the microphone took sample pos, counted back from the
+	// arrival of the newest DMA buffer at the sample rate (off target, when
+	// that buffer was read). Same task as pump().
+	uint32_t sampleTimeUs(uint64_t pos) const;
 
+	const Stats& stats() const { return stats_; }
+	// Oldest unreported gap; the log keeps the first 16 unread ones.
+	bool popGap(Gap& g) { return !gaps_.empty() && gaps_.read(g); }
 
+#ifndef ARDUINO
+	~AudioCapture() { closeWav(); }
+	void injectBlock(const int32_t* raw, size_t n) { onBlock_(raw, n); }
+	void injectOverflow(size_t samples) { onOverflow_(1, samples); }
 
+	// 16/24/32-bit PCM at KWS_SAMPLE_RATE_HZ; only the first channel is used.
+	// Samples reach the frontend at their 16-bit level whatever the gain
+	// shift. A new file continues the same stream.
+	bool openWav(const char* path);
+	void closeWav();
+	size_t wavSamples() const { return wav_frames_; }
+	// The file is used up and less than a hop is left buffered.
+	bool sourceDone() const { return wav_pos_ >= wav_frames_ && ring_.available() < AP_HOP_SAMPLES; }
+#endif
 
+private:
+	RingBuffer<int16_t, AUDIO_RING_SAMPLES>	ring_;
+	RingBuffer<Gap, 16>						gaps_;
+	Stats		stats_ = {};
+	uint64_t	clock_at_ = 0;		// stream position at the end of the newest DMA buffer
+	uint32_t	clock_us_ = 0;		// micros() when it was taken from the driver
+	int32_t		dma_[AUDIO_DMA_BUF_LEN];	// one DMA buffer as read from the driver
+#ifdef ARDUINO
+	QueueHandle_t	events_ = nullptr;
+#else
+	void*			wav_map_ = nullptr;
+	size_t			wav_map_size_ = 0;
+	const uint8_t*	wav_data_ = nullptr;	// first frame of the data chunk
+	size_t			wav_frames_ = 0;
+	size_t			wav_pos_ = 0;
+	int				wav_bytes_ = 0;			// per sample
+	int				wav_stride_ = 0;		// bytes per frame, all channels
+#endif
+
+	bool probe_();
+	bool readSamples_(int16_t* pcm_out, int n);
+	size_t onBlock_(const int32_t* raw, size_t n);
+	void onOverflow_(uint32_t events, size_t samples);
+};
@@ -1,42 +1,99 @@
 #pragma once
 #include <stdint.h>
 #include "frontend_params.h"
+#include "FFTBackend.h"
+#include "RealFFT.h"
+#include "mfcc_buffer.h"
+#include "FeatureBus.h"
+
+// The all-integer frontend needs a radix-2 FFT size.
+#if (AP_FFT_SIZE & (AP_FFT_SIZE - 1)) == 0
+#define AP_HAS_INT8_FRONTEND 1
+#include "FixedRealFFT.h"
+#else
+#define AP_HAS_INT8_FRONTEND 0
+#endif
 
 class AudioProcessor {
 public:
 	AudioProcessor();
 
 	bool begin();
-	void processFrame(const int16_t* pcm_frame);		// push 20ms
-	void computeMFCCFloat(float* out_mfcc_flat);		// KWS_FRAMES*KWS_NUM_MFCC
+	void processFrame(const int16_t* pcm_frame);		// push 20ms, computes one MFCC row
+	void computeMFCCFloat(float* out_mfcc_flat);		// KWS_FRAMES*KWS_NUM_MFCC, oldest row first
+	void computeMFCCInt8(int8_t* out_q = mfcc_buffer);	// same layout, int8 model input quantization
+
+	// Published rows, read zero-copy by every model (see FeatureBus.h).
+	// computeMFCC*() are copying conveniences on top of it; they may run on
+	// another task than processFrame() and zero-fill like an incomplete
+	// window if the producer keeps overrunning the copy.
+	const FeatureBus& features() const { return bus_; }
+
+	// Frontend arithmetic. Int8 runs the all-integer path (Q15 window,
+	// block-floating-point FFT, integer mel, LUT log2, DCT + normalization
+	// folded into one fixed-point matrix) and stores rows already quantized
+	// with the int8 model's input_scale/input_zero_point. Switching converts
+	// the rows already in the ring. Returns false if AP_FFT_SIZE is not a
+	// power of two.
+	enum class Mode : uint8_t { Float, Int8 };
+	bool setMode(Mode mode);
+	Mode mode() const { return mode_; }
 
 	// Debug/introspection used by detector
 	bool hasFullWindow() const { return ring_full_; }
 	float lastPcmRms() const { return last_pcm_rms_; }
 	float lastMfccMeanAbs() const { return last_mfcc_mean_abs_; }
+	const float* lastPower() const { return mode_ == Mode::Float ? power_ : nullptr; }	// AP_FFT_BINS, float mode only
+
+	// Swap the FFT implementation (e.g. ReferenceDFT on host). Must be
+	// AP_FFT_SIZE points; nullptr restores the built-in RealFFT.
+	bool setFFTBackend(FFTBackend* backend);
 
 private:
-	// ring buffer of frames
-	int16_t	ring_[KWS_FRAMES][AP_FRAME_SAMPLES];
-	int		ring_head_;
-	bool	ring_full_;
+	// normalized MFCC rows, one per processed frame (float or int8 per mode_)
+	FeatureBus	bus_;
+	bool		ring_full_;
+	Mode	mode_;
 
-	// cached MFCC window (flattened)
-	float	mfcc_[KWS_FRAMES * KWS_NUM_MFCC];
 	float	last_pcm_rms_;
 	float	last_mfcc_mean_abs_;
 
-	// mel & dct
-	float	mel_[KWS_NUM_MEL * AP_FFT_BINS];  // Fixed size to match loop
-	float	dct_[KWS_NUM_MFCC * KWS_NUM_MEL];
-
-	// Hann window and power spectrum
-	float	window_[AP_FRAME_SAMPLES];
+	// power spectrum (window, mel and DCT tables are const, see FrontendTables.h)
 	float	power_[AP_FFT_BINS];
 
-	void	buildMel_();
-	void	buildDct_();
+	// FFT: windowed frame in, packed spectrum out (in place)
+	RealFFT<AP_FFT_SIZE>	fft_default_;
+	FFTBackend*				fft_;
+	union {
+		float				fft_buf_[AP_FFT_SIZE];
+		int32_t				fft_q_[AP_FFT_SIZE];
+	};
+
+#if AP_HAS_INT8_FRONTEND
+	FixedRealFFT<AP_FFT_SIZE>	fft_fixed_;
+#endif
+
 	void	computeMfcc_(const int16_t* pcm, float* mfcc_row);
+	void	computeMfccQ_(const int16_t* pcm, int8_t* q_row);
+
+	// computeMfcc_() stage by stage, so the benchmark times the same code.
+	void		stageWindow_(const int16_t* pcm);			// pcm -> fft_buf_, zero padded
+	void		stageFFT_();								// fft_buf_ in place
+	void		stagePower_();								// fft_buf_ -> power_, clamped
+	static void	stageMel_(const float* power, float* mel);	// KWS_NUM_MEL energies
+	static void	stageLog_(float* mel);						// natural log, floored at 1e-5
+	static void	stageDct_(const float* mel, float* row);	// normalized MFCC row
+#if AP_HAS_INT8_FRONTEND
+	// computeMfccQ_() likewise.
+	void		stageWindowQ_(const int16_t* pcm);				// pcm -> fft_q_ (Q15), zero padded
+	int			stageFFTQ_();									// fft_q_ in place; returns its exponent
+	void		stageLogMelQ_(int exponent, int32_t* log_mel) const;	// power, mel and log2 in one pass, Q16
+	// Quantized row; acc_q40 (optional) gets the Q40 sums before rounding.
+	static void	stageDctQ_(const int32_t* log_mel, int8_t* q_row, int64_t* acc_q40 = nullptr);
+#endif
+
+	friend class KwsBench;
+	friend class FrontendProbe;	// test_frontend_int8
 };
 
 
@@ -3,272 +3,346 @@
 #include <Arduino.h>
 #include <math.h>
 #include <string.h>
-#include <ArduinoFFT.h>
 #include "mfcc_norm.h"
 #include "env.h"
+#include "model_weights.h"  // input_scale / input_zero_point of the int8 model
+#include "DSPMath.h"
+#include "DSPKernels.h"
+#include "FixedLog2.h"
+#include "FrontendTables.h"
+#include "Trace.h"
 
-// Reduce FFT size for testing
-#define AP_FRAME_SAMPLES 512
-#define AP_FFT_BINS (AP_FRAME_SAMPLES / 2)
+// Float path clamps mel energy at 1e-5 before the log; same floor in Q16 log2.
+static constexpr int32_t kLogFloorQ16 = (int32_t)(dspmath::log2(1e-5) * 65536.0 - 0.5);
+// Copies of a window the producer overran before computeMFCC*() gives up
+// and returns zeros.
+static constexpr int kCopyTries = 3;
 
 AudioProcessor::AudioProcessor()
-    : ring_head_(0), ring_full_(false), last_pcm_rms_(0.0f), last_mfcc_mean_abs_(0.0f) {
-    memset(ring_, 0, sizeof(ring_));
-    memset(mfcc_, 0, sizeof(mfcc_));
-    memset(mel_, 0, sizeof(mel_));
-    memset(dct_, 0, sizeof(dct_));
+    : ring_full_(false), mode_(Mode::Float), last_pcm_rms_(0.0f),
+      last_mfcc_mean_abs_(0.0f), fft_(&fft_default_) {
     memset(power_, 0, sizeof(power_));
-    for (int i = 0; i < AP_FRAME_SAMPLES; ++i) {
-        window_[i] = 0.5f * (1.0f - cosf(2.0f * M_PI * (float)i / (float)(AP_FRAME_SAMPLES - 1)));
-    }
+    memset(fft_buf_, 0, sizeof(fft_buf_));
 }
 
 bool AudioProcessor::begin() {
     Serial.println("DEBUG: AudioProcessor begin");
     Serial.printf("DEBUG: Free heap: %u bytes\n", ESP.getFreeHeap());
-    buildMel_();
-    buildDct_();
-    ring_head_ = 0;
-    ring_full_ = true;  // Force true for testing
+    Serial.printf("DEBUG: Frontend tables in flash: %u bytes, %d mel weights\n",
+                  (unsigned)sizeof(kFrontendTables), kFrontendTables.mel_num_weights);
+    Serial.printf("DEBUG: DSP kernels: %s\n", dspk::variantName());
+    bus_.reset();
+    ring_full_ = false;
     Serial.flush();
     return true;
 }
 
+bool AudioProcessor::setFFTBackend(FFTBackend* backend) {
+    if (!backend) {
+        fft_ = &fft_default_;
+        return true;
+    }
+    if (backend->size() != AP_FFT_SIZE) {
+        Serial.printf("ERROR: FFT backend size %d != %d\n", backend->size(), AP_FFT_SIZE);
+        Serial.flush();
+        return false;
+    }
+    fft_ = backend;
+    return true;
+}
+
+bool AudioProcessor::setMode(Mode mode) {
+#if !AP_HAS_INT8_FRONTEND
+    if (mode == Mode::Int8) {
+        Serial.println("ERROR: int8 frontend needs a power-of-two AP_FFT_SIZE");
+        Serial.flush();
+        return false;
+    }
+#endif
+    if (mode == mode_) return true;
+    bus_.setFormat(mode == Mode::Int8 ? FeatureBus::Format::Int8 : FeatureBus::Format::Float);
+    mode_ = mode;
+    return true;
+}
+
 void AudioProcessor::processFrame(const int16_t* pcm_frame) {
-    Serial.println("DEBUG: processFrame entered");
     if (!pcm_frame) {
         Serial.println("ERROR: pcm_frame is null");
         Serial.flush();
         return;
     }
-    memcpy(ring_[ring_head_], pcm_frame, sizeof(int16_t) * AP_FRAME_SAMPLES);
-    ring_head_ = (ring_head_ + 1) % KWS_FRAMES;
-    ring_full_ = (ring_head_ == 0);
 
-    static bool use_dummy = true;
-    if (use_dummy) {
-        Serial.println("DEBUG: Using dummy PCM");
-        for (int i = 0; i < AP_FRAME_SAMPLES; ++i) {
-            ring_[ring_head_][i] = (int16_t)(32767.0f * sinf(2.0f * M_PI * 440.0f * i / KWS_SAMPLE_RATE_HZ));
-        }
-    } else {
-        float scale = 0.1f;
+#if AP_DUMMY_TONE
+    static int16_t tone[AP_FRAME_SAMPLES];
+    static bool tone_ready = false;
+    if (!tone_ready) {
+        tone_ready = true;
         for (int i = 0; i < AP_FRAME_SAMPLES; ++i) {
-            ring_[ring_head_][i] = (int16_t)(pcm_frame[i] * scale);
+            tone[i] = (int16_t)(32767.0f * sinf(2.0f * M_PI * 440.0f * i / KWS_SAMPLE_RATE_HZ));
         }
     }
+    pcm_frame = tone;
+#endif
 
+    // The window is read in place (the framer's span); AP_INPUT_GAIN is
+    // applied by the window tables, and to the level here.
     long long acc = 0;
     for (int i = 0; i < AP_FRAME_SAMPLES; ++i) {
-        int32_t s = ring_[ring_head_][i];
+        int32_t s = pcm_frame[i];
         acc += (long long)s * (long long)s;
     }
-    last_pcm_rms_ = sqrtf((float)acc / (float)AP_FRAME_SAMPLES);
+    last_pcm_rms_ = (float)AP_INPUT_GAIN * sqrtf((float)acc / (float)AP_FRAME_SAMPLES);
 
-    static int frame_count = 0;
-    if (DEBUG_LEVEL >= 2 && frame_count % 10 == 0) {  // Every 10th frame
-        Serial.printf("DEBUG: PCM samples [0-4]: %d %d %d %d %d, RMS: %.1f, ring_full=%d\n",
-                      ring_[ring_head_][0], ring_[ring_head_][1], ring_[ring_head_][2],
-                      ring_[ring_head_][3], ring_[ring_head_][4], last_pcm_rms_, ring_full_);
+    // Streaming: the only MFCC work per hop is the row for the incoming frame.
+    if (mode_ == Mode::Int8) {
+        computeMfccQ_(pcm_frame, bus_.nextMfccQ());
+    } else {
+        computeMfcc_(pcm_frame, bus_.nextMfcc());
+    }
+    bus_.publish();
+    if (bus_.seq() >= (uint32_t)KWS_FRAMES) ring_full_ = true;
+
+    if (TRACE_ON(FRAME_PCM)) {
         int32_t sum_abs = 0;
         for (int i = 0; i < AP_FRAME_SAMPLES; ++i) {
-            sum_abs += abs(ring_[ring_head_][i]);
+            sum_abs += abs(pcm_frame[i]);
         }
-        Serial.printf("DEBUG: PCM sum_abs=%d\n", sum_abs);
-        Serial.flush();
+        TRACE(FRAME_PCM, last_pcm_rms_, (int32_t)(AP_INPUT_GAIN * sum_abs));
     }
-    frame_count++;
 }
 
 void AudioProcessor::computeMFCCFloat(float* out_mfcc_flat) {
-    Serial.println("DEBUG: computeMFCCFloat entered");
-    Serial.printf("DEBUG: Free heap: %u bytes\n", ESP.getFreeHeap());
     if (!out_mfcc_flat) {
         Serial.println("ERROR: out_mfcc_flat is null");
         Serial.flush();
         return;
     }
     if (!ring_full_) {
-        Serial.println("DEBUG: computeMFCCFloat skipped due to ring_full=false");
         memset(out_mfcc_flat, 0, sizeof(float) * KWS_FRAMES * KWS_NUM_MFCC);
         last_mfcc_mean_abs_ = 0.0f;
-        Serial.flush();
+        TRACE(MFCC_WINDOW, 0.0f, 0);
         return;
     }
 
-    Serial.println("DEBUG: computeMFCCFloat processing frames");
-    float mean_abs = 0.0f;
-    int idx = 0;
-    int pos = ring_head_;
-    static int frame_count = 0;  // Add static frame counter
-    for (int f = 0; f < KWS_FRAMES; ++f) {
-        const int i = (pos + f) % KWS_FRAMES;
-        computeMfcc_(ring_[i], &out_mfcc_flat[idx]);
-        idx += KWS_NUM_MFCC;
+    // Under KWS_PIPELINE this runs on the inference task while the frontend
+    // keeps publishing, so a copy the producer overran is taken again.
+    FeatureWindow w;
+    int tries = 0;
+    do {
+        bus_.window(w);
+        if (w.mfcc) {
+            memcpy(out_mfcc_flat, w.mfcc, sizeof(float) * KWS_FRAMES * KWS_NUM_MFCC);
+        } else {
+            for (int i = 0; i < KWS_FRAMES * KWS_NUM_MFCC; ++i) out_mfcc_flat[i] = FeatureBus::dequantize(w.mfcc_q[i]);
+        }
+    } while (!bus_.valid(w) && ++tries < kCopyTries);
+    if (tries == kCopyTries) {
+        memset(out_mfcc_flat, 0, sizeof(float) * KWS_FRAMES * KWS_NUM_MFCC);
+        last_mfcc_mean_abs_ = 0.0f;
+        TRACE(MFCC_WINDOW, 0.0f, 0);
+        return;
     }
 
-    Serial.println("DEBUG: computeMFCCFloat normalizing MFCC");
+    float mean_abs = 0.0f;
     for (int i = 0; i < KWS_FRAMES * KWS_NUM_MFCC; ++i) {
-        int c = i % KWS_NUM_MFCC;
-        out_mfcc_flat[i] = (out_mfcc_flat[i] - MFCC_MEAN[c]) / MFCC_STD[c];
         mean_abs += fabsf(out_mfcc_flat[i]);
     }
     last_mfcc_mean_abs_ = mean_abs / (float)(KWS_FRAMES * KWS_NUM_MFCC);
+    TRACE(MFCC_WINDOW, last_mfcc_mean_abs_, 1);
+}
 
-    if (DEBUG_LEVEL >= 2 && frame_count % 10 == 0) {  // Use frame_count, every 10th call
-        Serial.printf("DEBUG: MFCC[0-4]: %.4f %.4f %.4f %.4f %.4f, mean_abs: %.4f\n",
-                      out_mfcc_flat[0], out_mfcc_flat[1], out_mfcc_flat[2],
-                      out_mfcc_flat[3], out_mfcc_flat[4], last_mfcc_mean_abs_);
+void AudioProcessor::computeMFCCInt8(int8_t* out_q) {
+    if (!out_q) {
+        Serial.println("ERROR: out_q is null");
         Serial.flush();
+        return;
+    }
+    if (!ring_full_) {
+        memset(out_q, (int8_t)input_zero_point, KWS_FRAMES * KWS_NUM_MFCC);
+        last_mfcc_mean_abs_ = 0.0f;
+        return;
     }
-    frame_count++;  // Increment counter
+
+    // As computeMFCCFloat().
+    FeatureWindow w;
+    int tries = 0;
+    do {
+        bus_.window(w);
+        if (w.mfcc_q) {
+            memcpy(out_q, w.mfcc_q, KWS_FRAMES * KWS_NUM_MFCC);
+        } else {
+            for (int i = 0; i < KWS_FRAMES * KWS_NUM_MFCC; ++i) out_q[i] = FeatureBus::quantize(w.mfcc[i]);
+        }
+    } while (!bus_.valid(w) && ++tries < kCopyTries);
+    if (tries == kCopyTries) {
+        memset(out_q, (int8_t)input_zero_point, KWS_FRAMES * KWS_NUM_MFCC);
+        last_mfcc_mean_abs_ = 0.0f;
+        return;
+    }
+
+    int32_t sum_abs = 0;
+    for (int i = 0; i < KWS_FRAMES * KWS_NUM_MFCC; ++i) {
+        sum_abs += abs((int32_t)out_q[i] - input_zero_point);
+    }
+    last_mfcc_mean_abs_ = (float)sum_abs * input_scale / (float)(KWS_FRAMES * KWS_NUM_MFCC);
 }
 
-void AudioProcessor::buildMel_() {
-    Serial.println("DEBUG: buildMel_ entered");
-    const float f_min = 20.0f;
-    const float f_max = (float)KWS_SAMPLE_RATE_HZ / 2.0f;
-    const float mel_min = 1125.0f * logf(1.0f + f_min / 700.0f);
-    const float mel_max = 1125.0f * logf(1.0f + f_max / 700.0f);
-    float mel_points[KWS_NUM_MEL + 2];
-    for (int i = 0; i < KWS_NUM_MEL + 2; ++i) {
-        mel_points[i] = mel_min + (float)i * (mel_max - mel_min) / (float)(KWS_NUM_MEL + 1);
+void AudioProcessor::computeMfccQ_(const int16_t* pcm, int8_t* q_row) {
+#if AP_HAS_INT8_FRONTEND
+    stageWindowQ_(pcm);
+    const int exponent = stageFFTQ_();
+    int32_t log_mel[KWS_NUM_MEL];
+    stageLogMelQ_(exponent, log_mel);
+    stageDctQ_(log_mel, q_row);
+#else
+    (void)pcm;
+    memset(q_row, (int8_t)input_zero_point, KWS_NUM_MFCC);
+#endif
+}
+
+#if AP_HAS_INT8_FRONTEND
+void AudioProcessor::stageWindowQ_(const int16_t* pcm) {
+    const FrontendTables& T = kFrontendTables;
+    for (int i = 0; i < AP_FRAME_SAMPLES; ++i) {
+        fft_q_[i] = (int32_t)pcm[i] * (int32_t)T.window_q15[i];  // Q15
     }
-    float freq_points[KWS_NUM_MEL + 2];
-    for (int i = 0; i < KWS_NUM_MEL + 2; ++i) {
-        freq_points[i] = 700.0f * (expf(mel_points[i] / 1125.0f) - 1.0f);
+    for (int i = AP_FRAME_SAMPLES; i < AP_FFT_SIZE; ++i) {
+        fft_q_[i] = 0;
     }
-    int bin_points[KWS_NUM_MEL + 2];
-    for (int i = 0; i < KWS_NUM_MEL + 2; ++i) {
-        bin_points[i] = (int)((AP_FFT_BINS) * freq_points[i] / (float)KWS_SAMPLE_RATE_HZ);
+}
+
+int AudioProcessor::stageFFTQ_() {
+    return fft_fixed_.forward(fft_q_) - 15;
+}
+
+void AudioProcessor::stageLogMelQ_(int exponent, int32_t* log_mel) const {
+    const FrontendTables& T = kFrontendTables;
+    // Trim components to 19 bits: power < 2^39, times a Q15 weight, summed
+    // over at most AP_FFT_BINS bins stays inside 64 bits.
+    uint32_t bits = 0;
+    for (int i = 0; i < AP_FFT_SIZE; ++i) {
+        bits |= (uint32_t)(fft_q_[i] ^ (fft_q_[i] >> 31));
     }
-    memset(mel_, 0, sizeof(mel_));
+    int shift = 0;
+    while ((bits >> shift) >= (1u << 19)) ++shift;
+    // log2(E) = log2(acc) + 2 * (exponent + shift) - 15 (Q15 weights),
+    // plus the input gain the Q15 window leaves out
+    const int32_t log_offset = (2 * (exponent + shift) - 15) * 65536 + T.gain_log2_q16;
+
     for (int m = 0; m < KWS_NUM_MEL; ++m) {
-        int lower = bin_points[m];
-        int center = bin_points[m + 1];
-        int upper = bin_points[m + 2];
-        if (center > lower) {
-            for (int f = lower; f < center; ++f) {
-                if (m * AP_FFT_BINS + f >= KWS_NUM_MEL * AP_FFT_BINS) {
-                    Serial.printf("ERROR: Mel index out of bounds: m=%d, f=%d\n", m, f);
-                    Serial.flush();
-                    return;
-                }
-                mel_[m * AP_FFT_BINS + f] = (float)(f - lower) / (float)(center - lower);
-            }
-        }
-        if (upper > center) {
-            for (int f = center; f < upper; ++f) {
-                if (m * AP_FFT_BINS + f >= KWS_NUM_MEL * AP_FFT_BINS) {
-                    Serial.printf("ERROR: Mel index out of bounds: m=%d, f=%d\n", m, f);
-                    Serial.flush();
-                    return;
-                }
-                mel_[m * AP_FFT_BINS + f] = (float)(upper - f) / (float)(upper - center);
+        const MelSpan& span = T.mel_spans[m];
+        const uint16_t* w = &T.mel_weights_q15[span.offset];
+        uint64_t acc = 0;
+        for (int j = 0; j < span.len; ++j) {
+            const int k = span.start + j;
+            int32_t re, im;
+            if (k == 0) {
+                re = fft_q_[0]; im = 0;
+            } else if (k == AP_FFT_SIZE / 2) {
+                re = fft_q_[1]; im = 0;
+            } else {
+                re = fft_q_[2 * k]; im = fft_q_[2 * k + 1];
             }
+            re >>= shift;
+            im >>= shift;
+            const uint64_t p = (uint64_t)((int64_t)re * re + (int64_t)im * im);
+            acc += p * w[j];
         }
+        int32_t l = (acc == 0) ? kLogFloorQ16 : log2Q16(acc) + log_offset;
+        log_mel[m] = (l < kLogFloorQ16) ? kLogFloorQ16 : l;
     }
-    Serial.println("DEBUG: buildMel_ done");
-    Serial.flush();
 }
 
-void AudioProcessor::buildDct_() {
-    Serial.println("DEBUG: buildDct_ entered");
-    const float sqrt_2n = sqrtf(2.0f / (float)KWS_NUM_MEL);
-    const float sqrt_1n = sqrtf(1.0f / (float)KWS_NUM_MEL);
-    for (int m = 0; m < KWS_NUM_MFCC; ++m) {
-        for (int k = 0; k < KWS_NUM_MEL; ++k) {
-            if (m * KWS_NUM_MEL + k >= KWS_NUM_MFCC * KWS_NUM_MEL) {
-                Serial.printf("ERROR: DCT index out of bounds: m=%d, k=%d\n", m, k);
-                Serial.flush();
-                return;
-            }
-            float val = cosf((float)M_PI * (float)m * ((float)k + 0.5f) / (float)KWS_NUM_MEL);
-            dct_[m * KWS_NUM_MEL + k] = (m == 0 ? sqrt_1n : sqrt_2n) * val;
+void AudioProcessor::stageDctQ_(const int32_t* log_mel, int8_t* q_row, int64_t* acc_q40) {
+    const FrontendTables& T = kFrontendTables;
+    for (int c = 0; c < KWS_NUM_MFCC; ++c) {
+        const int32_t* a = &T.dct_q24[c * KWS_NUM_MEL];
+        int64_t acc = T.bias_q40[c];
+        for (int m = 0; m < KWS_NUM_MEL; ++m) {
+            acc += (int64_t)a[m] * log_mel[m];
         }
+        if (acc_q40) acc_q40[c] = acc;
+        int32_t q = (int32_t)((acc + ((int64_t)1 << 39)) >> 40);
+        if (q > 127) q = 127;
+        if (q < -128) q = -128;
+        q_row[c] = (int8_t)q;
     }
-    Serial.println("DEBUG: buildDct_ done");
-    Serial.flush();
 }
+#endif
 
 void AudioProcessor::computeMfcc_(const int16_t* pcm, float* mfcc_row) {
-    Serial.println("DEBUG: computeMfcc_ entered");
     if (!pcm || !mfcc_row) {
         Serial.println("ERROR: pcm or mfcc_row is null");
         Serial.flush();
         return;
     }
 
-    float real[AP_FFT_SIZE];
-    float imag[AP_FFT_SIZE];
-    memset(real, 0, sizeof(real));
-    memset(imag, 0, sizeof(imag));
-
-    for (int i = 0; i < AP_FRAME_SAMPLES; ++i) {
-        real[i] = (float)pcm[i] * window_[i];
-        imag[i] = 0.0f;
-    }
-
-    Serial.println("DEBUG: computeMfcc_ FFT start");
-    Serial.printf("DEBUG: Free heap before FFT: %u bytes\n", ESP.getFreeHeap());
-    ArduinoFFT<float> fft(real, imag, AP_FFT_SIZE, (float)KWS_SAMPLE_RATE_HZ);
-    try {
-        fft.compute(FFTDirection::Forward);
-        fft.complexToMagnitude();
-    } catch (...) {
-        Serial.println("ERROR: FFT computation failed");
-        Serial.flush();
-        return;
-    }
-    Serial.println("DEBUG: computeMfcc_ FFT done");
-
-    for (int i = 0; i < AP_FFT_BINS; ++i) {
-        if (i >= AP_FFT_BINS) {
-            Serial.printf("ERROR: Power index out of bounds: i=%d\n", i);
-            Serial.flush();
-            return;
-        }
-        float mag = real[i] * real[i] + imag[i] * imag[i];
-        power_[i] = (mag > 1e20) ? 1e20 : mag;
-    }
+    stageWindow_(pcm);
+    stageFFT_();
+    stagePower_();
+#if FB_PUBLISH_POWER
+    memcpy(bus_.nextPower(), power_, sizeof(power_));
+#endif
 
-    static int debug_count = 0;
-    if (DEBUG_LEVEL >= 2 && debug_count % 10 == 0) {
+    if (TRACE_ON(MFCC_POWER)) {
         float power_sum = 0.0f;
         for (int i = 0; i < AP_FFT_BINS; ++i) {
             power_sum += power_[i];
         }
-        Serial.printf("DEBUG: Power sum=%.4f, first[0-4]=[%.4f %.4f %.4f %.4f %.4f]\n",
-                      power_sum, power_[0], power_[1], power_[2], power_[3], power_[4]);
-        Serial.flush();
+        TRACE(MFCC_POWER, power_sum, power_[0]);
     }
 
     float mel_energies[KWS_NUM_MEL];
-    memset(mel_energies, 0, sizeof(mel_energies));
+    stageMel_(power_, mel_energies);
+    stageLog_(mel_energies);
+#if FB_PUBLISH_LOGMEL
+    memcpy(bus_.nextLogMel(), mel_energies, sizeof(mel_energies));
+#endif
+
+    TRACE(MFCC_MEL, mel_energies[0], mel_energies[1]);
+
+    stageDct_(mel_energies, mfcc_row);
+    TRACE(MFCC_ROW, bus_.seq() + 1, mfcc_row[0]);
+}
+
+void AudioProcessor::stageWindow_(const int16_t* pcm) {
+    dspk::window(pcm, kFrontendTables.window, fft_buf_, AP_FRAME_SAMPLES);
+    for (int i = AP_FRAME_SAMPLES; i < AP_FFT_SIZE; ++i) {
+        fft_buf_[i] = 0.0f;
+    }
+}
+
+void AudioProcessor::stageFFT_() {
+    fft_->forward(fft_buf_, fft_buf_);
+}
+
+void AudioProcessor::stagePower_() {
+    fftPowerPacked(fft_buf_, AP_FFT_SIZE, power_);
+    for (int i = 0; i < AP_FFT_BINS; ++i) {
+        if (power_[i] > 1e20f) power_[i] = 1e20f;
+    }
+}
+
+void AudioProcessor::stageMel_(const float* power, float* mel) {
+    const FrontendTables& T = kFrontendTables;
     for (int m = 0; m < KWS_NUM_MEL; ++m) {
-        float energy = 0.0f;
-        for (int f = 0; f < AP_FFT_BINS; ++f) {
-            energy += power_[f] * mel_[m * AP_FFT_BINS + f];
-        }
-        mel_energies[m] = (energy > 1e-5f) ? logf(energy) : logf(1e-5f);
+        const MelSpan& span = T.mel_spans[m];
+        mel[m] = dspk::dot(&power[span.start], &T.mel_weights[span.offset], span.len);
     }
+}
 
-    if (DEBUG_LEVEL >= 2 && debug_count % 10 == 0) {
-        Serial.printf("DEBUG: Mel energies [0-4]=[%.4f %.4f %.4f %.4f %.4f]\n",
-                      mel_energies[0], mel_energies[1], mel_energies[2], mel_energies[3], mel_energies[4]);
-        Serial.flush();
+void AudioProcessor::stageLog_(float* mel) {
+    for (int m = 0; m < KWS_NUM_MEL; ++m) {
+        mel[m] = (mel[m] > 1e-5f) ? logf(mel[m]) : logf(1e-5f);
     }
+}
 
+// DCT with MFCC_MEAN/MFCC_STD folded in: the row comes out normalized.
+void AudioProcessor::stageDct_(const float* mel, float* row) {
+    const FrontendTables& T = kFrontendTables;
     for (int c = 0; c < KWS_NUM_MFCC; ++c) {
-        float sum = 0.0f;
-        for (int m = 0; m < KWS_NUM_MEL; ++m) {
-            sum += mel_energies[m] * dct_[c * KWS_NUM_MEL + m];
-        }
-        mfcc_row[c] = sum;
+        row[c] = T.bias_norm[c] + dspk::dot(mel, &T.dct_norm[c * KWS_NUM_MEL], KWS_NUM_MEL);
     }
-    Serial.println("DEBUG: computeMfcc_ done");
-    Serial.flush();
-    debug_count++;
 }
 
 
@@ -0,0 +1,102 @@
+#include "FeatureBus.h"
+#include <math.h>
+#include <string.h>
+#include "model_weights.h"  // input_scale / input_zero_point of the int8 model
+
+FeatureBus::FeatureBus() : seq_(0), gen_(0), format_(Format::Float) {
+	reset();
+}
+
+void FeatureBus::reset() {
+	gen_.fetch_add(1, std::memory_order_acq_rel);
+	fence_();
+	memset(mfcc_, 0, sizeof(mfcc_));
+	memset(mfcc_q_, (int8_t)input_zero_point, sizeof(mfcc_q_));	// dequantizes to 0.0
+#if FB_PUBLISH_LOGMEL
+	memset(logmel_, 0, sizeof(logmel_));
+#endif
+#if FB_PUBLISH_POWER
+	memset(power_, 0, sizeof(power_));
+#endif
+	seq_.store(0, std::memory_order_relaxed);
+	gen_.fetch_add(1, std::memory_order_release);
+}
+
+int8_t FeatureBus::quantize(float v) {
+	int32_t q = (int32_t)lrintf(v / input_scale) + input_zero_point;
+	if (q > 127) q = 127;
+	if (q < -128) q = -128;
+	return (int8_t)q;
+}
+
+float FeatureBus::dequantize(int8_t q) {
+	return (float)((int32_t)q - input_zero_point) * input_scale;
+}
+
+void FeatureBus::publish() {
+	const uint32_t seq = seq_.load(std::memory_order_relaxed);
+	const int s = (int)(seq % kRows);
+	fence_();	// the mirror copies overwrite slots too
+	if (format() == Format::Int8) {
+		memcpy(mfcc_q_[s + kRows], mfcc_q_[s], sizeof(mfcc_q_[0]));
+	} else {
+		memcpy(mfcc_[s + kRows], mfcc_[s], sizeof(mfcc_[0]));
+#if FB_PUBLISH_LOGMEL
+		memcpy(logmel_[s + kRows], logmel_[s], sizeof(logmel_[0]));
+#endif
+	}
+	seq_.store(seq + 1, std::memory_order_release);
+}
+
+void FeatureBus::setFormat(Format format) {
+	if (format == this->format()) return;
+	gen_.fetch_add(1, std::memory_order_acq_rel);
+	fence_();
+	for (int r = 0; r < 2 * kRows; ++r) {
+		for (int c = 0; c < KWS_NUM_MFCC; ++c) {
+			if (format == Format::Int8) mfcc_q_[r][c] = quantize(mfcc_[r][c]);
+			else mfcc_[r][c] = dequantize(mfcc_q_[r][c]);
+		}
+	}
+	format_.store(format, std::memory_order_relaxed);
+	gen_.fetch_add(1, std::memory_order_release);
+}
+
+bool FeatureBus::window(FeatureWindow& w, int frames) const {
+	if (frames < 1) frames = 1;
+	if (frames > KWS_FRAMES) frames = KWS_FRAMES;
+	w.gen = gen_.load(std::memory_order_acquire);
+	w.seq = seq_.load(std::memory_order_acquire);
+	w.frames = frames;
+	w.complete = w.seq >= (uint32_t)frames;
+
+	const int start = (int)((w.seq % kRows + kRows - frames) % kRows);
+	const bool q = format() == Format::Int8;
+	w.mfcc = q ? nullptr : mfcc_[start];
+	w.mfcc_q = q ? mfcc_q_[start] : nullptr;
+#if FB_PUBLISH_LOGMEL
+	w.logmel = q ? nullptr : logmel_[start];
+#else
+	w.logmel = nullptr;
+#endif
+#if FB_PUBLISH_POWER
+	w.power = (q || w.seq == 0) ? nullptr : power_[(w.seq - 1) % kPowerRows];
+#else
+	w.power = nullptr;
+#endif
+	return w.complete;
+}
+
+bool FeatureBus::valid(const FeatureWindow& w) const {
+	// Order the consumer's reads of the rows before the re-check.
+	std::atomic_thread_fence(std::memory_order_acquire);
+	if (w.gen & 1) return false;
+	if (gen_.load(std::memory_order_relaxed) != w.gen) return false;
+	// The producer writes row seq() next; it lands on the window's oldest
+	// slot once it is kRows - frames rows past the window.
+	uint32_t limit = (uint32_t)(kRows - w.frames);
+#if FB_PUBLISH_POWER
+	if (limit > (uint32_t)(kPowerRows - 1)) limit = kPowerRows - 1;
+#endif
+	return seq_.load(std::memory_order_relaxed) - w.seq < limit;
+}
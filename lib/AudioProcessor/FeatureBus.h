@@ -0,0 +1,95 @@
+#pragma once
+#include <stdint.h>
+#include <atomic>
+#include "frontend_params.h"
+
+// Rows a consumer may fall behind the producer before its window is
+// overwritten (one row per 10 ms hop).
+#ifndef FB_SLACK_ROWS
+#define FB_SLACK_ROWS 16
+#endif
+// Optional channels next to the MFCC rows (float frontend only).
+#ifndef FB_PUBLISH_LOGMEL
+#define FB_PUBLISH_LOGMEL 0
+#endif
+#ifndef FB_PUBLISH_POWER
+#define FB_PUBLISH_POWER 0
+#endif
+
+// A consumer's view of the newest `frames` rows, oldest first. Pointers go
+// straight into the bus storage; check FeatureBus::valid() after using them.
+struct FeatureWindow {
+	const float*	mfcc;		// frames x KWS_NUM_MFCC, nullptr when rows are int8
+	const int8_t*	mfcc_q;		// frames x KWS_NUM_MFCC, nullptr when rows are float
+	const float*	logmel;		// frames x KWS_NUM_MEL, nullptr unless published
+	const float*	power;		// AP_FFT_BINS of the newest row, nullptr unless published
+	uint32_t		seq;		// rows published when taken; newest row is seq - 1
+	uint32_t		gen;
+	int				frames;
+	bool			complete;	// false while fewer than `frames` rows exist (missing rows read as 0)
+};
+
+// Single-producer, multi-consumer store of frontend output. AudioProcessor
+// publishes one row per hop; any number of models read windows from it, so
+// the frontend runs once no matter how many models consume it.
+//
+// Rows are kept in a mirrored ring (row r at slot r % kRows and r % kRows +
+// kRows), so every window is one contiguous span and nothing is copied.
+// Consistency is seqlock-style: the producer only ever writes the slot of
+// the row after seq(), so a window stays intact until the producer has
+// moved kRows - frames rows past it, and valid() checks exactly that.
+class FeatureBus {
+public:
+	enum class Format : uint8_t { Float, Int8 };
+	static const int kRows = KWS_FRAMES + FB_SLACK_ROWS;
+
+	FeatureBus();
+	void reset();
+
+	// Producer: fill the next row in place, then publish(). Each next*()
+	// fences first, so a consumer that sees any of the new row's bytes also
+	// sees the seq() that makes valid() reject its window.
+	float*	nextMfcc() { fence_(); return mfcc_[slot_()]; }
+	int8_t*	nextMfccQ() { fence_(); return mfcc_q_[slot_()]; }
+#if FB_PUBLISH_LOGMEL
+	float*	nextLogMel() { fence_(); return logmel_[slot_()]; }
+#endif
+#if FB_PUBLISH_POWER
+	float*	nextPower() { fence_(); return power_[seq_.load(std::memory_order_relaxed) % kPowerRows]; }
+#endif
+	void	publish();
+
+	// Which MFCC array the rows live in. Switching converts the stored rows
+	// and invalidates every outstanding window.
+	void	setFormat(Format format);
+	Format	format() const { return format_.load(std::memory_order_relaxed); }
+
+	// Int8 rows use the int8 model's input quantization.
+	static int8_t	quantize(float v);
+	static float	dequantize(int8_t q);
+
+	// Consumers. window() returns w.complete.
+	bool		window(FeatureWindow& w, int frames = KWS_FRAMES) const;
+	bool		valid(const FeatureWindow& w) const;
+	uint32_t	seq() const { return seq_.load(std::memory_order_acquire); }
+
+private:
+	static const int kPowerRows = FB_SLACK_ROWS + 1;
+
+	float	mfcc_[2 * kRows][KWS_NUM_MFCC];
+	int8_t	mfcc_q_[2 * kRows][KWS_NUM_MFCC];
+#if FB_PUBLISH_LOGMEL
+	float	logmel_[2 * kRows][KWS_NUM_MEL];
+#endif
+#if FB_PUBLISH_POWER
+	float	power_[kPowerRows][AP_FFT_BINS];
+#endif
+	std::atomic<uint32_t>	seq_;
+	std::atomic<uint32_t>	gen_;		// odd while setFormat() or reset() rewrites rows
+	std::atomic<Format>		format_;
+
+	int		slot_() const { return (int)(seq_.load(std::memory_order_relaxed) % kRows); }
+	// Pairs with the acquire fence in valid(): keeps row writes after the
+	// seq_ / gen_ stores that precede them.
+	static void	fence_() { std::atomic_thread_fence(std::memory_order_release); }
+};
@@ -0,0 +1,117 @@
+#pragma once
+#include <stdint.h>
+#include "frontend_params.h"
+#include "mfcc_norm.h"
+#include "model_weights.h"  // input_scale / input_zero_point of the int8 model
+#include "DSPMath.h"
+
+// MFCC frontend tables, generated at compile time from frontend_params.h,
+// mfcc_norm.h and the int8 model's input quantization. They live in flash as
+// const data; nothing is built at boot.
+//
+// AP_INPUT_GAIN is folded into the float window. The Q15 window stays at
+// full scale for precision; the int8 path adds the gain's log2 power instead.
+//
+// Normalization is folded into the DCT:
+//   mfcc[c] = bias[c] + sum_m dct_norm[c][m] * ln(E_m)
+// with dct_norm = dct / MFCC_STD and bias = -MFCC_MEAN / MFCC_STD. The int8
+// variant additionally folds ln2 (the fixed path works in log2) and the
+// input_scale/input_zero_point quantization.
+
+// Sparse mel filterbank: filter m covers power[start, start + len) with
+// weights mel_weights[offset, offset + len). Adjacent triangles overlap, so
+// each bin appears in at most two filters.
+struct MelSpan {
+	uint16_t	start = 0;
+	uint16_t	len = 0;
+	uint16_t	offset = 0;
+};
+
+static const int kMelMaxWeights = 2 * AP_FFT_BINS;
+
+struct FrontendTables {
+	float		window[AP_FRAME_SAMPLES];			// Hann * AP_INPUT_GAIN
+	int16_t		window_q15[AP_FRAME_SAMPLES];		// Hann
+	int32_t		gain_log2_q16;						// log2(AP_INPUT_GAIN^2), Q16
+	MelSpan		mel_spans[KWS_NUM_MEL];
+	float		mel_weights[kMelMaxWeights];
+	uint16_t	mel_weights_q15[kMelMaxWeights];
+	int			mel_num_weights;
+	float		dct_norm[KWS_NUM_MFCC * KWS_NUM_MEL];	// dct / std
+	float		bias_norm[KWS_NUM_MFCC];				// -mean / std
+	int32_t		dct_q24[KWS_NUM_MFCC * KWS_NUM_MEL];	// dct * ln2 / (std * input_scale)
+	int64_t		bias_q40[KWS_NUM_MFCC];					// zero_point - mean / (std * input_scale)
+
+	constexpr FrontendTables()
+	    : window(), window_q15(), gain_log2_q16(0), mel_spans(), mel_weights(), mel_weights_q15(),
+	      mel_num_weights(0), dct_norm(), bias_norm(), dct_q24(), bias_q40() {
+		buildWindow_();
+		buildMel_();
+		buildDct_();
+	}
+
+private:
+	constexpr void buildWindow_() {
+		for (int i = 0; i < AP_FRAME_SAMPLES; ++i) {
+			const double w = 0.5 * (1.0 - dspmath::cos(2.0 * dspmath::kPi * (double)i / (double)(AP_FRAME_SAMPLES - 1)));
+			window[i] = (float)(w * AP_INPUT_GAIN);
+			const long long q = dspmath::round(w * 32768.0);
+			window_q15[i] = (int16_t)(q > 32767 ? 32767 : q);
+		}
+		gain_log2_q16 = (int32_t)dspmath::round(2.0 * dspmath::log2(AP_INPUT_GAIN) * 65536.0);
+	}
+
+	constexpr void buildMel_() {
+		const double f_min = 20.0;
+		const double f_max = (double)KWS_SAMPLE_RATE_HZ / 2.0;
+		const double mel_min = 1125.0 * dspmath::log(1.0 + f_min / 700.0);
+		const double mel_max = 1125.0 * dspmath::log(1.0 + f_max / 700.0);
+		int bin_points[KWS_NUM_MEL + 2] = {};
+		for (int i = 0; i < KWS_NUM_MEL + 2; ++i) {
+			const double mel = mel_min + (double)i * (mel_max - mel_min) / (double)(KWS_NUM_MEL + 1);
+			const double freq = 700.0 * (dspmath::exp(mel / 1125.0) - 1.0);
+			bin_points[i] = (int)((double)AP_FFT_BINS * freq / (double)KWS_SAMPLE_RATE_HZ);
+		}
+		for (int m = 0; m < KWS_NUM_MEL; ++m) {
+			const int lower = bin_points[m];
+			const int center = bin_points[m + 1];
+			const int upper = bin_points[m + 2];
+			MelSpan& span = mel_spans[m];
+			span.offset = (uint16_t)mel_num_weights;
+			for (int f = lower; f < upper && f < AP_FFT_BINS; ++f) {
+				const double w = (f < center) ? (double)(f - lower) / (double)(center - lower)
+				                              : (double)(upper - f) / (double)(upper - center);
+				if (w <= 0.0) {
+					if (span.len == 0) continue;  // trim the zero at the lower edge
+					break;
+				}
+				if (span.len == 0) span.start = (uint16_t)f;
+				mel_weights[mel_num_weights] = (float)w;
+				mel_weights_q15[mel_num_weights] = (uint16_t)dspmath::round(w * 32768.0);
+				++mel_num_weights;
+				span.len++;
+			}
+		}
+	}
+
+	constexpr void buildDct_() {
+		const double sqrt_2n = dspmath::sqrt(2.0 / (double)KWS_NUM_MEL);
+		const double sqrt_1n = dspmath::sqrt(1.0 / (double)KWS_NUM_MEL);
+		for (int c = 0; c < KWS_NUM_MFCC; ++c) {
+			const double inv_std = 1.0 / (double)MFCC_STD[c];
+			const double inv_q = inv_std / (double)input_scale;
+			for (int m = 0; m < KWS_NUM_MEL; ++m) {
+				const double dct = (c == 0 ? sqrt_1n : sqrt_2n) *
+				                   dspmath::cos(dspmath::kPi * (double)c * ((double)m + 0.5) / (double)KWS_NUM_MEL);
+				dct_norm[c * KWS_NUM_MEL + m] = (float)(dct * inv_std);
+				dct_q24[c * KWS_NUM_MEL + m] = (int32_t)dspmath::round(dct * dspmath::kLn2 * inv_q * 16777216.0);
+			}
+			bias_norm[c] = (float)(-(double)MFCC_MEAN[c] * inv_std);
+			bias_q40[c] = (int64_t)dspmath::round(((double)input_zero_point - (double)MFCC_MEAN[c] * inv_q) * 1099511627776.0);
+		}
+	}
+};
+
+// inline: one copy for the program, not one per translation unit.
+inline constexpr FrontendTables kFrontendTables = FrontendTables();
+static_assert(kFrontendTables.mel_num_weights <= kMelMaxWeights, "mel weight pool too small");
@@ -0,0 +1,237 @@
+#include "DSPKernels.h"
+
+#if DSPK_HAVE_SSE || DSPK_HAVE_AVX2
+#include <immintrin.h>
+#endif
+#if DSPK_HAVE_ESP
+#include "dsps_dotprod.h"
+#endif
+
+namespace dspk {
+
+// ---------- scalar reference ----------
+namespace scalar {
+
+void window(const int16_t* pcm, const float* w, float* out, int n) {
+	for (int i = 0; i < n; ++i) out[i] = (float)pcm[i] * w[i];
+}
+
+void power(const float* re_im, float* power, int n) {
+	for (int k = 0; k < n; ++k) {
+		const float re = re_im[2 * k];
+		const float im = re_im[2 * k + 1];
+		power[k] = re * re + im * im;
+	}
+}
+
+float dot(const float* a, const float* b, int n) {
+	float sum = 0.0f;
+	for (int i = 0; i < n; ++i) sum += a[i] * b[i];
+	return sum;
+}
+
+void pcm24(const int32_t* raw, int16_t* out, int n, int shift) {
+	for (int i = 0; i < n; ++i) {
+		int32_t s = raw[i] >> shift;
+		if (s > 32767) s = 32767;
+		if (s < -32768) s = -32768;
+		out[i] = (int16_t)s;
+	}
+}
+
+}  // namespace scalar
+
+// ---------- SSE2 (4 lanes) ----------
+#if DSPK_HAVE_SSE
+namespace sse {
+
+void window(const int16_t* pcm, const float* w, float* out, int n) {
+	int i = 0;
+	for (; i + 8 <= n; i += 8) {
+		const __m128i x = _mm_loadu_si128(reinterpret_cast<const __m128i*>(pcm + i));
+		// Sign-extend via unpack-with-self and an arithmetic shift (no SSE4.1).
+		const __m128i lo = _mm_srai_epi32(_mm_unpacklo_epi16(x, x), 16);
+		const __m128i hi = _mm_srai_epi32(_mm_unpackhi_epi16(x, x), 16);
+		_mm_storeu_ps(out + i, _mm_mul_ps(_mm_cvtepi32_ps(lo), _mm_loadu_ps(w + i)));
+		_mm_storeu_ps(out + i + 4, _mm_mul_ps(_mm_cvtepi32_ps(hi), _mm_loadu_ps(w + i + 4)));
+	}
+	scalar::window(pcm + i, w + i, out + i, n - i);
+}
+
+void power(const float* re_im, float* power, int n) {
+	int k = 0;
+	for (; k + 4 <= n; k += 4) {
+		const __m128 a = _mm_loadu_ps(re_im + 2 * k);		// r0 i0 r1 i1
+		const __m128 b = _mm_loadu_ps(re_im + 2 * k + 4);	// r2 i2 r3 i3
+		const __m128 a2 = _mm_mul_ps(a, a);
+		const __m128 b2 = _mm_mul_ps(b, b);
+		const __m128 re2 = _mm_shuffle_ps(a2, b2, _MM_SHUFFLE(2, 0, 2, 0));
+		const __m128 im2 = _mm_shuffle_ps(a2, b2, _MM_SHUFFLE(3, 1, 3, 1));
+		_mm_storeu_ps(power + k, _mm_add_ps(re2, im2));
+	}
+	scalar::power(re_im + 2 * k, power + k, n - k);
+}
+
+float dot(const float* a, const float* b, int n) {
+	__m128 acc0 = _mm_setzero_ps();
+	__m128 acc1 = _mm_setzero_ps();
+	int i = 0;
+	for (; i + 8 <= n; i += 8) {
+		acc0 = _mm_add_ps(acc0, _mm_mul_ps(_mm_loadu_ps(a + i), _mm_loadu_ps(b + i)));
+		acc1 = _mm_add_ps(acc1, _mm_mul_ps(_mm_loadu_ps(a + i + 4), _mm_loadu_ps(b + i + 4)));
+	}
+	__m128 acc = _mm_add_ps(acc0, acc1);
+	acc = _mm_add_ps(acc, _mm_movehl_ps(acc, acc));
+	acc = _mm_add_ss(acc, _mm_shuffle_ps(acc, acc, 1));
+	return _mm_cvtss_f32(acc) + scalar::dot(a + i, b + i, n - i);
+}
+
+// packs_epi32 saturates, so shift + clamp is two instructions per 4 lanes.
+void pcm24(const int32_t* raw, int16_t* out, int n, int shift) {
+	const __m128i count = _mm_cvtsi32_si128(shift);
+	int i = 0;
+	for (; i + 8 <= n; i += 8) {
+		const __m128i lo = _mm_sra_epi32(_mm_loadu_si128(reinterpret_cast<const __m128i*>(raw + i)), count);
+		const __m128i hi = _mm_sra_epi32(_mm_loadu_si128(reinterpret_cast<const __m128i*>(raw + i + 4)), count);
+		_mm_storeu_si128(reinterpret_cast<__m128i*>(out + i), _mm_packs_epi32(lo, hi));
+	}
+	scalar::pcm24(raw + i, out + i, n - i, shift);
+}
+
+}  // namespace sse
+#endif
+
+// ---------- AVX2 + FMA (8 lanes) ----------
+#if DSPK_HAVE_AVX2
+namespace avx2 {
+
+void window(const int16_t* pcm, const float* w, float* out, int n) {
+	int i = 0;
+	for (; i + 8 <= n; i += 8) {
+		const __m256i x = _mm256_cvtepi16_epi32(_mm_loadu_si128(reinterpret_cast<const __m128i*>(pcm + i)));
+		_mm256_storeu_ps(out + i, _mm256_mul_ps(_mm256_cvtepi32_ps(x), _mm256_loadu_ps(w + i)));
+	}
+	scalar::window(pcm + i, w + i, out + i, n - i);
+}
+
+void power(const float* re_im, float* power, int n) {
+	int k = 0;
+	for (; k + 8 <= n; k += 8) {
+		const __m256 a = _mm256_loadu_ps(re_im + 2 * k);
+		const __m256 b = _mm256_loadu_ps(re_im + 2 * k + 8);
+		const __m256 a2 = _mm256_mul_ps(a, a);
+		const __m256 b2 = _mm256_mul_ps(b, b);
+		// In-lane shuffles leave the bins as (0 1 4 5 | 2 3 6 7); fix the order after the add.
+		const __m256 re2 = _mm256_shuffle_ps(a2, b2, _MM_SHUFFLE(2, 0, 2, 0));
+		const __m256 im2 = _mm256_shuffle_ps(a2, b2, _MM_SHUFFLE(3, 1, 3, 1));
+		const __m256d sum = _mm256_castps_pd(_mm256_add_ps(re2, im2));
+		_mm256_storeu_ps(power + k, _mm256_castpd_ps(_mm256_permute4x64_pd(sum, _MM_SHUFFLE(3, 1, 2, 0))));
+	}
+	sse::power(re_im + 2 * k, power + k, n - k);
+}
+
+float dot(const float* a, const float* b, int n) {
+	__m256 acc0 = _mm256_setzero_ps();
+	__m256 acc1 = _mm256_setzero_ps();
+	int i = 0;
+	for (; i + 16 <= n; i += 16) {
+		acc0 = _mm256_fmadd_ps(_mm256_loadu_ps(a + i), _mm256_loadu_ps(b + i), acc0);
+		acc1 = _mm256_fmadd_ps(_mm256_loadu_ps(a + i + 8), _mm256_loadu_ps(b + i + 8), acc1);
+	}
+	const __m256 acc = _mm256_add_ps(acc0, acc1);
+	__m128 s = _mm_add_ps(_mm256_castps256_ps128(acc), _mm256_extractf128_ps(acc, 1));
+	s = _mm_add_ps(s, _mm_movehl_ps(s, s));
+	s = _mm_add_ss(s, _mm_shuffle_ps(s, s, 1));
+	return _mm_cvtss_f32(s) + sse::dot(a + i, b + i, n - i);
+}
+
+void pcm24(const int32_t* raw, int16_t* out, int n, int shift) {
+	const __m128i count = _mm_cvtsi32_si128(shift);
+	int i = 0;
+	for (; i + 16 <= n; i += 16) {
+		const __m256i lo = _mm256_sra_epi32(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(raw + i)), count);
+		const __m256i hi = _mm256_sra_epi32(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(raw + i + 8)), count);
+		// packs works per 128-bit lane: (lo0 hi0 | lo1 hi1) -> (lo0 lo1 | hi0 hi1).
+		const __m256i packed = _mm256_packs_epi32(lo, hi);
+		_mm256_storeu_si256(reinterpret_cast<__m256i*>(out + i), _mm256_permute4x64_epi64(packed, _MM_SHUFFLE(3, 1, 2, 0)));
+	}
+	sse::pcm24(raw + i, out + i, n - i, shift);
+}
+
+}  // namespace avx2
+#endif
+
+// ---------- ESP32-S3 / esp-dsp ----------
+#if DSPK_HAVE_ESP
+namespace esp {
+
+// Unrolled so the compiler can keep the FPU pipeline busy; there is no
+// float SIMD on the S3 to do better.
+void window(const int16_t* pcm, const float* w, float* out, int n) {
+	int i = 0;
+	for (; i + 4 <= n; i += 4) {
+		out[i]     = (float)pcm[i]     * w[i];
+		out[i + 1] = (float)pcm[i + 1] * w[i + 1];
+		out[i + 2] = (float)pcm[i + 2] * w[i + 2];
+		out[i + 3] = (float)pcm[i + 3] * w[i + 3];
+	}
+	scalar::window(pcm + i, w + i, out + i, n - i);
+}
+
+void power(const float* re_im, float* power, int n) {
+	int k = 0;
+	for (; k + 2 <= n; k += 2) {
+		const float r0 = re_im[2 * k], i0 = re_im[2 * k + 1];
+		const float r1 = re_im[2 * k + 2], i1 = re_im[2 * k + 3];
+		power[k]     = r0 * r0 + i0 * i0;
+		power[k + 1] = r1 * r1 + i1 * i1;
+	}
+	scalar::power(re_im + 2 * k, power + k, n - k);
+}
+
+// Short spans (edge mel filters) are cheaper inline than through the call.
+float dot(const float* a, const float* b, int n) {
+	if (n < 8) return scalar::dot(a, b, n);
+	float sum = 0.0f;
+	dsps_dotprod_f32(a, b, &sum, n);
+	return sum;
+}
+
+// Not vectorized: plain C unrolled by four with branch-free clamps, so a
+// DMA block converts without a taken branch. The PIE unit could narrow
+// with saturation, but esp-dsp has no kernel for it and this is not
+// hand-written PIE assembly.
+static inline int16_t sat16_(int32_t s) {
+	s = s > 32767 ? 32767 : s;
+	return (int16_t)(s < -32768 ? -32768 : s);
+}
+
+void pcm24(const int32_t* raw, int16_t* out, int n, int shift) {
+	int i = 0;
+	for (; i + 4 <= n; i += 4) {
+		out[i]     = sat16_(raw[i] >> shift);
+		out[i + 1] = sat16_(raw[i + 1] >> shift);
+		out[i + 2] = sat16_(raw[i + 2] >> shift);
+		out[i + 3] = sat16_(raw[i + 3] >> shift);
+	}
+	scalar::pcm24(raw + i, out + i, n - i, shift);
+}
+
+}  // namespace esp
+#endif
+
+const Variant kVariants[] = {
+	{ "scalar", scalar::window, scalar::power, scalar::dot, scalar::pcm24 },
+#if DSPK_HAVE_ESP
+	{ "esp", esp::window, esp::power, esp::dot, esp::pcm24 },
+#endif
+#if DSPK_HAVE_SSE
+	{ "sse", sse::window, sse::power, sse::dot, sse::pcm24 },
+#endif
+#if DSPK_HAVE_AVX2
+	{ "avx2", avx2::window, avx2::power, avx2::dot, avx2::pcm24 },
+#endif
+};
+const int kNumVariants = sizeof(kVariants) / sizeof(kVariants[0]);
+
+}  // namespace dspk
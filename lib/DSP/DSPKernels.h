@@ -0,0 +1,85 @@
+#pragma once
+#include <stdint.h>
+
+// Inner-loop kernels of the float MFCC frontend and the capture path, each with a portable scalar
+// reference and faster per-target variants. The variant is picked at compile time:
+//   avx2   host, -mavx2 -mfma
+//   sse    host, any x86-64 (SSE2 is baseline)
+//   esp    ESP32-S3 with esp-dsp: assembly dot product; window, power and
+//          pcm24 are unrolled scalar C, not SIMD (the S3 PIE vector unit is
+//          integer-only, and nothing here is written for it)
+//   scalar everything else, or -DDSP_KERNELS_SCALAR
+// Every compiled-in variant is also listed in dspk::kVariants so host code can
+// check each one against dspk::scalar.
+
+#if !defined(DSP_KERNELS_SCALAR) && defined(__AVX2__) && defined(__FMA__)
+#define DSPK_HAVE_AVX2 1
+#endif
+#if !defined(DSP_KERNELS_SCALAR) && (defined(__SSE2__) || defined(_M_X64))
+#define DSPK_HAVE_SSE 1
+#endif
+#if !defined(DSP_KERNELS_SCALAR) && defined(ESP_PLATFORM) && __has_include("dsps_dotprod.h")
+#define DSPK_HAVE_ESP 1
+#endif
+
+namespace dspk {
+
+// out[i] = pcm[i] * window[i]
+typedef void (*WindowFn)(const int16_t* pcm, const float* window, float* out, int n);
+// power[k] = re[k]^2 + im[k]^2 for n interleaved (re, im) pairs
+typedef void (*PowerFn)(const float* re_im, float* power, int n);
+// sum a[i] * b[i]
+typedef float (*DotFn)(const float* a, const float* b, int n);
+// out[i] = saturate_int16(raw[i] >> shift): 24-in-32 I2S samples to PCM
+typedef void (*Pcm24Fn)(const int32_t* raw, int16_t* out, int n, int shift);
+
+struct Variant {
+	const char*	name;
+	WindowFn	window;
+	PowerFn		power;
+	DotFn		dot;
+	Pcm24Fn		pcm24;
+};
+
+#define DSPK_DECLARE_VARIANT(ns)                                                \
+	namespace ns {                                                              \
+	void window(const int16_t* pcm, const float* window, float* out, int n);    \
+	void power(const float* re_im, float* power, int n);                        \
+	float dot(const float* a, const float* b, int n);                           \
+	void pcm24(const int32_t* raw, int16_t* out, int n, int shift);             \
+	}
+
+DSPK_DECLARE_VARIANT(scalar)
+#if DSPK_HAVE_SSE
+DSPK_DECLARE_VARIANT(sse)
+#endif
+#if DSPK_HAVE_AVX2
+DSPK_DECLARE_VARIANT(avx2)
+#endif
+#if DSPK_HAVE_ESP
+DSPK_DECLARE_VARIANT(esp)
+#endif
+
+#undef DSPK_DECLARE_VARIANT
+
+#if DSPK_HAVE_AVX2
+namespace active = avx2;
+#elif DSPK_HAVE_SSE
+namespace active = sse;
+#elif DSPK_HAVE_ESP
+namespace active = esp;
+#else
+namespace active = scalar;
+#endif
+
+extern const Variant kVariants[];	// scalar first, selected variant last
+extern const int kNumVariants;
+
+inline const char* variantName() { return kVariants[kNumVariants - 1].name; }
+
+inline void window(const int16_t* pcm, const float* w, float* out, int n) { active::window(pcm, w, out, n); }
+inline void power(const float* re_im, float* power, int n) { active::power(re_im, power, n); }
+inline float dot(const float* a, const float* b, int n) { return active::dot(a, b, n); }
+inline void pcm24(const int32_t* raw, int16_t* out, int n, int shift) { active::pcm24(raw, out, n, shift); }
+
+}  // namespace dspk
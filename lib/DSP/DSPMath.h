@@ -0,0 +1,78 @@
+#pragma once
+// Constexpr math used to generate DSP tables at compile time.
+// Evaluated in double precision by the compiler; results land in flash as
+// const data, so nothing here runs on the device.
+
+namespace dspmath {
+
+constexpr double kPi = 3.14159265358979323846;
+
+constexpr double reducePi(double x) {
+	while (x > kPi) x -= 2.0 * kPi;
+	while (x < -kPi) x += 2.0 * kPi;
+	return x;
+}
+
+constexpr double sin(double x) {
+	x = reducePi(x);
+	double term = x, sum = x;
+	for (int n = 1; n < 20; ++n) {
+		term *= -x * x / (double)((2 * n) * (2 * n + 1));
+		sum += term;
+	}
+	return sum;
+}
+
+constexpr double cos(double x) {
+	return dspmath::sin(x + kPi / 2.0);
+}
+
+constexpr double kLn2 = 0.69314718055994530942;
+
+// Natural log for x > 0: scale into [1, 2), then 2*atanh((m-1)/(m+1)).
+constexpr double log(double x) {
+	int e = 0;
+	while (x >= 2.0) { x *= 0.5; ++e; }
+	while (x < 1.0) { x *= 2.0; --e; }
+	const double y = (x - 1.0) / (x + 1.0);
+	const double y2 = y * y;
+	double term = y, sum = 0.0;
+	for (int n = 0; n < 40; ++n) {
+		sum += term / (double)(2 * n + 1);
+		term *= y2;
+	}
+	return 2.0 * sum + (double)e * kLn2;
+}
+
+constexpr double log2(double x) {
+	return dspmath::log(x) / kLn2;
+}
+
+// exp(x) = 2^k * exp(r), |r| <= ln2 / 2.
+constexpr double exp(double x) {
+	int k = 0;
+	while (x > 0.5 * kLn2) { x -= kLn2; ++k; }
+	while (x < -0.5 * kLn2) { x += kLn2; --k; }
+	double term = 1.0, sum = 1.0;
+	for (int n = 1; n < 25; ++n) {
+		term *= x / (double)n;
+		sum += term;
+	}
+	for (; k > 0; --k) sum *= 2.0;
+	for (; k < 0; ++k) sum *= 0.5;
+	return sum;
+}
+
+constexpr double sqrt(double x) {
+	if (x <= 0.0) return 0.0;
+	double r = x > 1.0 ? x : 1.0;
+	for (int i = 0; i < 64; ++i) r = 0.5 * (r + x / r);
+	return r;
+}
+
+// Round half away from zero, usable in constant expressions.
+constexpr long long round(double x) {
+	return (long long)(x < 0.0 ? x - 0.5 : x + 0.5);
+}
+
+}  // namespace dspmath
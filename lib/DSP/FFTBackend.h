@@ -0,0 +1,23 @@
+#pragma once
+#include <stdint.h>
+#include "DSPKernels.h"
+
+// Packed real-FFT output layout shared by every backend (N = size()):
+//   out[0]      = Re X[0]
+//   out[1]      = Re X[N/2]
+//   out[2k]     = Re X[k]   for 1 <= k < N/2
+//   out[2k + 1] = Im X[k]
+// Backends may be called with out == in.
+class FFTBackend {
+public:
+	virtual ~FFTBackend() {}
+	virtual int size() const = 0;
+	virtual void forward(const float* in, float* out) = 0;
+};
+
+// |X[k]|^2 for k = 0..N/2 from a packed spectrum (N/2 + 1 values).
+inline void fftPowerPacked(const float* packed, int n, float* power) {
+	power[0] = packed[0] * packed[0];
+	power[n / 2] = packed[1] * packed[1];
+	dspk::power(&packed[2], &power[1], n / 2 - 1);
+}
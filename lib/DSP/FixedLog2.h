@@ -0,0 +1,30 @@
+#pragma once
+#include <stdint.h>
+#include "DSPMath.h"
+
+// log2 of an unsigned 64-bit integer in Q16, from the MSB position plus a
+// 256-entry mantissa table. Max error is log2(1 + 1/256) ~= 0.0056.
+
+namespace fixedlog2_detail {
+
+struct Table {
+	uint16_t v[256];	// log2(1 + i/256) in Q16
+	constexpr Table() : v() {
+		for (int i = 0; i < 256; ++i) {
+			v[i] = (uint16_t)(dspmath::log2(1.0 + (double)i / 256.0) * 65536.0 + 0.5);
+		}
+	}
+};
+
+constexpr Table kTable = Table();
+
+}  // namespace fixedlog2_detail
+
+// Returns INT32_MIN for v == 0.
+inline int32_t log2Q16(uint64_t v) {
+	if (v == 0) return INT32_MIN;
+	const int n = 63 - __builtin_clzll(v);
+	const uint32_t idx = (n >= 8) ? (uint32_t)(v >> (n - 8)) & 0xFF
+	                              : (uint32_t)(v << (8 - n)) & 0xFF;
+	return ((int32_t)n << 16) + (int32_t)fixedlog2_detail::kTable.v[idx];
+}
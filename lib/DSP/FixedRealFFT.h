@@ -0,0 +1,159 @@
+#pragma once
+#include <stdint.h>
+#include "DSPMath.h"
+
+// Block-floating-point packed real FFT on int32 data with Q15 twiddles.
+// Same structure and output layout as RealFFT (N/2-point complex FFT plus a
+// split step, see FFTBackend.h), but radix-2 only, so N must be a power of two.
+//
+// The input block is normalized to use the available headroom, and every
+// stage shifts the whole block right when the next one could overflow. The
+// shared exponent is returned: true spectrum = out * 2^exponent.
+
+namespace fixedfft_detail {
+
+constexpr int16_t q15(double v) {
+	const double s = v * 32768.0;
+	return (int16_t)(s >= 32767.0 ? 32767 : (s <= -32768.0 ? -32768 : (s < 0 ? s - 0.5 : s + 0.5)));
+}
+
+template <int N>
+struct Tables {
+	static constexpr int M = N / 2;
+	int16_t tw_r[M / 2];	// exp(-2*pi*i*k/M)
+	int16_t tw_i[M / 2];
+	int16_t st_r[M / 2];	// exp(-i*pi*((k+1)/M + 1/2)), split step
+	int16_t st_i[M / 2];
+	uint16_t rev[M];		// bit-reversal permutation
+
+	constexpr Tables() : tw_r(), tw_i(), st_r(), st_i(), rev() {
+		for (int k = 0; k < M / 2; ++k) {
+			const double ph = -2.0 * dspmath::kPi * (double)k / (double)M;
+			tw_r[k] = q15(dspmath::cos(ph));
+			tw_i[k] = q15(dspmath::sin(ph));
+			const double ps = -dspmath::kPi * ((double)(k + 1) / (double)M + 0.5);
+			st_r[k] = q15(dspmath::cos(ps));
+			st_i[k] = q15(dspmath::sin(ps));
+		}
+		int bits = 0;
+		while ((1 << bits) < M) ++bits;
+		for (int k = 0; k < M; ++k) {
+			int r = 0;
+			for (int b = 0; b < bits; ++b) {
+				if (k & (1 << b)) r |= 1 << (bits - 1 - b);
+			}
+			rev[k] = (uint16_t)r;
+		}
+	}
+};
+
+// Magnitude bound used for headroom checks: OR of |x| over the block.
+inline uint32_t absBits(int32_t x) {
+	return (uint32_t)(x ^ (x >> 31));
+}
+
+}  // namespace fixedfft_detail
+
+template <int N>
+class FixedRealFFT {
+	static_assert(N >= 4 && (N & (N - 1)) == 0, "FixedRealFFT size must be a power of two");
+
+public:
+	int size() const { return N; }
+
+	// In place: buf holds N samples on entry, packed spectrum on return.
+	int forward(int32_t* buf) const {
+		using fixedfft_detail::absBits;
+		const auto& T = kTables;
+
+		uint32_t bits = 0;
+		for (int i = 0; i < N; ++i) bits |= absBits(buf[i]);
+		if (bits == 0) return 0;
+
+		// Normalize so the block MSB sits at bit 28.
+		int exponent = 0;
+		const int msb = 31 - __builtin_clz(bits);
+		if (msb < kNormBit) {
+			const int sh = kNormBit - msb;
+			for (int i = 0; i < N; ++i) buf[i] = (int32_t)((uint32_t)buf[i] << sh);
+			exponent -= sh;
+		} else if (msb > kNormBit) {
+			const int sh = msb - kNormBit;
+			for (int i = 0; i < N; ++i) buf[i] >>= sh;
+			exponent += sh;
+		}
+
+		// Even/odd samples as an M-point complex signal, bit-reversed in place.
+		for (int k = 0; k < M; ++k) {
+			const int r = T.rev[k];
+			if (r > k) {
+				int32_t t0 = buf[2 * k], t1 = buf[2 * k + 1];
+				buf[2 * k] = buf[2 * r];
+				buf[2 * k + 1] = buf[2 * r + 1];
+				buf[2 * r] = t0;
+				buf[2 * r + 1] = t1;
+			}
+		}
+
+		bits = 1u << kNormBit;
+		for (int len = 2; len <= M; len <<= 1) {
+			exponent += headroom_(buf, bits);
+			bits = 0;
+			const int half = len >> 1;
+			const int step = M / len;
+			for (int i = 0; i < M; i += len) {
+				for (int j = 0; j < half; ++j) {
+					const int32_t wr = T.tw_r[j * step];
+					const int32_t wi = T.tw_i[j * step];
+					int32_t* a = &buf[2 * (i + j)];
+					int32_t* b = &buf[2 * (i + j + half)];
+					const int32_t tr = (int32_t)(((int64_t)b[0] * wr - (int64_t)b[1] * wi + kRound) >> 15);
+					const int32_t ti = (int32_t)(((int64_t)b[0] * wi + (int64_t)b[1] * wr + kRound) >> 15);
+					b[0] = a[0] - tr;
+					b[1] = a[1] - ti;
+					a[0] = a[0] + tr;
+					a[1] = a[1] + ti;
+					bits |= absBits(a[0]) | absBits(a[1]) | absBits(b[0]) | absBits(b[1]);
+				}
+			}
+		}
+		exponent += headroom_(buf, bits);
+
+		// Split step in 64-bit intermediates; outputs stay below 2^31.
+		const int64_t dc_r = buf[0], dc_i = buf[1];
+		buf[0] = (int32_t)(dc_r + dc_i);
+		buf[1] = (int32_t)(dc_r - dc_i);
+		for (int k = 1; k <= M / 2; ++k) {
+			const int64_t pr = buf[2 * k], pi = buf[2 * k + 1];
+			const int64_t nr = buf[2 * (M - k)], ni = -(int64_t)buf[2 * (M - k) + 1];
+			const int64_t f1r = pr + nr, f1i = pi + ni;
+			const int64_t f2r = pr - nr, f2i = pi - ni;
+			const int64_t sr = T.st_r[k - 1], si = T.st_i[k - 1];
+			const int64_t twr = (f2r * sr - f2i * si + kRound) >> 15;
+			const int64_t twi = (f2r * si + f2i * sr + kRound) >> 15;
+			buf[2 * k]           = (int32_t)((f1r + twr) >> 1);
+			buf[2 * k + 1]       = (int32_t)((f1i + twi) >> 1);
+			buf[2 * (M - k)]     = (int32_t)((f1r - twr) >> 1);
+			buf[2 * (M - k) + 1] = (int32_t)((twi - f1i) >> 1);
+		}
+		return exponent;
+	}
+
+private:
+	static constexpr int M = N / 2;
+	static constexpr int kNormBit = 28;		// input block MSB after normalization
+	static constexpr int kLimitBit = 29;	// shift before a stage once |x| reaches 2^29
+	static constexpr int64_t kRound = 1 << 14;
+	static constexpr fixedfft_detail::Tables<N> kTables = fixedfft_detail::Tables<N>();
+
+	// Shift the block right until |x| < 2^29: a radix-2 stage grows components
+	// by at most 1 + sqrt(2), the split step by at most (2 + 2*sqrt(2)) / 2.
+	static int headroom_(int32_t* buf, uint32_t bits) {
+		int sh = 0;
+		while ((bits >> sh) >= (1u << kLimitBit)) ++sh;
+		if (sh) {
+			for (int i = 0; i < N; ++i) buf[i] >>= sh;
+		}
+		return sh;
+	}
+};
@@ -0,0 +1,193 @@
+#pragma once
+#include <stdint.h>
+#include "FFTBackend.h"
+#include "DSPMath.h"
+
+// Packed real FFT of N points computed as an N/2-point complex FFT of the
+// even/odd sample pairs followed by a split step. The complex stage is
+// mixed-radix (4, 2, 3, 5), so N only has to be even with N/2 factoring into
+// those radices: 512 (4^4) and 320 (4*4*2*5) both work, the latter matching a
+// 20 ms window at 16 kHz without zero padding.
+//
+// All twiddles are generated at compile time and stored as const data, so
+// nothing is allocated or built at run time and the tables stay in flash.
+
+namespace realfft_detail {
+
+struct Cpx {
+	float r;
+	float i;
+};
+
+constexpr int kMaxFactors = 16;
+
+template <int N>
+struct Tables {
+	static constexpr int M = N / 2;
+	Cpx tw[M];				// exp(-2*pi*i*k/M), complex stage
+	Cpx super_tw[M / 2];	// exp(-i*pi*((k+1)/M + 1/2)), split step
+	int factors[2 * kMaxFactors];	// (radix, remaining length) pairs
+
+	constexpr Tables() : tw(), super_tw(), factors() {
+		for (int k = 0; k < M; ++k) {
+			const double ph = -2.0 * dspmath::kPi * (double)k / (double)M;
+			tw[k].r = (float)dspmath::cos(ph);
+			tw[k].i = (float)dspmath::sin(ph);
+		}
+		for (int k = 0; k < M / 2; ++k) {
+			const double ph = -dspmath::kPi * ((double)(k + 1) / (double)M + 0.5);
+			super_tw[k].r = (float)dspmath::cos(ph);
+			super_tw[k].i = (float)dspmath::sin(ph);
+		}
+		int n = M, p = 4, f = 0;
+		while (n > 1) {
+			while (n % p) {
+				p = (p == 4) ? 2 : (p == 2) ? 3 : p + 2;
+			}
+			n /= p;
+			factors[f++] = p;
+			factors[f++] = n;
+		}
+	}
+};
+
+constexpr bool factorsSupported(int m) {
+	while (m % 4 == 0) m /= 4;
+	while (m % 2 == 0) m /= 2;
+	while (m % 3 == 0) m /= 3;
+	while (m % 5 == 0) m /= 5;
+	return m == 1;
+}
+
+}  // namespace realfft_detail
+
+template <int N>
+class RealFFT : public FFTBackend {
+	static_assert(N % 2 == 0 && N >= 4, "RealFFT size must be even");
+	static_assert(realfft_detail::factorsSupported(N / 2), "N/2 must factor into 2, 3, 4, 5");
+
+public:
+	int size() const override { return N; }
+
+	void forward(const float* in, float* out) override {
+		// Even/odd samples form the real/imag parts of an N/2-point signal.
+		work_(z_, reinterpret_cast<const Cpx*>(in), 1, kTables.factors);
+
+		const Cpx dc = z_[0];
+		out[0] = dc.r + dc.i;
+		out[1] = dc.r - dc.i;
+		for (int k = 1; k <= M / 2; ++k) {
+			const Cpx fpk = z_[k];
+			const Cpx fpnk = { z_[M - k].r, -z_[M - k].i };
+			const Cpx f1k = { fpk.r + fpnk.r, fpk.i + fpnk.i };
+			const Cpx f2k = { fpk.r - fpnk.r, fpk.i - fpnk.i };
+			const Cpx st = kTables.super_tw[k - 1];
+			const Cpx tw = { f2k.r * st.r - f2k.i * st.i, f2k.r * st.i + f2k.i * st.r };
+			out[2 * k]     = 0.5f * (f1k.r + tw.r);
+			out[2 * k + 1] = 0.5f * (f1k.i + tw.i);
+			out[2 * (M - k)]     = 0.5f * (f1k.r - tw.r);
+			out[2 * (M - k) + 1] = 0.5f * (tw.i - f1k.i);
+		}
+	}
+
+private:
+	static constexpr int M = N / 2;
+	using Cpx = realfft_detail::Cpx;
+	static constexpr realfft_detail::Tables<N> kTables = realfft_detail::Tables<N>();
+
+	Cpx z_[M];	// complex-stage output; keeps `in` untouched until the split
+
+	// Decimation-in-time recursion over the factor list (kissfft layout).
+	static void work_(Cpx* out, const Cpx* f, int fstride, const int* factors) {
+		const int p = factors[0];
+		const int m = factors[1];
+		Cpx* const beg = out;
+		Cpx* const end = out + p * m;
+		if (m == 1) {
+			do { *out = *f; f += fstride; } while (++out != end);
+		} else {
+			do {
+				work_(out, f, fstride * p, factors + 2);
+				f += fstride;
+			} while ((out += m) != end);
+		}
+		switch (p) {
+			case 2: bfly2_(beg, fstride, m); break;
+			case 3: bfly3_(beg, fstride, m); break;
+			case 4: bfly4_(beg, fstride, m); break;
+			default: bfly5_(beg, fstride, m); break;
+		}
+	}
+
+	static inline Cpx mul_(Cpx a, Cpx b) {
+		return { a.r * b.r - a.i * b.i, a.r * b.i + a.i * b.r };
+	}
+
+	static void bfly2_(Cpx* out, int fstride, int m) {
+		for (int k = 0; k < m; ++k) {
+			const Cpx t = mul_(out[m + k], kTables.tw[k * fstride]);
+			out[m + k] = { out[k].r - t.r, out[k].i - t.i };
+			out[k] = { out[k].r + t.r, out[k].i + t.i };
+		}
+	}
+
+	static void bfly3_(Cpx* out, int fstride, int m) {
+		const float s3 = kTables.tw[fstride * m].i;	// -sin(2*pi/3)
+		for (int k = 0; k < m; ++k) {
+			const Cpx a1 = mul_(out[m + k], kTables.tw[k * fstride]);
+			const Cpx a2 = mul_(out[2 * m + k], kTables.tw[2 * k * fstride]);
+			const Cpx s = { a1.r + a2.r, a1.i + a2.i };
+			const Cpx d = { (a1.r - a2.r) * s3, (a1.i - a2.i) * s3 };
+			const Cpx h = { out[k].r - 0.5f * s.r, out[k].i - 0.5f * s.i };
+			out[k] = { out[k].r + s.r, out[k].i + s.i };
+			out[m + k]     = { h.r - d.i, h.i + d.r };
+			out[2 * m + k] = { h.r + d.i, h.i - d.r };
+		}
+	}
+
+	static void bfly4_(Cpx* out, int fstride, int m) {
+		for (int k = 0; k < m; ++k) {
+			const Cpx s0 = mul_(out[m + k], kTables.tw[k * fstride]);
+			const Cpx s1 = mul_(out[2 * m + k], kTables.tw[2 * k * fstride]);
+			const Cpx s2 = mul_(out[3 * m + k], kTables.tw[3 * k * fstride]);
+			const Cpx s5 = { out[k].r - s1.r, out[k].i - s1.i };
+			const Cpx x0 = { out[k].r + s1.r, out[k].i + s1.i };
+			const Cpx s3 = { s0.r + s2.r, s0.i + s2.i };
+			const Cpx s4 = { s0.r - s2.r, s0.i - s2.i };
+			out[2 * m + k] = { x0.r - s3.r, x0.i - s3.i };
+			out[k]         = { x0.r + s3.r, x0.i + s3.i };
+			out[m + k]     = { s5.r + s4.i, s5.i - s4.r };
+			out[3 * m + k] = { s5.r - s4.i, s5.i + s4.r };
+		}
+	}
+
+	static void bfly5_(Cpx* out, int fstride, int m) {
+		const Cpx ya = kTables.tw[fstride * m];
+		const Cpx yb = kTables.tw[2 * fstride * m];
+		Cpx* o0 = out;
+		Cpx* o1 = out + m;
+		Cpx* o2 = out + 2 * m;
+		Cpx* o3 = out + 3 * m;
+		Cpx* o4 = out + 4 * m;
+		for (int u = 0; u < m; ++u) {
+			const Cpx s0 = o0[u];
+			const Cpx s1 = mul_(o1[u], kTables.tw[u * fstride]);
+			const Cpx s2 = mul_(o2[u], kTables.tw[2 * u * fstride]);
+			const Cpx s3 = mul_(o3[u], kTables.tw[3 * u * fstride]);
+			const Cpx s4 = mul_(o4[u], kTables.tw[4 * u * fstride]);
+			const Cpx s7 = { s1.r + s4.r, s1.i + s4.i };
+			const Cpx s10 = { s1.r - s4.r, s1.i - s4.i };
+			const Cpx s8 = { s2.r + s3.r, s2.i + s3.i };
+			const Cpx s9 = { s2.r - s3.r, s2.i - s3.i };
+			o0[u] = { s0.r + s7.r + s8.r, s0.i + s7.i + s8.i };
+			const Cpx s5 = { s0.r + s7.r * ya.r + s8.r * yb.r, s0.i + s7.i * ya.r + s8.i * yb.r };
+			const Cpx s6 = { s10.i * ya.i + s9.i * yb.i, -s10.r * ya.i - s9.r * yb.i };
+			o1[u] = { s5.r - s6.r, s5.i - s6.i };
+			o4[u] = { s5.r + s6.r, s5.i + s6.i };
+			const Cpx s11 = { s0.r + s7.r * yb.r + s8.r * ya.r, s0.i + s7.i * yb.r + s8.i * ya.r };
+			const Cpx s12 = { -s10.i * yb.i + s9.i * ya.i, s10.r * yb.i - s9.r * ya.i };
+			o2[u] = { s11.r + s12.r, s11.i + s12.i };
+			o3[u] = { s11.r - s12.r, s11.i - s12.i };
+		}
+	}
+};
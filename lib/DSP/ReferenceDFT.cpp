@@ -0,0 +1,29 @@
+#include "ReferenceDFT.h"
+#include <math.h>
+
+ReferenceDFT::ReferenceDFT(int n) : n_(n), tmp_(new double[n]) {}
+
+ReferenceDFT::~ReferenceDFT() {
+	delete[] tmp_;
+}
+
+void ReferenceDFT::forward(const float* in, float* out) {
+	const double w = -2.0 * M_PI / (double)n_;
+	for (int k = 0; k <= n_ / 2; ++k) {
+		double re = 0.0, im = 0.0;
+		for (int t = 0; t < n_; ++t) {
+			const double ph = w * (double)((long long)k * t % n_);
+			re += (double)in[t] * cos(ph);
+			im += (double)in[t] * sin(ph);
+		}
+		if (k == 0) {
+			tmp_[0] = re;
+		} else if (k == n_ / 2) {
+			tmp_[1] = re;
+		} else {
+			tmp_[2 * k] = re;
+			tmp_[2 * k + 1] = im;
+		}
+	}
+	for (int i = 0; i < n_; ++i) out[i] = (float)tmp_[i];
+}
@@ -0,0 +1,16 @@
+#pragma once
+#include "FFTBackend.h"
+
+// Direct O(N^2) DFT in double precision. Portable and allocation-free apart
+// from the constructor; used on host to validate the fast backends.
+class ReferenceDFT : public FFTBackend {
+public:
+	explicit ReferenceDFT(int n);
+	~ReferenceDFT();
+	int size() const override { return n_; }
+	void forward(const float* in, float* out) override;
+
+private:
+	int		n_;
+	double*	tmp_;
+};
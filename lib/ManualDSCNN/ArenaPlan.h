@@ -0,0 +1,50 @@
+#pragma once
+
+// Compile-time activation memory plan. Each tensor has a size (in elements)
+// and a lifetime [first, last] in layer indices; tensors whose lifetimes
+// overlap must not share memory, everything else may. Placement is the usual
+// greedy-by-size first fit, so buffers ping-pong between layers and the
+// arena only has to hold the largest set of simultaneously live tensors.
+
+struct TensorLife {
+	int size;
+	int first;
+	int last;
+};
+
+template <int N>
+struct ArenaPlan {
+	int offset[N];
+	int peak;
+
+	constexpr ArenaPlan(const TensorLife (&t)[N]) : offset(), peak(0) {
+		int order[N] = {};
+		for (int i = 0; i < N; ++i) order[i] = i;
+		for (int i = 1; i < N; ++i) {	// largest first
+			for (int j = i; j > 0 && t[order[j]].size > t[order[j - 1]].size; --j) {
+				const int tmp = order[j];
+				order[j] = order[j - 1];
+				order[j - 1] = tmp;
+			}
+		}
+		bool placed[N] = {};
+		for (int n = 0; n < N; ++n) {
+			const int i = order[n];
+			int at = 0;
+			bool moved = true;
+			while (moved) {	// bump past every live, placed tensor we collide with
+				moved = false;
+				for (int j = 0; j < N; ++j) {
+					if (!placed[j] || t[j].last < t[i].first || t[i].last < t[j].first) continue;
+					if (at < offset[j] + t[j].size && offset[j] < at + t[i].size) {
+						at = offset[j] + t[j].size;
+						moved = true;
+					}
+				}
+			}
+			offset[i] = at;
+			placed[i] = true;
+			if (at + t[i].size > peak) peak = at + t[i].size;
+		}
+	}
+};
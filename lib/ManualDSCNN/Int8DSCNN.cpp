@@ -0,0 +1,170 @@
+#include "Int8DSCNN.h"
+#include <Arduino.h>
+#include <math.h>
+#include <string.h>
+#include "env.h"
+#include "Int8Kernels.h"
+#include "model_weights.h"
+#include "model_int8_quant.h"
+
+#define Q8_REQUANT(layer) \
+	q8::Requant{ q8_##layer##_mult, q8_##layer##_shift, q8_##layer##_out_zp, q8_##layer##_act_min, q8_##layer##_act_max }
+
+Int8DSCNN::Int8DSCNN() {
+	memset(arena_, 0, sizeof(arena_));
+	q8::foldInputOffset(ds_cnn_tiny_v2_b1_pw_Conv2D, ds_cnn_tiny_v2_batch_normalization_2_FusedBatchNormV3,
+	                    24, 16, q8_b1_pw_in_zp, b1_pw_bias_);
+	q8::foldInputOffset(ds_cnn_tiny_v2_b2_pw_Conv2D, ds_cnn_tiny_v2_batch_normalization_4_FusedBatchNormV3,
+	                    32, 24, q8_b2_pw_in_zp, b2_pw_bias_);
+	q8::foldInputOffset(ds_cnn_tiny_v2_b3_pw_Conv2D, ds_cnn_tiny_v2_batch_normalization_6_FusedBatchNormV3,
+	                    48, 32, q8_b3_pw_in_zp, b3_pw_bias_);
+}
+
+bool Int8DSCNN::begin() {
+	Serial.println("DEBUG: Int8DSCNN begin");
+	Serial.printf("DEBUG: Int8DSCNN arena %u bytes (budget %u)\n",
+	              (unsigned)sizeof(arena_), (unsigned)INT8DSCNN_ARENA_BUDGET);
+	Serial.flush();
+	return true;
+}
+
+void Int8DSCNN::run_(const int8_t* input, int n, int stride) {
+	// Layer-major: every window passes a layer before the next one starts,
+	// so that layer's weights stay hot in cache for the whole batch.
+	for (int l = 0; l < kNumLayers; ++l) {
+		for (int b = 0; b < n; ++b) layer_((Layer)l, &input[b * stride], b);
+	}
+}
+
+void Int8DSCNN::layer_(Layer layer, const int8_t* input, int b) {
+	switch (layer) {
+	case kLayerConv:
+		q8::conv3x3In1(input, kH0, kW, q8_conv_in_zp, ds_cnn_tiny_v2_conv2d_Conv2D,
+		               ds_cnn_tiny_v2_batch_normalization_FusedBatchNormV3, 16, Q8_REQUANT(conv), tensor_(kConv, b));
+		break;
+	case kLayerB1Dw:
+		q8::depthwise3x3(tensor_(kConv, b), kH0, kW, 16, q8_b1_dw_in_zp, ds_cnn_tiny_v2_b1_dw_depthwise,
+		                 ds_cnn_tiny_v2_batch_normalization_1_FusedBatchNormV3, Q8_REQUANT(b1_dw), tensor_(kB1Dw, b));
+		break;
+	case kLayerB1Pw:
+		q8::pointwise(tensor_(kB1Dw, b), kH0 * kW, 16, ds_cnn_tiny_v2_b1_pw_Conv2D, b1_pw_bias_, 24, Q8_REQUANT(b1_pw),
+		              tensor_(kB1Pw, b));
+		q8::avgPool2x1(tensor_(kB1Pw, b), kH0, kW, 24, tensor_(kPool1, b));
+		break;
+	case kLayerB2Dw:
+		q8::depthwise3x3(tensor_(kPool1, b), kH1, kW, 24, q8_b2_dw_in_zp, ds_cnn_tiny_v2_b2_dw_depthwise,
+		                 ds_cnn_tiny_v2_batch_normalization_3_FusedBatchNormV3, Q8_REQUANT(b2_dw), tensor_(kB2Dw, b));
+		break;
+	case kLayerB2Pw:
+		q8::pointwise(tensor_(kB2Dw, b), kH1 * kW, 24, ds_cnn_tiny_v2_b2_pw_Conv2D, b2_pw_bias_, 32, Q8_REQUANT(b2_pw),
+		              tensor_(kB2Pw, b));
+		break;
+	case kLayerB3Dw:
+		q8::depthwise3x3(tensor_(kB2Pw, b), kH1, kW, 32, q8_b3_dw_in_zp, ds_cnn_tiny_v2_b3_dw_depthwise,
+		                 ds_cnn_tiny_v2_batch_normalization_5_FusedBatchNormV3, Q8_REQUANT(b3_dw), tensor_(kB3Dw, b));
+		break;
+	case kLayerB3PwGap: {
+		// b3_pw, pool2 and the GAP sum run fused; only the 48 sums come out.
+		int32_t gap_sum[48];
+		q8::pointwisePoolSum(tensor_(kB3Dw, b), kH1, kW, 32, ds_cnn_tiny_v2_b3_pw_Conv2D, b3_pw_bias_, 48, Q8_REQUANT(b3_pw),
+		                     q8_gap_in_zp, gap_sum);
+		q8::meanFromSum(gap_sum, kH2 * kW, 48, q8_gap_mult, q8_gap_shift, q8_gap_out_zp, tensor_(kGap, b));
+		break;
+	}
+	case kLayerDense:
+		q8::fullyConnected(tensor_(kGap, b), 48, q8_dense_in_zp, ds_cnn_tiny_v2_dense_MatMul,
+		                   ds_cnn_tiny_v2_dense_BiasAdd_ReadVariableOp, KWS_NUM_CLASSES, Q8_REQUANT(dense), tensor_(kLogits, b));
+		break;
+	default:
+		break;
+	}
+}
+
+void Int8DSCNN::finish_(int b, float* probs, float* logits) {
+	float l[KWS_NUM_CLASSES];
+	const int8_t* q = tensor_(kLogits, b);
+	float max_logit = -INFINITY;
+	for (int i = 0; i < KWS_NUM_CLASSES; ++i) {
+		l[i] = q8_softmax_in_scale * (float)((int32_t)q[i] - q8_softmax_in_zp);
+		if (l[i] > max_logit) max_logit = l[i];
+	}
+	float sum_exp = 0.0f;
+	for (int i = 0; i < KWS_NUM_CLASSES; ++i) {
+		probs[i] = expf(l[i] - max_logit);
+		sum_exp += probs[i];
+	}
+	for (int i = 0; i < KWS_NUM_CLASSES; ++i) probs[i] /= sum_exp;
+	if (logits) memcpy(logits, l, sizeof(l));
+}
+
+void Int8DSCNN::quantize_(const float* mfcc_flat, int b) {
+	int8_t* in = tensor_(kInput, b);
+	for (int i = 0; i < kH0 * kW; ++i) {
+		int32_t q = (int32_t)lrintf(mfcc_flat[i] / input_scale) + input_zero_point;
+		in[i] = q8::clampAct(q, -128, 127);
+	}
+}
+
+void Int8DSCNN::predict_full(const float* mfcc_flat, float* probs, float* logits) {
+	if (!mfcc_flat || !probs) {
+		Serial.println("ERROR: Invalid input to predict_full");
+		return;
+	}
+	quantize_(mfcc_flat, 0);
+	run_(tensor_(kInput), 1, kWindow);
+	finish_(0, probs, logits);
+}
+
+void Int8DSCNN::predict_full_q(const int8_t* mfcc_q, float* probs, float* logits) {
+	if (!mfcc_q || !probs) {
+		Serial.println("ERROR: Invalid input to predict_full_q");
+		return;
+	}
+	run_(mfcc_q, 1, kWindow);
+	finish_(0, probs, logits);
+}
+
+void Int8DSCNN::predict_batch(const float* windows, int n, float* probs, float* logits, int stride) {
+	if (!windows || !probs || n < 0) {
+		Serial.println("ERROR: Invalid input to predict_batch");
+		return;
+	}
+	for (int first = 0; first < n; first += kMaxBatch) {
+		const int m = (n - first < kMaxBatch) ? n - first : kMaxBatch;
+		for (int b = 0; b < m; ++b) quantize_(&windows[(first + b) * stride], b);
+		run_(tensor_(kInput), m, kPlan.peak);	// the inputs sit one arena slice apart
+		for (int b = 0; b < m; ++b) {
+			const int k = (first + b) * KWS_NUM_CLASSES;
+			finish_(b, &probs[k], logits ? &logits[k] : nullptr);
+		}
+	}
+}
+
+void Int8DSCNN::predict_batch_q(const int8_t* windows, int n, float* probs, float* logits, int stride) {
+	if (!windows || !probs || n < 0) {
+		Serial.println("ERROR: Invalid input to predict_batch_q");
+		return;
+	}
+	for (int first = 0; first < n; first += kMaxBatch) {
+		const int m = (n - first < kMaxBatch) ? n - first : kMaxBatch;
+		run_(&windows[first * stride], m, stride);
+		for (int b = 0; b < m; ++b) {
+			const int k = (first + b) * KWS_NUM_CLASSES;
+			finish_(b, &probs[k], logits ? &logits[k] : nullptr);
+		}
+	}
+}
+
+static_assert(WAKE_CLASS_INDEX >= 0 && WAKE_CLASS_INDEX < KWS_NUM_CLASSES, "WAKE_CLASS_INDEX out of range");
+
+float Int8DSCNN::predict_proba(const float* mfcc_flat) {
+	float probs[KWS_NUM_CLASSES];
+	predict_full(mfcc_flat, probs, nullptr);
+	return probs[WAKE_CLASS_INDEX];
+}
+
+float Int8DSCNN::predict_proba_q(const int8_t* mfcc_q) {
+	float probs[KWS_NUM_CLASSES];
+	predict_full_q(mfcc_q, probs, nullptr);
+	return probs[WAKE_CLASS_INDEX];
+}
@@ -0,0 +1,104 @@
+#ifndef INT8DSCNN_H
+#define INT8DSCNN_H
+
+#include <stdint.h>
+#include "frontend_params.h"
+#include "ArenaPlan.h"
+
+// Activation arena limit in bytes; the build fails if the plan exceeds it.
+#ifndef INT8DSCNN_ARENA_BUDGET
+#define INT8DSCNN_ARENA_BUDGET (40 * 1024)
+#endif
+// Windows a batch runs through each layer together. Every one needs its own
+// arena, so the default keeps a single window; offline evaluation on the host
+// or a PSRAM arena can raise it (and the budget).
+#ifndef INT8DSCNN_MAX_BATCH
+#define INT8DSCNN_MAX_BATCH 1
+#endif
+
+// Full int8 ds_cnn_tiny_v2 (models/model_weights.h) with TFLite-exact integer
+// kernels:
+//   conv 3x3 1->16, 3 x (dw 3x3 + pw 1x1) to 16/24/32/48 channels with 2x1
+//   average pools after blocks 1 and 3, global average pool, dense 48->3.
+// Requantization parameters come from models/model_int8_quant.h. Softmax runs
+// in float on the dequantized logits, which is all the float API needs.
+class Int8DSCNN {
+public:
+	Int8DSCNN();
+	bool begin();
+
+	// Same interface as ManualDSCNN: normalized float MFCCs in, quantized
+	// with the model's input scale/zero point. predict_proba*() return the
+	// wake class's probability, probs[WAKE_CLASS_INDEX].
+	void predict_full(const float* mfcc_flat, float* probs, float* logits = nullptr);
+	float predict_proba(const float* mfcc_flat);
+
+	// Already-quantized input (AudioProcessor int8 rows), read in place.
+	void predict_full_q(const int8_t* mfcc_q, float* probs, float* logits = nullptr);
+	float predict_proba_q(const int8_t* mfcc_q);
+
+	// n windows, `stride` elements apart; probs/logits are n x
+	// KWS_NUM_CLASSES. Groups of up to kMaxBatch windows go through the
+	// network layer by layer, so each layer's weights are fetched once per
+	// group. Integer arithmetic makes the results identical to the
+	// single-window calls.
+	void predict_batch(const float* windows, int n, float* probs, float* logits = nullptr,
+	                   int stride = kWindow);
+	void predict_batch_q(const int8_t* windows, int n, float* probs, float* logits = nullptr,
+	                     int stride = kWindow);
+
+	// Quantized logits of the last call (its first window for a batch).
+	const int8_t* lastLogitsQ() const { return &arena_[kPlan.offset[kLogits]]; }
+
+	static const int kWindow = KWS_FRAMES * KWS_NUM_MFCC;
+	static const int kMaxBatch = INT8DSCNN_MAX_BATCH;
+
+private:
+	static const int kH0 = KWS_FRAMES;			// 65
+	static const int kH1 = (KWS_FRAMES + 1) / 2;	// 33 after pool1
+	static const int kH2 = (kH1 + 1) / 2;		// 17 after pool2
+	static const int kW = KWS_NUM_MFCC;
+
+	// Lifetimes in layer steps: 0 quantize, 1 conv, 2 b1_dw, 3 b1_pw, 4 pool1,
+	// 5 b2_dw, 6 b2_pw, 7 b3_dw, 8 fused b3_pw + pool2 + gap, 9 dense,
+	// 10 softmax. The b3_pw and pool2 outputs are never stored.
+	enum Tensor { kInput, kConv, kB1Dw, kB1Pw, kPool1, kB2Dw, kB2Pw, kB3Dw, kGap, kLogits, kNumTensors };
+	static constexpr TensorLife kTensors[kNumTensors] = {
+		{ kH0 * kW, 0, 1 },
+		{ kH0 * kW * 16, 1, 2 },
+		{ kH0 * kW * 16, 2, 3 },
+		{ kH0 * kW * 24, 3, 4 },
+		{ kH1 * kW * 24, 4, 5 },
+		{ kH1 * kW * 24, 5, 6 },
+		{ kH1 * kW * 32, 6, 7 },
+		{ kH1 * kW * 32, 7, 8 },
+		{ 48, 8, 9 },
+		{ KWS_NUM_CLASSES, 9, 10 },
+	};
+	static constexpr ArenaPlan<kNumTensors> kPlan = ArenaPlan<kNumTensors>(kTensors);
+	static_assert(kPlan.peak * kMaxBatch <= INT8DSCNN_ARENA_BUDGET,
+	              "Int8DSCNN activation plan exceeds INT8DSCNN_ARENA_BUDGET");
+
+	// One plan-sized slice per batch window.
+	int8_t arena_[kMaxBatch * kPlan.peak];
+	int8_t* tensor_(Tensor t, int b = 0) { return &arena_[b * kPlan.peak + kPlan.offset[t]]; }
+
+	// Pointwise biases with the input zero point folded in.
+	int32_t b1_pw_bias_[24];
+	int32_t b2_pw_bias_[32];
+	int32_t b3_pw_bias_[48];
+
+	// The steps run_() takes each window through, in order.
+	enum Layer { kLayerConv, kLayerB1Dw, kLayerB1Pw, kLayerB2Dw, kLayerB2Pw, kLayerB3Dw, kLayerB3PwGap, kLayerDense, kNumLayers };
+
+	void run_(const int8_t* input, int n, int stride);
+	// One step for window b; only kLayerConv reads `input`, the rest their
+	// predecessor's tensor.
+	void layer_(Layer layer, const int8_t* input, int b);
+	void finish_(int b, float* probs, float* logits);
+	void quantize_(const float* mfcc_flat, int b);
+
+	friend class KwsBench;
+};
+
+#endif
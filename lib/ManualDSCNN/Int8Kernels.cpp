@@ -0,0 +1,151 @@
+#include "Int8Kernels.h"
+
+namespace q8 {
+
+void conv3x3In1(const int8_t* in, int h, int w, int32_t in_zp,
+                const int8_t* weights, const int32_t* bias, int oc,
+                const Requant& rq, int8_t* out) {
+	for (int y = 0; y < h; ++y) {
+		for (int x = 0; x < w; ++x) {
+			// Gather the 3x3 patch once; padding contributes (in - in_zp) = 0.
+			int32_t patch[9];
+			for (int ky = 0; ky < 3; ++ky) {
+				for (int kx = 0; kx < 3; ++kx) {
+					const int iy = y + ky - 1, ix = x + kx - 1;
+					patch[ky * 3 + kx] = (iy >= 0 && iy < h && ix >= 0 && ix < w) ? (int32_t)in[iy * w + ix] - in_zp : 0;
+				}
+			}
+			int8_t* o = &out[(y * w + x) * oc];
+			for (int k = 0; k < oc; ++k) {
+				const int8_t* wk = &weights[k * 9];
+				int32_t acc = bias[k];
+				for (int t = 0; t < 9; ++t) acc += patch[t] * wk[t];
+				o[k] = requant(acc, rq, k);
+			}
+		}
+	}
+}
+
+void depthwise3x3(const int8_t* in, int h, int w, int c, int32_t in_zp,
+                  const int8_t* weights, const int32_t* bias,
+                  const Requant& rq, int8_t* out) {
+	int32_t acc[kMaxChannels];
+	for (int y = 0; y < h; ++y) {
+		for (int x = 0; x < w; ++x) {
+			for (int ch = 0; ch < c; ++ch) acc[ch] = bias[ch];
+			for (int ky = 0; ky < 3; ++ky) {
+				const int iy = y + ky - 1;
+				if (iy < 0 || iy >= h) continue;
+				for (int kx = 0; kx < 3; ++kx) {
+					const int ix = x + kx - 1;
+					if (ix < 0 || ix >= w) continue;
+					const int8_t* px = &in[(iy * w + ix) * c];
+					const int8_t* wk = &weights[(ky * 3 + kx) * c];
+					for (int ch = 0; ch < c; ++ch) acc[ch] += ((int32_t)px[ch] - in_zp) * wk[ch];
+				}
+			}
+			int8_t* o = &out[(y * w + x) * c];
+			for (int ch = 0; ch < c; ++ch) o[ch] = requant(acc[ch], rq, ch);
+		}
+	}
+}
+
+void foldInputOffset(const int8_t* weights, const int32_t* bias, int oc, int ic,
+                     int32_t in_zp, int32_t* bias_out) {
+	for (int o = 0; o < oc; ++o) {
+		int32_t sum = 0;
+		for (int i = 0; i < ic; ++i) sum += weights[o * ic + i];
+		bias_out[o] = bias[o] - in_zp * sum;
+	}
+}
+
+void pointwise(const int8_t* in, int pixels, int ic,
+               const int8_t* weights, const int32_t* bias, int oc,
+               const Requant& rq, int8_t* out) {
+	for (int p = 0; p < pixels; ++p) {
+		const int8_t* px = &in[p * ic];
+		int8_t* o = &out[p * oc];
+		for (int k = 0; k < oc; ++k) {
+			const int8_t* wk = &weights[k * ic];
+			int32_t acc = bias[k];
+			for (int i = 0; i < ic; ++i) acc += (int32_t)px[i] * wk[i];
+			o[k] = requant(acc, rq, k);
+		}
+	}
+}
+
+static inline int8_t pooled2_(int8_t a, int8_t b) {
+	const int32_t sum = (int32_t)a + b;
+	return (int8_t)(sum > 0 ? (sum + 1) / 2 : (sum - 1) / 2);
+}
+
+void avgPool2x1(const int8_t* in, int h, int w, int c, int8_t* out) {
+	// SAME with an even filter pads only at the end, so window y covers rows 2y and 2y + 1.
+	const int oh = (h + 1) / 2;
+	for (int y = 0; y < oh; ++y) {
+		const int8_t* r0 = &in[(2 * y) * w * c];
+		const bool pair = 2 * y + 1 < h;
+		const int8_t* r1 = pair ? r0 + w * c : r0;
+		int8_t* o = &out[y * w * c];
+		for (int i = 0; i < w * c; ++i) {
+			if (!pair) {
+				o[i] = r0[i];
+				continue;
+			}
+			o[i] = pooled2_(r0[i], r1[i]);
+		}
+	}
+}
+
+void pointwisePoolSum(const int8_t* in, int h, int w, int ic,
+                      const int8_t* weights, const int32_t* bias, int oc,
+                      const Requant& rq, int32_t sum_zp, int32_t* sum) {
+	int8_t px0[kMaxChannels];
+	int8_t px1[kMaxChannels];
+	for (int k = 0; k < oc; ++k) sum[k] = 0;
+	for (int y = 0; y < h; y += 2) {
+		const bool pair = y + 1 < h;
+		for (int x = 0; x < w; ++x) {
+			// The two pointwise outputs one pooling window needs, requantized
+			// exactly as pointwise() would store them.
+			pointwise(&in[(y * w + x) * ic], 1, ic, weights, bias, oc, rq, px0);
+			if (pair) pointwise(&in[((y + 1) * w + x) * ic], 1, ic, weights, bias, oc, rq, px1);
+			for (int k = 0; k < oc; ++k) {
+				const int8_t v = pair ? pooled2_(px0[k], px1[k]) : px0[k];
+				sum[k] += (int32_t)v - sum_zp;
+			}
+		}
+	}
+}
+
+void mean(const int8_t* in, int pixels, int c, int32_t in_zp,
+          int32_t mult, int shift, int32_t out_zp, int8_t* out) {
+	int32_t sum[kMaxChannels] = {};
+	for (int p = 0; p < pixels; ++p) {
+		const int8_t* px = &in[p * c];
+		for (int ch = 0; ch < c; ++ch) sum[ch] += (int32_t)px[ch] - in_zp;
+	}
+	meanFromSum(sum, pixels, c, mult, shift, out_zp, out);
+}
+
+void meanFromSum(const int32_t* sum, int pixels, int c,
+                 int32_t mult, int shift, int32_t out_zp, int8_t* out) {
+	for (int ch = 0; ch < c; ++ch) {
+		int32_t r = mulByQuantMult64((int64_t)sum[ch], mult, shift);
+		r = r > 0 ? (r + pixels / 2) / pixels : (r - pixels / 2) / pixels;
+		out[ch] = clampAct(r + out_zp, -128, 127);
+	}
+}
+
+void fullyConnected(const int8_t* in, int ic, int32_t in_zp,
+                    const int8_t* weights, const int32_t* bias, int oc,
+                    const Requant& rq, int8_t* out) {
+	for (int k = 0; k < oc; ++k) {
+		const int8_t* wk = &weights[k * ic];
+		int32_t acc = bias[k];
+		for (int i = 0; i < ic; ++i) acc += ((int32_t)in[i] - in_zp) * wk[i];
+		out[k] = requant(acc, rq, 0);
+	}
+}
+
+}  // namespace q8
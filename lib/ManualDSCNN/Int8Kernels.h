@@ -0,0 +1,107 @@
+#pragma once
+#include <stdint.h>
+
+// Int8 NHWC kernels with TFLite-compatible arithmetic: int32 accumulation,
+// symmetric int8 weights (zero point 0), fixed-point requantization via
+// MultiplyByQuantizedMultiplier, so results match the TFLite reference
+// kernels bit for bit.
+
+namespace q8 {
+
+// gemmlowp SaturatingRoundingDoublingHighMul.
+inline int32_t srdhm(int32_t a, int32_t b) {
+	if (a == b && a == INT32_MIN) return INT32_MAX;
+	const int64_t ab = (int64_t)a * (int64_t)b;
+	const int32_t nudge = ab >= 0 ? (1 << 30) : (1 - (1 << 30));
+	return (int32_t)((ab + nudge) / (1LL << 31));
+}
+
+// Arithmetic shift right with round-half-away-from-zero.
+inline int32_t roundingDivideByPOT(int32_t x, int exponent) {
+	const int32_t mask = (int32_t)((1LL << exponent) - 1);
+	const int32_t remainder = x & mask;
+	const int32_t threshold = (mask >> 1) + (x < 0 ? 1 : 0);
+	return (x >> exponent) + (remainder > threshold ? 1 : 0);
+}
+
+// x * multiplier * 2^(shift - 31), multiplier in [2^30, 2^31).
+inline int32_t mulByQuantMult(int32_t x, int32_t multiplier, int shift) {
+	const int left = shift > 0 ? shift : 0;
+	const int right = shift > 0 ? 0 : -shift;
+	return roundingDivideByPOT(srdhm(x * (1 << left), multiplier), right);
+}
+
+// 64-bit accumulator variant (TFLite uses it for reductions).
+inline int32_t mulByQuantMult64(int64_t x, int32_t multiplier, int shift) {
+	const int32_t reduced = multiplier < 0x7FFF0000 ? ((multiplier + (1 << 15)) >> 16) : 0x7FFF;
+	const int total_shift = 15 - shift;
+	x = x * (int64_t)reduced + ((int64_t)1 << (total_shift - 1));
+	return (int32_t)(x >> total_shift);
+}
+
+inline int8_t clampAct(int32_t v, int32_t lo, int32_t hi) {
+	return (int8_t)(v < lo ? lo : (v > hi ? hi : v));
+}
+
+// Output-side quantization of one layer. mult/shift are indexed per output
+// channel; per-tensor layers point at a single entry and use channel 0.
+struct Requant {
+	const int32_t*	mult;
+	const int8_t*	shift;
+	int32_t			out_zp;
+	int32_t			act_min;
+	int32_t			act_max;
+};
+
+inline int8_t requant(int32_t acc, const Requant& rq, int ch) {
+	return clampAct(mulByQuantMult(acc, rq.mult[ch], rq.shift[ch]) + rq.out_zp, rq.act_min, rq.act_max);
+}
+
+// 3x3 convolution, single input channel, stride 1, SAME padding.
+// w: [oc][3][3][1]
+void conv3x3In1(const int8_t* in, int h, int w, int32_t in_zp,
+                const int8_t* weights, const int32_t* bias, int oc,
+                const Requant& rq, int8_t* out);
+
+// 3x3 depthwise convolution, multiplier 1, stride 1, SAME padding.
+// w: [3][3][c]. c <= kMaxChannels.
+void depthwise3x3(const int8_t* in, int h, int w, int c, int32_t in_zp,
+                  const int8_t* weights, const int32_t* bias,
+                  const Requant& rq, int8_t* out);
+
+// 1x1 convolution over `pixels` positions. w: [oc][ic]. bias must already
+// include -in_zp * sum(w[oc]) (see foldInputOffset).
+void pointwise(const int8_t* in, int pixels, int ic,
+               const int8_t* weights, const int32_t* bias, int oc,
+               const Requant& rq, int8_t* out);
+
+// bias_out[o] = bias[o] - in_zp * sum_i w[o][i]
+void foldInputOffset(const int8_t* weights, const int32_t* bias, int oc, int ic,
+                     int32_t in_zp, int32_t* bias_out);
+
+// 2x1 average pool, stride 2 along h, SAME padding; same quantization in and out.
+void avgPool2x1(const int8_t* in, int h, int w, int c, int8_t* out);
+
+// Mean over all pixels per channel with requantization (global average pool).
+void mean(const int8_t* in, int pixels, int c, int32_t in_zp,
+          int32_t mult, int shift, int32_t out_zp, int8_t* out);
+// The requantization half of mean(), for sums accumulated elsewhere.
+void meanFromSum(const int32_t* sum, int pixels, int c,
+                 int32_t mult, int shift, int32_t out_zp, int8_t* out);
+
+// pointwise() + avgPool2x1() + the summing half of mean(), fused: each pair of
+// rows is pooled as soon as it is computed and goes straight into
+// sum[o] = sum over pooled pixels of (pooled - sum_zp). Neither the pointwise
+// nor the pooled tensor is written. Bit-identical to the three separate steps.
+void pointwisePoolSum(const int8_t* in, int h, int w, int ic,
+                      const int8_t* weights, const int32_t* bias, int oc,
+                      const Requant& rq, int32_t sum_zp, int32_t* sum);
+
+// out[o] = requant(bias[o] + sum_i (in[i] - in_zp) * w[o][i]). w: [oc][ic].
+void fullyConnected(const int8_t* in, int ic, int32_t in_zp,
+                    const int8_t* weights, const int32_t* bias, int oc,
+                    const Requant& rq, int8_t* out);
+
+static const int kMaxChannels = 64;
+
+}  // namespace q8
@@ -3,36 +3,17 @@
 #include <string.h>
 #include <math.h>
 #include "frontend_params.h"
-#include "model_weights_float.h"
-
-ManualDSCNN::ManualDSCNN() {
-	// Load weights and biases from model_weights_float.h
-	memcpy(conv1_weights, conv2d_1_w, sizeof(conv2d_1_w));  // 3x3x1x16
-	memcpy(conv1_gamma, batch_normalization_7_gamma, sizeof(batch_normalization_7_gamma));
-	memcpy(conv1_beta, batch_normalization_7_beta, sizeof(batch_normalization_7_beta));
-	memcpy(conv1_mean, batch_normalization_7_mean, sizeof(batch_normalization_7_mean));
-	memcpy(conv1_var, batch_normalization_7_var, sizeof(batch_normalization_7_var));
-	memcpy(conv1_gamma_post, batch_normalization_8_gamma, sizeof(batch_normalization_8_gamma));
-	memcpy(conv1_beta_post, batch_normalization_8_beta, sizeof(batch_normalization_8_beta));
-	memcpy(conv1_mean_post, batch_normalization_8_mean, sizeof(batch_normalization_8_mean));
-	memcpy(conv1_var_post, batch_normalization_8_var, sizeof(batch_normalization_8_var));
-	memcpy(conv2_weights, b1_pw_w, sizeof(b1_pw_w));  // 1x1x16x24
-	memcpy(conv2_gamma, batch_normalization_9_gamma, sizeof(batch_normalization_9_gamma));
-	memcpy(conv2_beta, batch_normalization_9_beta, sizeof(batch_normalization_9_beta));
-	memcpy(conv2_mean, batch_normalization_9_mean, sizeof(batch_normalization_9_mean));
-	memcpy(conv2_var, batch_normalization_9_var, sizeof(batch_normalization_9_var));
-	memcpy(conv2_gamma_post, batch_normalization_10_gamma, sizeof(batch_normalization_10_gamma));
-	memcpy(conv2_beta_post, batch_normalization_10_beta, sizeof(batch_normalization_10_beta));
-	memcpy(conv2_mean_post, batch_normalization_10_mean, sizeof(batch_normalization_10_mean));
-	memcpy(conv2_var_post, batch_normalization_10_var, sizeof(batch_normalization_10_var));
-	// Stub dense_weights with zeros (24x3, adjust when full dense_1_w available)
-	memset(dense_weights, 0, sizeof(float) * 24 * KWS_NUM_CLASSES);
-	memcpy(dense_bias, dense_1_b, sizeof(dense_1_b));  // 3
-}
+#include "env.h"
+#include "DSPKernels.h"
+#include "model_float_packed.h"
+
+ManualDSCNN::ManualDSCNN() {}
 
 bool ManualDSCNN::begin() {
 	Serial.println("DEBUG: ManualDSCNN begin");
-	Serial.println("DEBUG: ManualDSCNN weights loaded from model_weights_float.h (dense_1_w stubbed)");
+	Serial.println("DEBUG: ManualDSCNN weights from model_float_packed.h (BN folded, dense_1_w stubbed)");
+	Serial.printf("DEBUG: ManualDSCNN arena %u bytes (budget %u)\n",
+	              (unsigned)sizeof(arena_), (unsigned)MANUALDSCNN_ARENA_BUDGET);
 	Serial.flush();
 	return true;
 }
@@ -42,89 +23,35 @@ void ManualDSCNN::predict_full(const float* mfcc_flat, float* probs, float* logi
 		Serial.println("ERROR: Invalid input to predict_full");
 		return;
 	}
-	if (!logits) {
-		logits = new float[KWS_NUM_CLASSES]();
-	}
+	// No heap: the input is read in place, and the pooled vector and logits
+	// live in the planned arena unless the caller wants the logits.
+	if (!logits) logits = tensor_(kLogits);
 	memset(logits, 0, KWS_NUM_CLASSES * sizeof(float));
 	memset(probs, 0, KWS_NUM_CLASSES * sizeof(float));
 
-	// Reshape MFCC to 2D input [KWS_FRAMES][KWS_NUM_MFCC]
-	float input[KWS_FRAMES][KWS_NUM_MFCC];
-	for (int t = 0; t < KWS_FRAMES; ++t) {
-		for (int c = 0; c < KWS_NUM_MFCC; ++c) {
-			input[t][c] = mfcc_flat[t * KWS_NUM_MFCC + c];
-		}
-	}
+	// Fused: each time column goes conv -> ReLU -> pointwise -> ReLU while
+	// it is in registers and lands straight in the pooled sum, so neither
+	// activation tensor is ever written out.
+	float* gap = tensor_(kGap);
+	pool_(mfcc_flat, 1, kWindow, gap);
 
-	// Block 1: Depthwise Conv 3x3 (1 in, 16 out)
-	float* conv1_out = new float[KWS_FRAMES * KWS_NUM_MFCC * 16]();  // Heap alloc
-	for (int t = 0; t < KWS_FRAMES; ++t) {
-		for (int f = 0; f < KWS_NUM_MFCC; ++f) {
-			for (int oc = 0; oc < 16; ++oc) {
-				float sum = 0;
-				for (int kt = -1; kt <= 1; ++kt) {
-					for (int kf = -1; kf <= 1; ++kf) {
-						int it = t + kt, ic = f + kf;
-						if (it >= 0 && it < KWS_FRAMES && ic >= 0 && ic < KWS_NUM_MFCC) {
-							sum += input[it][ic] * conv1_weights[kt + 1][kf + 1][0][oc];
-						}
-					}
-				}
-				conv1_out[(t * KWS_NUM_MFCC + f) * 16 + oc] = (sum > 0) ? sum : 0;  // ReLU
-			}
-		}
-	}
-	// BatchNorm for Conv1
-	for (int t = 0; t < KWS_FRAMES; ++t) for (int f = 0; f < KWS_NUM_MFCC; ++f)
-		for (int c = 0; c < 16; ++c) {
-			float x = conv1_out[(t * KWS_NUM_MFCC + f) * 16 + c];
-			float norm = (x - conv1_mean[c]) / sqrtf(conv1_var[c] + 1e-5f);
-			conv1_out[(t * KWS_NUM_MFCC + f) * 16 + c] = norm * conv1_gamma[c] + conv1_beta[c];
-		}
-
-	// Pointwise Conv 1x1 (16 in, 24 out)
-	float* conv2_out = new float[KWS_FRAMES * KWS_NUM_MFCC * 24]();  // Heap alloc
-	for (int t = 0; t < KWS_FRAMES; ++t) {
-		for (int f = 0; f < KWS_NUM_MFCC; ++f) {
-			for (int oc = 0; oc < 24; ++oc) {
-				float sum = 0;
-				for (int ic = 0; ic < 16; ++ic) {
-					sum += conv1_out[(t * KWS_NUM_MFCC + f) * 16 + ic] * conv2_weights[0][0][ic][oc];
-				}
-				conv2_out[(t * KWS_NUM_MFCC + f) * 24 + oc] = (sum > 0) ? sum : 0;  // ReLU
-			}
-		}
-	}
-	// BatchNorm for Conv2
-	for (int t = 0; t < KWS_FRAMES; ++t) for (int f = 0; f < KWS_NUM_MFCC; ++f)
-		for (int c = 0; c < 24; ++c) {
-			float x = conv2_out[(t * KWS_NUM_MFCC + f) * 24 + c];
-			float norm = (x - conv2_mean[c]) / sqrtf(conv2_var[c] + 1e-5f);
-			conv2_out[(t * KWS_NUM_MFCC + f) * 24 + c] = norm * conv2_gamma[c] + conv2_beta[c];
-		}
+	finish_(gap, probs, logits);
+}
 
-	// Global Average Pooling
-	float gap[24] = {0};
-	for (int oc = 0; oc < 24; ++oc) {
-		for (int t = 0; t < KWS_FRAMES; ++t) {
-			for (int f = 0; f < KWS_NUM_MFCC; ++f) {
-				gap[oc] += conv2_out[(t * KWS_NUM_MFCC + f) * 24 + oc];
-			}
-		}
-		gap[oc] /= (KWS_FRAMES * KWS_NUM_MFCC);
-	}
+void ManualDSCNN::finish_(const float* gap, float* probs, float* logits) {
+	dense_(gap, logits);
+	softmax_(logits, probs);
+}
 
-	// Dense Layer (24 inputs to 3 classes)
+void ManualDSCNN::dense_(const float* gap, float* logits) {
+	// Dense Layer (24 inputs to 3 classes); BN9 is folded into the weights
 	for (int oc = 0; oc < KWS_NUM_CLASSES; ++oc) {
-		float sum = dense_bias[oc];
-		for (int ic = 0; ic < 24; ++ic) {
-			sum += gap[ic] * dense_weights[ic][oc];
-		}
-		logits[oc] = sum;
+		logits[oc] = fp_dense_b[oc] + dspk::dot(gap, &fp_dense_w[oc * kC2], kC2);
 		if (isnan(logits[oc]) || isinf(logits[oc])) logits[oc] = 0.0f;
 	}
+}
 
-	// Softmax
+void ManualDSCNN::softmax_(const float* logits, float* probs) {
 	float max_logit = logits[0];
 	for (int i = 1; i < KWS_NUM_CLASSES; ++i) {
 		if (logits[i] > max_logit) max_logit = logits[i];
@@ -138,22 +65,137 @@ void ManualDSCNN::predict_full(const float* mfcc_flat, float* probs, float* logi
 	for (int i = 0; i < KWS_NUM_CLASSES; ++i) {
 		probs[i] /= (sum_exp > 0 ? sum_exp : 1.0f);
 	}
+}
+
+void ManualDSCNN::column_(const float* windows, int n, int stride, int t, float* sum) const {
+	for (int i = 0; i < n * kC2; ++i) sum[i] = 0.0f;
+	for (int f = 0; f < KWS_NUM_MFCC; ++f) {
+		float c1[kMaxBatch][kC1] = {};
+		for (int kt = -1; kt <= 1; ++kt) {
+			const int it = t + kt;
+			if (it < 0 || it >= KWS_FRAMES) continue;
+			for (int kf = -1; kf <= 1; ++kf) {
+				const int ic = f + kf;
+				if (ic < 0 || ic >= KWS_NUM_MFCC) continue;
+				const float* w = &fp_conv_w[((kt + 1) * 3 + (kf + 1)) * kC1];
+				for (int b = 0; b < n; ++b) {
+					const float x = windows[b * stride + it * KWS_NUM_MFCC + ic];
+					for (int oc = 0; oc < kC1; ++oc) c1[b][oc] += x * w[oc];
+				}
+			}
+		}
+		for (int b = 0; b < n; ++b) {
+			for (int oc = 0; oc < kC1; ++oc) c1[b][oc] = (c1[b][oc] > 0) ? c1[b][oc] : 0;
+		}
+		for (int oc = 0; oc < kC2; ++oc) {
+			const float* w = &fp_pw_w[oc * kC1];
+			for (int b = 0; b < n; ++b) {
+				const float v = fp_pw_b[oc] + dspk::dot(c1[b], w, kC1);
+				if (v > 0) sum[b * kC2 + oc] += v;
+			}
+		}
+	}
+}
+
+void ManualDSCNN::pool_(const float* windows, int n, int stride, float* gap) const {
+	float col[kMaxBatch * kC2];
+	for (int i = 0; i < n * kC2; ++i) gap[i] = 0.0f;
+	for (int t = 0; t < KWS_FRAMES; ++t) {
+		column_(windows, n, stride, t, col);
+		for (int i = 0; i < n * kC2; ++i) gap[i] += col[i];
+	}
+	for (int i = 0; i < n * kC2; ++i) gap[i] /= kPixels;
+}
+
+void ManualDSCNN::predict_batch(const float* windows, int n, float* probs, float* logits, int stride,
+                                float* pooled) {
+	if (!windows || !probs || n < 0) {
+		Serial.println("ERROR: Invalid input to predict_batch");
+		return;
+	}
+	float gap[kMaxBatch * kC2];
+	for (int first = 0; first < n; first += kMaxBatch) {
+		const int m = (n - first < kMaxBatch) ? n - first : kMaxBatch;
+		pool_(&windows[first * stride], m, stride, gap);
+		for (int b = 0; b < m; ++b) {
+			const int k = (first + b) * KWS_NUM_CLASSES;
+			finish_(&gap[b * kC2], &probs[k], logits ? &logits[k] : tensor_(kLogits));
+			if (pooled) memcpy(&pooled[(first + b) * kC2], &gap[b * kC2], kC2 * sizeof(float));
+		}
+	}
+}
+
+void ManualDSCNN::predict_stream(const float* mfcc_flat, uint32_t seq, float* probs, float* logits) {
+	if (!mfcc_flat || !probs) {
+		Serial.println("ERROR: Invalid input to predict_stream");
+		return;
+	}
+	if (!logits) logits = tensor_(kLogits);
+	// Window row t is absolute row seq - KWS_FRAMES + t, kept in slot
+	// (seq + t) % KWS_FRAMES, so a leaving row and the row replacing it share
+	// a slot.
+	const uint32_t step = seq - stream_seq_;
+	float col[kC2];
 
-	delete[] conv1_out;
-	delete[] conv2_out;
+	if (!stream_primed_ || step == 0 || step > (uint32_t)kMaxStreamStep) {
+		for (int oc = 0; oc < kC2; ++oc) run_sum_[oc] = 0.0f;
+		for (int t = 0; t < KWS_FRAMES; ++t) {
+			float* slot = col_sum_[(seq + t) % KWS_FRAMES];
+			column_(mfcc_flat, 1, kWindow, t, slot);
+			for (int oc = 0; oc < kC2; ++oc) run_sum_[oc] += slot[oc];
+		}
+		stream_columns_ = KWS_FRAMES;
+		stream_steps_ = 0;
+		stream_primed_ = true;
+	} else {
+		// Rows that left the window.
+		for (uint32_t t = 0; t < step; ++t) {
+			const float* slot = col_sum_[(stream_seq_ + t) % KWS_FRAMES];
+			for (int oc = 0; oc < kC2; ++oc) run_sum_[oc] -= slot[oc];
+		}
+		// Edge rows whose padding changed: the new oldest and the old newest.
+		const int edges[2] = { 0, KWS_FRAMES - 1 - (int)step };
+		for (int e = 0; e < 2; ++e) {
+			float* slot = col_sum_[(seq + edges[e]) % KWS_FRAMES];
+			column_(mfcc_flat, 1, kWindow, edges[e], col);
+			for (int oc = 0; oc < kC2; ++oc) {
+				run_sum_[oc] += col[oc] - slot[oc];
+				slot[oc] = col[oc];
+			}
+		}
+		// New rows.
+		for (int t = KWS_FRAMES - (int)step; t < KWS_FRAMES; ++t) {
+			float* slot = col_sum_[(seq + t) % KWS_FRAMES];
+			column_(mfcc_flat, 1, kWindow, t, slot);
+			for (int oc = 0; oc < kC2; ++oc) run_sum_[oc] += slot[oc];
+		}
+		stream_columns_ = step + 2;
+		stream_steps_ += step;
+		if (stream_steps_ >= (uint32_t)KWS_FRAMES) {
+			for (int oc = 0; oc < kC2; ++oc) run_sum_[oc] = 0.0f;
+			for (int t = 0; t < KWS_FRAMES; ++t) {
+				for (int oc = 0; oc < kC2; ++oc) run_sum_[oc] += col_sum_[t][oc];
+			}
+			stream_steps_ = 0;
+		}
+	}
+	stream_seq_ = seq;
 
-	if (logits != probs) delete[] logits;
+	float* gap = tensor_(kGap);
+	for (int oc = 0; oc < kC2; ++oc) gap[oc] = run_sum_[oc] / kPixels;
+	finish_(gap, probs, logits);
+}
+
+float ManualDSCNN::predict_proba_stream(const float* mfcc_flat, uint32_t seq) {
+	float probs[KWS_NUM_CLASSES];
+	predict_stream(mfcc_flat, seq, probs, nullptr);
+	const float p = probs[WAKE_CLASS_INDEX];
+	return (isnan(p) || isinf(p)) ? 0.0f : p;
 }
 
 float ManualDSCNN::predict_proba(const float* mfcc_flat) {
 	float probs[KWS_NUM_CLASSES];
 	predict_full(mfcc_flat, probs, nullptr);
-	for (int i = 0; i < KWS_NUM_CLASSES; ++i) {
-		if (isnan(probs[i]) || isinf(probs[i])) probs[i] = 0.0f;
-	}
-	float max_p = 0.0f;
-	for (int i = 0; i < KWS_NUM_CLASSES; ++i) {
-		if (probs[i] > max_p) max_p = probs[i];
-	}
-	return max_p;
+	const float p = probs[WAKE_CLASS_INDEX];
+	return (isnan(p) || isinf(p)) ? 0.0f : p;
 }
\ No newline at end of file
@@ -3,38 +3,99 @@
 
 #include <stdint.h>
 #include "frontend_params.h"
+#include "ArenaPlan.h"
 
+// Activation arena limit in bytes; the build fails if the plan exceeds it.
+#ifndef MANUALDSCNN_ARENA_BUDGET
+#define MANUALDSCNN_ARENA_BUDGET (112 * 1024)
+#endif
+// Windows predict_batch() runs through each layer together.
+#ifndef MANUALDSCNN_MAX_BATCH
+#define MANUALDSCNN_MAX_BATCH 8
+#endif
+
+// Float conv -> pointwise -> GAP -> dense network. Weights come from
+// models/model_float_packed.h (tools/model_compiler.py) with every BatchNorm
+// already folded in, so nothing is loaded or normalized at run time.
 class ManualDSCNN {
 public:
 	ManualDSCNN();
 	bool begin();
 	void predict_full(const float* mfcc_flat, float* probs, float* logits = nullptr);
+	// The wake class's probability, probs[WAKE_CLASS_INDEX]; 0 if not finite.
 	float predict_proba(const float* mfcc_flat);
 
+	// n windows, `stride` floats apart (KWS_NUM_MFCC for consecutive
+	// overlapping windows of one feature stream). probs/logits are n x
+	// KWS_NUM_CLASSES, pooled (optional) n x kPooled. Each weight is loaded
+	// once per group of up to kMaxBatch windows; results are bit-identical
+	// to predict_full().
+	void predict_batch(const float* windows, int n, float* probs, float* logits = nullptr,
+	                   int stride = kWindow, float* pooled = nullptr);
+
+	// Global-average-pooled features of the last predict_full() or
+	// predict_stream(), kPooled wide.
+	const float* lastPooled() const { return &arena_[kPlan.offset[kGap]]; }
+
+	// Streaming mode for a window that slides by whole rows. `seq` is the
+	// number of rows published when the window was taken (FeatureWindow::seq).
+	// Only the columns the slide changed are recomputed: the new rows, the
+	// previous newest row (it gains a right neighbour) and the new oldest row
+	// (it loses its left one). The pooled sum is kept running. A gap of more
+	// than kMaxStreamStep rows, or a reset, falls back to a full pass.
+	void predict_stream(const float* mfcc_flat, uint32_t seq, float* probs, float* logits = nullptr);
+	float predict_proba_stream(const float* mfcc_flat, uint32_t seq);
+	void reset_stream() { stream_primed_ = false; }
+	uint32_t streamColumns() const { return stream_columns_; }	// columns computed by the last call
+
+	static const int kMaxStreamStep = KWS_FRAMES - 3;
+	static const int kWindow = KWS_FRAMES * KWS_NUM_MFCC;
+	static const int kMaxBatch = MANUALDSCNN_MAX_BATCH;
+	static const int kPooled = 24;
+
 private:
-	// Conv1: Depthwise 3x3x1x16
-	float conv1_weights[3][3][1][16];
-	float conv1_gamma[16];  // batch_normalization_7_gamma
-	float conv1_beta[16];   // batch_normalization_7_beta
-	float conv1_mean[16];   // batch_normalization_7_mean
-	float conv1_var[16];    // batch_normalization_7_var
-	float conv1_gamma_post[16];  // batch_normalization_8_gamma
-	float conv1_beta_post[16];   // batch_normalization_8_beta
-	float conv1_mean_post[16];   // batch_normalization_8_mean
-	float conv1_var_post[16];    // batch_normalization_8_var
-	// Conv2: Pointwise 1x1x16x24
-	float conv2_weights[1][1][16][24];
-	float conv2_gamma[24];  // batch_normalization_9_gamma
-	float conv2_beta[24];   // batch_normalization_9_beta
-	float conv2_mean[24];   // batch_normalization_9_mean
-	float conv2_var[24];    // batch_normalization_9_var
-	float conv2_gamma_post[24];  // batch_normalization_10_gamma
-	float conv2_beta_post[24];   // batch_normalization_10_beta
-	float conv2_mean_post[24];   // batch_normalization_10_mean
-	float conv2_var_post[24];    // batch_normalization_10_var
-	// Dense (24 inputs to 3 classes)
-	float dense_weights[24][3];  // Stubbed dense_1_w
-	float dense_bias[3];         // dense_1_b
+	static const int kPixels = KWS_FRAMES * KWS_NUM_MFCC;
+	static const int kC1 = 16;
+	static const int kC2 = kPooled;
+
+	// Activations, lifetimes in layer steps: 0 fused conv/pointwise/GAP,
+	// 1 dense, 2 softmax. The input is read in place from the caller, and the
+	// conv and pointwise outputs never leave column_(). predict_batch() keeps
+	// its pooled vectors on the stack.
+	enum Tensor { kGap, kLogits, kNumTensors };
+	static constexpr TensorLife kTensors[kNumTensors] = {
+		{ kC2, 0, 1 },
+		{ KWS_NUM_CLASSES, 1, 2 },
+	};
+	static constexpr ArenaPlan<kNumTensors> kPlan = ArenaPlan<kNumTensors>(kTensors);
+	static_assert(kPlan.peak * sizeof(float) <= MANUALDSCNN_ARENA_BUDGET,
+	              "ManualDSCNN activation plan exceeds MANUALDSCNN_ARENA_BUDGET");
+
+	float arena_[kPlan.peak];
+	float* tensor_(Tensor t) { return &arena_[kPlan.offset[t]]; }
+
+	// Streaming state: the pooled contribution of every row in the window,
+	// slotted by absolute row number, and their running sum. The sum is
+	// rebuilt from the slots every KWS_FRAMES steps so rounding cannot drift.
+	float col_sum_[KWS_FRAMES][kC2];
+	float run_sum_[kC2];
+	uint32_t stream_seq_ = 0;
+	uint32_t stream_steps_ = 0;
+	uint32_t stream_columns_ = 0;
+	bool stream_primed_ = false;
+
+	// conv + ReLU + pointwise + ReLU for row t of n windows, summed over
+	// frequency into sum[n][kC2]. Every window takes the same arithmetic
+	// path whatever n is, which keeps batched results bit-identical.
+	void column_(const float* windows, int n, int stride, int t, float* sum) const;
+	// Global average pool of n windows into gap[n][kC2].
+	void pool_(const float* windows, int n, int stride, float* gap) const;
+	// Dense (BN folded) then softmax, for one pooled vector.
+	void finish_(const float* gap, float* probs, float* logits);
+	static void dense_(const float* gap, float* logits);
+	static void softmax_(const float* logits, float* probs);
+
+	friend class KwsBench;
 };
 
 #endif
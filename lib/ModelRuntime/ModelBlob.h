@@ -0,0 +1,82 @@
+#pragma once
+#include <stdint.h>
+
+// On-disk layout of a KWSM model blob (tools/model_blob.py writes them).
+// Everything is little-endian and every array starts on a kBlobAlign
+// boundary, so the runtime reads weights in place from flash, a partition
+// or an mmap'd file.
+//
+//   BlobHeader | BlobLayer[layer_count] | weights, biases, quant arrays...
+//
+// Offsets are bytes from the start of the blob; 0 means "absent". The CRC
+// covers everything after the header.
+
+static const uint32_t kBlobMagic = 0x4D53574B;	// "KWSM"
+static const uint16_t kBlobVersion = 1;
+static const uint32_t kBlobAlign = 16;
+
+enum BlobOp : uint8_t {
+	kOpConv2D = 1,		// kh x kw, stride 1, SAME. w: [oc][kh][kw][ic]
+	kOpDepthwise = 2,	// kh x kw, multiplier 1, stride 1, SAME. w: [kh][kw][c]
+	kOpPointwise = 3,	// 1x1. w: [oc][ic]
+	kOpBatchNorm = 4,	// float only: y = x * weights[c] + bias[c] (scale/shift precomputed)
+	kOpReLU = 5,		// float only; int8 layers clamp through their quant range
+	kOpAvgPool = 6,		// kh x kw window, stride_h x stride_w, SAME (pads at the end)
+	kOpGlobalAvgPool = 7,
+	kOpDense = 8,		// w: [oc][ic]
+	kOpSoftmax = 9,		// float output; int8 input is dequantized first
+};
+
+enum BlobType : uint8_t { kTypeF32 = 0, kTypeI8 = 1 };
+enum BlobAct : uint8_t { kActNone = 0, kActReLU = 1, kActReLU6 = 2 };	// fused, float layers
+
+// Int8 layers: out = clamp(MultiplyByQuantizedMultiplier(acc, mult[c], shift[c])
+// + out_zp, act_min, act_max), one mult/shift entry per output channel or a
+// single one for per-tensor layers. Pointwise biases already include
+// -in_zp * sum(w[oc]).
+struct BlobQuant {
+	int32_t		in_zp;
+	int32_t		out_zp;
+	int32_t		act_min;
+	int32_t		act_max;
+	float		in_scale;	// softmax: dequantizes its int8 input
+	uint32_t	mult;		// int32_t[channels]
+	uint32_t	shift;		// int8_t[channels]
+	uint16_t	channels;
+	uint16_t	reserved;
+};
+
+struct BlobLayer {
+	uint8_t		op;			// BlobOp
+	uint8_t		type;		// BlobType of the activations
+	uint8_t		act;		// BlobAct
+	uint8_t		kernel_h;
+	uint8_t		kernel_w;
+	uint8_t		stride_h;
+	uint8_t		stride_w;
+	uint8_t		reserved;
+	uint16_t	in_h, in_w, in_c;
+	uint16_t	out_h, out_w, out_c;
+	uint32_t	weights;	// float or int8, layout per BlobOp
+	uint32_t	bias;		// float, or int32 for int8 layers
+	uint32_t	quant;		// BlobQuant, int8 layers only
+};
+
+struct BlobHeader {
+	uint32_t	magic;
+	uint16_t	version;
+	uint16_t	layer_count;
+	uint32_t	total_size;
+	uint32_t	crc32;		// CRC-32 (IEEE) of bytes [sizeof(BlobHeader), total_size)
+	uint16_t	in_h, in_w, in_c;
+	uint8_t		in_type;	// BlobType the first layer expects
+	uint8_t		reserved;
+	float		in_scale;	// int8 input quantization
+	int32_t		in_zp;
+	uint32_t	layers;		// BlobLayer[layer_count]
+	char		name[28];
+};
+
+static_assert(sizeof(BlobQuant) == 32, "BlobQuant layout");
+static_assert(sizeof(BlobLayer) == 32, "BlobLayer layout");
+static_assert(sizeof(BlobHeader) == 64, "BlobHeader layout");
@@ -0,0 +1,450 @@
+#include "ModelRuntime.h"
+#include <Arduino.h>
+#include <math.h>
+#include <string.h>
+#include "env.h"
+#include "DSPKernels.h"
+#include "Int8Kernels.h"
+#ifndef ARDUINO
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+// ---------------------------------------------------------------- float kernels
+
+static inline float activate_(float v, uint8_t act) {
+	if (act == kActNone) return v;
+	if (v < 0.0f) return 0.0f;
+	return (act == kActReLU6 && v > 6.0f) ? 6.0f : v;
+}
+
+// SAME padding as TensorFlow: whatever does not divide evenly goes at the end.
+static inline int padBefore_(int in, int out, int k, int s) {
+	const int total = (out - 1) * s + k - in;
+	return total > 0 ? total / 2 : 0;
+}
+
+static void conv2dF32_(const BlobLayer& l, const float* in, const float* w, const float* bias, float* out) {
+	const int ph = l.kernel_h / 2, pw = l.kernel_w / 2;
+	for (int y = 0; y < l.out_h; ++y) {
+		for (int x = 0; x < l.out_w; ++x) {
+			float* o = &out[(y * l.out_w + x) * l.out_c];
+			for (int k = 0; k < l.out_c; ++k) {
+				float acc = bias ? bias[k] : 0.0f;
+				for (int ky = 0; ky < l.kernel_h; ++ky) {
+					const int iy = y + ky - ph;
+					if (iy < 0 || iy >= l.in_h) continue;
+					for (int kx = 0; kx < l.kernel_w; ++kx) {
+						const int ix = x + kx - pw;
+						if (ix < 0 || ix >= l.in_w) continue;
+						acc += dspk::dot(&in[(iy * l.in_w + ix) * l.in_c],
+						                 &w[((k * l.kernel_h + ky) * l.kernel_w + kx) * l.in_c], l.in_c);
+					}
+				}
+				o[k] = activate_(acc, l.act);
+			}
+		}
+	}
+}
+
+static void depthwiseF32_(const BlobLayer& l, const float* in, const float* w, const float* bias, float* out) {
+	const int ph = l.kernel_h / 2, pw = l.kernel_w / 2, c = l.in_c;
+	for (int y = 0; y < l.out_h; ++y) {
+		for (int x = 0; x < l.out_w; ++x) {
+			float* o = &out[(y * l.out_w + x) * c];
+			for (int ch = 0; ch < c; ++ch) o[ch] = bias ? bias[ch] : 0.0f;
+			for (int ky = 0; ky < l.kernel_h; ++ky) {
+				const int iy = y + ky - ph;
+				if (iy < 0 || iy >= l.in_h) continue;
+				for (int kx = 0; kx < l.kernel_w; ++kx) {
+					const int ix = x + kx - pw;
+					if (ix < 0 || ix >= l.in_w) continue;
+					const float* px = &in[(iy * l.in_w + ix) * c];
+					const float* wk = &w[(ky * l.kernel_w + kx) * c];
+					for (int ch = 0; ch < c; ++ch) o[ch] += px[ch] * wk[ch];
+				}
+			}
+			for (int ch = 0; ch < c; ++ch) o[ch] = activate_(o[ch], l.act);
+		}
+	}
+}
+
+// Pointwise and dense are the same [oc][ic] product over `pixels` rows.
+static void matmulF32_(const BlobLayer& l, int pixels, int ic, const float* in, const float* w,
+                       const float* bias, float* out) {
+	for (int p = 0; p < pixels; ++p) {
+		const float* px = &in[p * ic];
+		float* o = &out[p * l.out_c];
+		for (int k = 0; k < l.out_c; ++k) {
+			o[k] = activate_((bias ? bias[k] : 0.0f) + dspk::dot(px, &w[k * ic], ic), l.act);
+		}
+	}
+}
+
+static void avgPoolF32_(const BlobLayer& l, const float* in, float* out) {
+	const int c = l.in_c;
+	const int py = padBefore_(l.in_h, l.out_h, l.kernel_h, l.stride_h);
+	const int px = padBefore_(l.in_w, l.out_w, l.kernel_w, l.stride_w);
+	for (int y = 0; y < l.out_h; ++y) {
+		for (int x = 0; x < l.out_w; ++x) {
+			float* o = &out[(y * l.out_w + x) * c];
+			int count = 0;
+			for (int ch = 0; ch < c; ++ch) o[ch] = 0.0f;
+			for (int ky = 0; ky < l.kernel_h; ++ky) {
+				const int iy = y * l.stride_h + ky - py;
+				if (iy < 0 || iy >= l.in_h) continue;
+				for (int kx = 0; kx < l.kernel_w; ++kx) {
+					const int ix = x * l.stride_w + kx - px;
+					if (ix < 0 || ix >= l.in_w) continue;
+					const float* p = &in[(iy * l.in_w + ix) * c];
+					for (int ch = 0; ch < c; ++ch) o[ch] += p[ch];
+					++count;
+				}
+			}
+			for (int ch = 0; ch < c; ++ch) o[ch] /= count;	// padding is not counted
+		}
+	}
+}
+
+static void softmax_(const float* logits, int n, float* probs) {
+	float max_logit = logits[0];
+	for (int i = 1; i < n; ++i) {
+		if (logits[i] > max_logit) max_logit = logits[i];
+	}
+	float sum_exp = 0.0f;
+	for (int i = 0; i < n; ++i) {
+		probs[i] = expf(logits[i] - max_logit);
+		sum_exp += probs[i];
+	}
+	for (int i = 0; i < n; ++i) probs[i] /= (sum_exp > 0 ? sum_exp : 1.0f);
+}
+
+// ---------------------------------------------------------------- loading
+
+static size_t alignedBytes_(int elements, uint8_t type) {
+	const size_t bytes = (size_t)elements * (type == kTypeI8 ? 1 : 4);
+	return (bytes + kBlobAlign - 1) & ~(size_t)(kBlobAlign - 1);
+}
+
+// Arena bytes of a layer's output; softmax writes the caller's probs.
+static size_t outBytes_(const BlobLayer& l) {
+	return l.op == kOpSoftmax ? 0 : alignedBytes_(l.out_h * l.out_w * l.out_c, l.type);
+}
+
+ModelRuntime::ModelRuntime() {}
+
+ModelRuntime::~ModelRuntime() {
+	unload();
+}
+
+uint32_t ModelRuntime::crc32(const uint8_t* data, size_t n, uint32_t crc) {
+	// Nibble table: small enough for IRAM-less builds, fast enough for a load-time check.
+	static const uint32_t kTable[16] = {
+		0x00000000, 0x1DB71064, 0x3B6E20C8, 0x26D930AC, 0x76DC4190, 0x6B6B51F4, 0x4DB26158, 0x5005713C,
+		0xEDB88320, 0xF00F9344, 0xD6D6A3E8, 0xCB61B38C, 0x9B64C2B0, 0x86D3D2D4, 0xA00AE278, 0xBDBDF21C,
+	};
+	crc = ~crc;
+	for (size_t i = 0; i < n; ++i) {
+		crc = kTable[(crc ^ data[i]) & 0x0F] ^ (crc >> 4);
+		crc = kTable[(crc ^ (data[i] >> 4)) & 0x0F] ^ (crc >> 4);
+	}
+	return ~crc;
+}
+
+bool ModelRuntime::fail_(const char* why) {
+	error_ = why;
+	hdr_ = nullptr;
+	layers_ = nullptr;
+	Serial.printf("ERROR: ModelRuntime: %s\n", why);
+	return false;
+}
+
+bool ModelRuntime::inRange_(uint32_t offset, size_t bytes) const {
+	return offset >= sizeof(BlobHeader) && offset % 4 == 0 && offset <= size_ && bytes <= size_ - offset;
+}
+
+bool ModelRuntime::checkLayer_(int i, const BlobLayer& l) {
+	const bool q = l.type == kTypeI8;
+	const size_t esize = q ? 1 : 4;
+	const int in_px = l.in_h * l.in_w;
+	const bool same_hw = l.out_h == l.in_h && l.out_w == l.in_w;
+	size_t wbytes = 0, bbytes = 0;
+
+	if (l.type != hdr_->in_type) return fail_("mixed activation types");
+	if (i == 0 ? (l.in_h != hdr_->in_h || l.in_w != hdr_->in_w || l.in_c != hdr_->in_c)
+	           : (l.in_h != layers_[i - 1].out_h || l.in_w != layers_[i - 1].out_w || l.in_c != layers_[i - 1].out_c))
+		return fail_("layer input does not match the previous output");
+	if ((l.op == kOpSoftmax) != (i == hdr_->layer_count - 1)) return fail_("softmax must be the last layer");
+
+	switch (l.op) {
+	case kOpConv2D:
+		if (!same_hw || l.kernel_h % 2 == 0 || l.kernel_w % 2 == 0) return fail_("conv: odd kernel, stride 1, SAME only");
+		if (q && (l.kernel_h != 3 || l.kernel_w != 3 || l.in_c != 1)) return fail_("int8 conv: 3x3 with one input channel only");
+		wbytes = (size_t)l.out_c * l.kernel_h * l.kernel_w * l.in_c * esize;
+		bbytes = (size_t)l.out_c * 4;
+		break;
+	case kOpDepthwise:
+		if (!same_hw || l.out_c != l.in_c || l.kernel_h % 2 == 0 || l.kernel_w % 2 == 0) return fail_("depthwise: odd kernel, stride 1, SAME only");
+		if (q && (l.kernel_h != 3 || l.kernel_w != 3 || l.in_c > q8::kMaxChannels)) return fail_("int8 depthwise: 3x3, <= 64 channels");
+		wbytes = (size_t)l.kernel_h * l.kernel_w * l.in_c * esize;
+		bbytes = (size_t)l.out_c * 4;
+		break;
+	case kOpPointwise:
+		if (!same_hw) return fail_("pointwise: shape");
+		wbytes = (size_t)l.out_c * l.in_c * esize;
+		bbytes = (size_t)l.out_c * 4;
+		break;
+	case kOpBatchNorm:
+	case kOpReLU:
+		if (q) return fail_("int8 BatchNorm/ReLU must be folded into the quantization");
+		if (!same_hw || l.out_c != l.in_c) return fail_("elementwise: shape");
+		if (l.op == kOpBatchNorm) {
+			if (!l.weights || !l.bias) return fail_("batchnorm: needs scale and shift");
+			wbytes = bbytes = (size_t)l.in_c * 4;
+		}
+		break;
+	case kOpAvgPool:
+		if (!l.stride_h || !l.stride_w || l.out_c != l.in_c ||
+		    l.out_h != (l.in_h + l.stride_h - 1) / l.stride_h || l.out_w != (l.in_w + l.stride_w - 1) / l.stride_w)
+			return fail_("avgpool: shape");
+		if (q && (l.kernel_h != 2 || l.kernel_w != 1 || l.stride_h != 2 || l.stride_w != 1)) return fail_("int8 avgpool: 2x1 stride 2x1 only");
+		break;
+	case kOpGlobalAvgPool:
+		if (l.out_h != 1 || l.out_w != 1 || l.out_c != l.in_c) return fail_("gap: shape");
+		if (q && l.in_c > q8::kMaxChannels) return fail_("int8 gap: <= 64 channels");
+		break;
+	case kOpDense:
+		if (l.out_h != 1 || l.out_w != 1) return fail_("dense: shape");
+		wbytes = (size_t)l.out_c * in_px * l.in_c * esize;
+		bbytes = (size_t)l.out_c * 4;
+		break;
+	case kOpSoftmax:
+		if (in_px != 1 || !same_hw || l.out_c != l.in_c || l.in_c > kMaxClasses) return fail_("softmax: expects 1x1xN, N <= 64");
+		break;
+	default:
+		return fail_("unknown op");
+	}
+
+	if (wbytes && !inRange_(l.weights, wbytes)) return fail_("weights out of range");
+	if (l.bias && !inRange_(l.bias, bbytes)) return fail_("bias out of range");
+	if (q && l.op != kOpAvgPool) {
+		if (l.op != kOpSoftmax && !l.bias && l.op != kOpGlobalAvgPool) return fail_("int8 layer without bias");
+		if (!inRange_(l.quant, sizeof(BlobQuant))) return fail_("int8 layer without quantization");
+		const BlobQuant& qt = *at_<BlobQuant>(l.quant);
+		if (l.op == kOpGlobalAvgPool || l.op == kOpDense) {
+			// q8::mean() and q8::fullyConnected() requantize per tensor.
+			if (qt.channels != 1) return fail_("int8 gap/dense: per-tensor quant only");
+		} else if (l.op != kOpSoftmax && qt.channels != l.out_c) {
+			return fail_("quant channel count");
+		}
+		if (l.op != kOpSoftmax) {
+			if (!inRange_(qt.mult, (size_t)qt.channels * 4) || !inRange_(qt.shift, qt.channels)) return fail_("quant arrays out of range");
+		}
+	}
+	return true;
+}
+
+bool ModelRuntime::load(const uint8_t* blob, size_t size) {
+	hdr_ = nullptr;
+	blob_ = blob;
+	size_ = size;
+	if (!blob || size < sizeof(BlobHeader) || ((uintptr_t)blob & 3)) return fail_("blob missing, short or misaligned");
+	const BlobHeader* h = reinterpret_cast<const BlobHeader*>(blob);
+	if (h->magic != kBlobMagic) return fail_("bad magic");
+	if (h->version != kBlobVersion) return fail_("unsupported version");
+	if (h->total_size > size || h->total_size < sizeof(BlobHeader)) return fail_("truncated blob");
+	size_ = h->total_size;
+	if (crc32(blob + sizeof(BlobHeader), size_ - sizeof(BlobHeader)) != h->crc32) return fail_("CRC mismatch");
+	if (h->layer_count == 0 || h->layer_count > MODELRUNTIME_MAX_LAYERS) return fail_("layer count");
+	if (h->in_type != kTypeF32 && h->in_type != kTypeI8) return fail_("input type");
+	if (!inRange_(h->layers, (size_t)h->layer_count * sizeof(BlobLayer))) return fail_("layer table out of range");
+
+	hdr_ = h;
+	layers_ = at_<BlobLayer>(h->layers);
+	// Only a layer's input and output are live while it runs, so the arena
+	// has to hold the largest such pair, not twice the largest tensor.
+	size_t in = alignedBytes_(h->in_h * h->in_w * h->in_c, h->in_type);	// quantized / converted input
+	size_t peak = in;
+	for (int i = 0; i < h->layer_count; ++i) {
+		const BlobLayer& l = layers_[i];
+		if (!checkLayer_(i, l)) return false;
+		const size_t out = outBytes_(l);
+		if (in + out > peak) peak = in + out;
+		in = out;
+	}
+	if (peak > sizeof(arena_)) return fail_("activations exceed MODELRUNTIME_ARENA_BUDGET");
+	peak_ = peak;
+	classes_ = layers_[h->layer_count - 1].out_c;
+	error_ = nullptr;
+	return true;
+}
+
+#ifndef ARDUINO
+bool ModelRuntime::loadFile(const char* path) {
+	unload();
+	const int fd = open(path, O_RDONLY);
+	if (fd < 0) return fail_("cannot open blob file");
+	struct stat st;
+	if (fstat(fd, &st) != 0 || st.st_size < (off_t)sizeof(BlobHeader)) {
+		close(fd);
+		return fail_("cannot stat blob file");
+	}
+	void* map = mmap(nullptr, (size_t)st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+	close(fd);
+	if (map == MAP_FAILED) return fail_("mmap failed");
+	map_ = map;
+	map_size_ = (size_t)st.st_size;
+	return load(static_cast<const uint8_t*>(map), map_size_);
+}
+#endif
+
+void ModelRuntime::unload() {
+	hdr_ = nullptr;
+	layers_ = nullptr;
+	blob_ = nullptr;
+	error_ = "not loaded";
+#ifndef ARDUINO
+	if (map_) munmap(map_, map_size_);
+#endif
+	map_ = nullptr;
+	map_size_ = 0;
+}
+
+bool ModelRuntime::begin() {
+	Serial.println("DEBUG: ModelRuntime begin");
+	if (!hdr_) {
+		Serial.printf("ERROR: ModelRuntime: no model (%s)\n", error_);
+		return false;
+	}
+	Serial.printf("DEBUG: ModelRuntime '%.*s': %u layers, %s, %u-byte blob, arena %u of %u bytes\n",
+	              (int)sizeof(hdr_->name), hdr_->name, (unsigned)hdr_->layer_count,
+	              hdr_->in_type == kTypeI8 ? "int8" : "float", (unsigned)size_,
+	              (unsigned)arenaBytes(), (unsigned)sizeof(arena_));
+	Serial.flush();
+	return true;
+}
+
+// ---------------------------------------------------------------- execution
+
+void ModelRuntime::run_(const void* input, float* probs, float* logits) {
+	// The input (converted at the bottom of the arena, or the caller's) and
+	// every second output sit at the bottom, the others against the top.
+	const void* src = input;
+
+	for (int i = 0; i < hdr_->layer_count; ++i) {
+		const BlobLayer& l = layers_[i];
+		void* dst = (l.op == kOpSoftmax) ? (void*)probs
+		          : (i & 1) ? (void*)arena_ : (void*)(arena_ + peak_ - outBytes_(l));
+		const int pixels = l.in_h * l.in_w;
+
+		if (l.type == kTypeF32) {
+			const float* in = static_cast<const float*>(src);
+			float* out = static_cast<float*>(dst);
+			const float* w = l.weights ? at_<float>(l.weights) : nullptr;
+			const float* b = l.bias ? at_<float>(l.bias) : nullptr;
+			switch (l.op) {
+			case kOpConv2D:		conv2dF32_(l, in, w, b, out); break;
+			case kOpDepthwise:	depthwiseF32_(l, in, w, b, out); break;
+			case kOpPointwise:	matmulF32_(l, pixels, l.in_c, in, w, b, out); break;
+			case kOpDense:		matmulF32_(l, 1, pixels * l.in_c, in, w, b, out); break;
+			case kOpBatchNorm:
+				for (int p = 0; p < pixels; ++p) {
+					for (int c = 0; c < l.in_c; ++c) out[p * l.in_c + c] = activate_(in[p * l.in_c + c] * w[c] + b[c], l.act);
+				}
+				break;
+			case kOpReLU:
+				for (int k = 0; k < pixels * l.in_c; ++k) out[k] = activate_(in[k], l.act == kActNone ? (uint8_t)kActReLU : l.act);
+				break;
+			case kOpAvgPool:	avgPoolF32_(l, in, out); break;
+			case kOpGlobalAvgPool:
+				for (int c = 0; c < l.in_c; ++c) out[c] = 0.0f;
+				for (int p = 0; p < pixels; ++p) {
+					for (int c = 0; c < l.in_c; ++c) out[c] += in[p * l.in_c + c];
+				}
+				for (int c = 0; c < l.in_c; ++c) out[c] /= pixels;
+				break;
+			case kOpSoftmax:
+				if (logits) memcpy(logits, in, l.in_c * sizeof(float));
+				softmax_(in, l.in_c, probs);
+				break;
+			}
+		} else {
+			const int8_t* in = static_cast<const int8_t*>(src);
+			int8_t* out = static_cast<int8_t*>(dst);
+			const int8_t* w = l.weights ? at_<int8_t>(l.weights) : nullptr;
+			const int32_t* b = l.bias ? at_<int32_t>(l.bias) : nullptr;
+			const BlobQuant* qt = l.quant ? at_<BlobQuant>(l.quant) : nullptr;
+			q8::Requant rq = {};
+			if (qt && l.op != kOpSoftmax) rq = q8::Requant{ at_<int32_t>(qt->mult), at_<int8_t>(qt->shift), qt->out_zp, qt->act_min, qt->act_max };
+			switch (l.op) {
+			case kOpConv2D:		q8::conv3x3In1(in, l.in_h, l.in_w, qt->in_zp, w, b, l.out_c, rq, out); break;
+			case kOpDepthwise:	q8::depthwise3x3(in, l.in_h, l.in_w, l.in_c, qt->in_zp, w, b, rq, out); break;
+			case kOpPointwise:	q8::pointwise(in, pixels, l.in_c, w, b, l.out_c, rq, out); break;
+			case kOpDense:		q8::fullyConnected(in, pixels * l.in_c, qt->in_zp, w, b, l.out_c, rq, out); break;
+			case kOpAvgPool:	q8::avgPool2x1(in, l.in_h, l.in_w, l.in_c, out); break;
+			case kOpGlobalAvgPool:
+				q8::mean(in, pixels, l.in_c, qt->in_zp, rq.mult[0], rq.shift[0], qt->out_zp, out);
+				break;
+			case kOpSoftmax: {
+				float l_f[kMaxClasses];
+				for (int k = 0; k < l.in_c; ++k) l_f[k] = qt->in_scale * (float)((int32_t)in[k] - qt->in_zp);
+				if (logits) memcpy(logits, l_f, l.in_c * sizeof(float));
+				softmax_(l_f, l.in_c, probs);
+				break;
+			}
+			}
+		}
+		src = dst;
+	}
+}
+
+void ModelRuntime::predict_full(const float* mfcc_flat, float* probs, float* logits) {
+	if (!hdr_ || !mfcc_flat || !probs) {
+		Serial.println("ERROR: Invalid input to ModelRuntime::predict_full");
+		return;
+	}
+	if (hdr_->in_type == kTypeF32) {
+		run_(mfcc_flat, probs, logits);
+		return;
+	}
+	int8_t* in = reinterpret_cast<int8_t*>(arena_);
+	const int n = hdr_->in_h * hdr_->in_w * hdr_->in_c;
+	for (int i = 0; i < n; ++i) {
+		in[i] = q8::clampAct((int32_t)lrintf(mfcc_flat[i] / hdr_->in_scale) + hdr_->in_zp, -128, 127);
+	}
+	run_(in, probs, logits);
+}
+
+void ModelRuntime::predict_full_q(const int8_t* mfcc_q, float* probs, float* logits) {
+	if (!hdr_ || !mfcc_q || !probs) {
+		Serial.println("ERROR: Invalid input to ModelRuntime::predict_full_q");
+		return;
+	}
+	if (hdr_->in_type == kTypeI8) {
+		run_(mfcc_q, probs, logits);
+		return;
+	}
+	float* in = reinterpret_cast<float*>(arena_);
+	const int n = hdr_->in_h * hdr_->in_w * hdr_->in_c;
+	for (int i = 0; i < n; ++i) in[i] = hdr_->in_scale * (float)((int32_t)mfcc_q[i] - hdr_->in_zp);
+	run_(in, probs, logits);
+}
+
+// The wake class's probability; 0 for a model without that class.
+static float wakeProb_(const float* probs, int n) {
+	return WAKE_CLASS_INDEX < n ? probs[WAKE_CLASS_INDEX] : 0.0f;
+}
+
+float ModelRuntime::predict_proba(const float* mfcc_flat) {
+	float probs[kMaxClasses] = {};
+	predict_full(mfcc_flat, probs, nullptr);
+	return wakeProb_(probs, classes_);
+}
+
+float ModelRuntime::predict_proba_q(const int8_t* mfcc_q) {
+	float probs[kMaxClasses] = {};
+	predict_full_q(mfcc_q, probs, nullptr);
+	return wakeProb_(probs, classes_);
+}
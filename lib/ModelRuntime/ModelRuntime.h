@@ -0,0 +1,78 @@
+#ifndef MODELRUNTIME_H
+#define MODELRUNTIME_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include "ModelBlob.h"
+
+// Activation memory limit in bytes. load() rejects a model whose largest
+// layer input plus output does not fit. The default holds the float blob
+// (models/manual_dscnn_f32.kwsm needs 104,000 bytes); a build that only
+// ever loads int8 blobs can lower it.
+#ifndef MODELRUNTIME_ARENA_BUDGET
+#define MODELRUNTIME_ARENA_BUDGET (104 * 1024)
+#endif
+#ifndef MODELRUNTIME_MAX_LAYERS
+#define MODELRUNTIME_MAX_LAYERS 32
+#endif
+
+// Interpreter for KWSM model blobs (ModelBlob.h). The topology, shapes,
+// quantization and weights all come from the blob, so a retrained or wider
+// model ships as data. Weights are read in place; activations alternate
+// between the two ends of a fixed arena. Dispatch is one switch per layer,
+// with the loops inside the kernels.
+//
+// Same prediction interface as ManualDSCNN / Int8DSCNN.
+class ModelRuntime {
+public:
+	ModelRuntime();
+	~ModelRuntime();
+
+	// Validates magic, version, CRC, shape chain, offsets and op support.
+	// The blob must outlive the runtime (flash, partition or mmap).
+	bool load(const uint8_t* blob, size_t size);
+#ifndef ARDUINO
+	// Host: mmap the file read-only and load it.
+	bool loadFile(const char* path);
+#endif
+	void unload();
+	bool loaded() const { return hdr_ != nullptr; }
+	bool begin();
+
+	void predict_full(const float* mfcc_flat, float* probs, float* logits = nullptr);
+	float predict_proba(const float* mfcc_flat);
+	void predict_full_q(const int8_t* mfcc_q, float* probs, float* logits = nullptr);
+	float predict_proba_q(const int8_t* mfcc_q);
+
+	const BlobHeader*	header() const { return hdr_; }
+	int					numClasses() const { return classes_; }
+	size_t				arenaBytes() const { return peak_; }
+	const char*			error() const { return error_; }
+
+	// CRC-32 (IEEE, zlib-compatible); pass the previous result to continue a stream.
+	static uint32_t crc32(const uint8_t* data, size_t n, uint32_t crc = 0);
+	static const int kMaxClasses = 64;
+
+private:
+	const uint8_t*		blob_ = nullptr;
+	size_t				size_ = 0;
+	const BlobHeader*	hdr_ = nullptr;
+	const BlobLayer*	layers_ = nullptr;
+	int					classes_ = 0;
+	size_t				peak_ = 0;		// largest layer input + output
+	const char*			error_ = "not loaded";
+	void*				map_ = nullptr;	// host mmap, unmapped by unload()
+	size_t				map_size_ = 0;
+
+	alignas(16) uint8_t	arena_[MODELRUNTIME_ARENA_BUDGET];
+
+	template <typename T> const T* at_(uint32_t offset) const {
+		return reinterpret_cast<const T*>(blob_ + offset);
+	}
+	bool fail_(const char* why);
+	bool checkLayer_(int i, const BlobLayer& l);
+	bool inRange_(uint32_t offset, size_t bytes) const;
+	void run_(const void* input, float* probs, float* logits);
+};
+
+#endif
@@ -0,0 +1,283 @@
+#include "ModelStore.h"
+#include <Arduino.h>
+#include <string.h>
+#include "ModelBlob.h"
+#include "ModelRuntime.h"
+#ifdef ARDUINO
+#include <esp_partition.h>
+#include <esp_spi_flash.h>
+#else
+#include <fcntl.h>
+#include <stdio.h>
+#include <sys/mman.h>
+#include <unistd.h>
+#endif
+
+static const size_t kSector = 4096;	// flash erase granularity
+static const size_t kChunk = 256;	// read-back buffer for CRC checks
+
+ModelStore::ModelStore() {
+	memset(records_, 0, sizeof(records_));
+	for (int i = 0; i < kSlots; ++i) {
+		valid_[i] = false;
+		capacity_[i] = 0;
+		part_[i] = nullptr;
+	}
+}
+
+ModelStore::~ModelStore() {
+	unmapSlot_();
+}
+
+const char* ModelStore::label(int slot) const {
+	return slot == 0 ? MODELSTORE_LABEL_A : MODELSTORE_LABEL_B;
+}
+
+bool ModelStore::fail_(const char* why) {
+	error_ = why;
+	Serial.printf("ERROR: ModelStore: %s\n", why);
+	return false;
+}
+
+// ---------------------------------------------------------------- slot access
+
+#ifdef ARDUINO
+
+bool ModelStore::open_(int slot) {
+	const esp_partition_t* p = esp_partition_find_first(ESP_PARTITION_TYPE_DATA, ESP_PARTITION_SUBTYPE_ANY, label(slot));
+	part_[slot] = p;
+	capacity_[slot] = p ? p->size : 0;
+	return p != nullptr;
+}
+
+bool ModelStore::read_(int slot, size_t offset, void* dst, size_t n) {
+	const esp_partition_t* p = static_cast<const esp_partition_t*>(part_[slot]);
+	return p && esp_partition_read(p, offset, dst, n) == ESP_OK;
+}
+
+bool ModelStore::erase_(int slot, size_t offset, size_t n) {
+	const esp_partition_t* p = static_cast<const esp_partition_t*>(part_[slot]);
+	return p && esp_partition_erase_range(p, offset, n) == ESP_OK;
+}
+
+bool ModelStore::write_(int slot, size_t offset, const void* src, size_t n) {
+	const esp_partition_t* p = static_cast<const esp_partition_t*>(part_[slot]);
+	return p && esp_partition_write(p, offset, src, n) == ESP_OK;
+}
+
+bool ModelStore::mapSlot_(int slot) {
+	const esp_partition_t* p = static_cast<const esp_partition_t*>(part_[slot]);
+	const void* ptr = nullptr;
+	spi_flash_mmap_handle_t handle;
+	if (!p || esp_partition_mmap(p, 0, kBlobAlign + records_[slot].size, SPI_FLASH_MMAP_DATA, &ptr, &handle) != ESP_OK) {
+		return fail_("esp_partition_mmap failed");
+	}
+	map_handle_ = handle;
+	map_ = const_cast<void*>(ptr);
+	data_ = static_cast<const uint8_t*>(ptr) + kBlobAlign;
+	active_ = slot;
+	return true;
+}
+
+void ModelStore::unmapSlot_() {
+	if (map_) spi_flash_munmap(map_handle_);
+	map_ = nullptr;
+	data_ = nullptr;
+}
+
+#else
+
+static void slotPath_(const char* label, char* path, size_t n) {
+	snprintf(path, n, "%s/%s.bin", MODELSTORE_HOST_DIR, label);
+}
+
+bool ModelStore::open_(int slot) {
+	capacity_[slot] = MODELSTORE_HOST_SLOT_SIZE;
+	return true;
+}
+
+bool ModelStore::read_(int slot, size_t offset, void* dst, size_t n) {
+	char path[256];
+	slotPath_(label(slot), path, sizeof(path));
+	const int fd = open(path, O_RDONLY);
+	if (fd < 0) return false;
+	const bool ok = pread(fd, dst, n, (off_t)offset) == (ssize_t)n;
+	close(fd);
+	return ok;
+}
+
+bool ModelStore::erase_(int slot, size_t offset, size_t n) {
+	char path[256];
+	slotPath_(label(slot), path, sizeof(path));
+	const int fd = open(path, O_RDWR | O_CREAT, 0644);
+	if (fd < 0) return false;
+	uint8_t ff[kSector];
+	memset(ff, 0xFF, sizeof(ff));
+	bool ok = true;
+	for (size_t done = 0; ok && done < n; done += sizeof(ff)) {
+		const size_t len = n - done < sizeof(ff) ? n - done : sizeof(ff);
+		ok = pwrite(fd, ff, len, (off_t)(offset + done)) == (ssize_t)len;
+	}
+	close(fd);
+	return ok;
+}
+
+bool ModelStore::write_(int slot, size_t offset, const void* src, size_t n) {
+	char path[256];
+	slotPath_(label(slot), path, sizeof(path));
+	const int fd = open(path, O_WRONLY);
+	if (fd < 0) return false;
+	const bool ok = pwrite(fd, src, n, (off_t)offset) == (ssize_t)n;
+	close(fd);
+	return ok;
+}
+
+bool ModelStore::mapSlot_(int slot) {
+	char path[256];
+	slotPath_(label(slot), path, sizeof(path));
+	const int fd = open(path, O_RDONLY);
+	if (fd < 0) return fail_("cannot open slot file");
+	const size_t len = kBlobAlign + records_[slot].size;
+	void* map = mmap(nullptr, len, PROT_READ, MAP_PRIVATE, fd, 0);
+	close(fd);
+	if (map == MAP_FAILED) return fail_("mmap failed");
+	map_ = map;
+	map_size_ = len;
+	data_ = static_cast<const uint8_t*>(map) + kBlobAlign;
+	active_ = slot;
+	return true;
+}
+
+void ModelStore::unmapSlot_() {
+	if (map_) munmap(map_, map_size_);
+	map_ = nullptr;
+	map_size_ = 0;
+	data_ = nullptr;
+}
+
+#endif
+
+// ---------------------------------------------------------------- selection
+
+bool ModelStore::checkSlot_(int slot) {
+	valid_[slot] = false;
+	ModelSlotRecord& r = records_[slot];
+	if (!open_(slot) || !read_(slot, 0, &r, sizeof(r))) return false;
+	if (r.magic != kSlotMagic || r.size < sizeof(BlobHeader) || r.size > capacity_[slot] - kBlobAlign) return false;
+	uint8_t buf[kChunk];
+	uint32_t crc = 0;
+	for (size_t off = 0; off < r.size; off += kChunk) {
+		const size_t n = r.size - off < kChunk ? r.size - off : kChunk;
+		if (!read_(slot, kBlobAlign + off, buf, n)) return false;
+		crc = ModelRuntime::crc32(buf, n, crc);
+	}
+	valid_[slot] = crc == r.crc32;
+	return valid_[slot];
+}
+
+bool ModelStore::begin() {
+	Serial.println("DEBUG: ModelStore begin");
+	unmapSlot_();
+	active_ = -1;
+	int best = -1;
+	for (int i = 0; i < kSlots; ++i) {
+		if (!checkSlot_(i)) {
+			Serial.printf("DEBUG: ModelStore slot %s: %s\n", label(i), part_[i] || capacity_[i] ? "empty or invalid" : "no partition");
+			continue;
+		}
+		Serial.printf("DEBUG: ModelStore slot %s: seq %u, %u bytes\n", label(i), (unsigned)records_[i].sequence, (unsigned)records_[i].size);
+		if (best < 0 || (int32_t)(records_[i].sequence - records_[best].sequence) > 0) best = i;
+	}
+	if (best < 0) return fail_("no valid model slot");
+	if (!mapSlot_(best)) return false;
+	error_ = nullptr;
+	Serial.flush();
+	return true;
+}
+
+bool ModelStore::fallback() {
+	if (active_ < 0 || !valid_[active_ ^ 1]) return fail_("no other valid model slot");
+	const int other = active_ ^ 1;
+	unmapSlot_();
+	Serial.printf("DEBUG: ModelStore falling back to slot %s\n", label(other));
+	return mapSlot_(other);
+}
+
+// ---------------------------------------------------------------- OTA
+
+bool ModelStore::beginUpdate() {
+	abortUpdate();
+	const int slot = active_ >= 0 ? (active_ ^ 1) : 0;
+	if (!capacity_[slot] && !open_(slot)) return fail_("no partition for the update slot");
+	// Erasing the first sector clears the record, so the slot is invalid
+	// until finishUpdate() succeeds.
+	valid_[slot] = false;
+	if (!erase_(slot, 0, kSector)) return fail_("erase failed");
+	target_ = slot;
+	written_ = 0;
+	erased_ = kSector;
+	Serial.printf("DEBUG: ModelStore update into slot %s\n", label(slot));
+	return true;
+}
+
+bool ModelStore::writeUpdate(const uint8_t* chunk, size_t n) {
+	if (target_ < 0) return fail_("no update in progress");
+	const size_t end = kBlobAlign + written_ + n;
+	if (end > capacity_[target_]) {
+		target_ = -1;
+		return fail_("blob larger than the slot");
+	}
+	while (erased_ < end) {
+		if (!erase_(target_, erased_, kSector)) {
+			target_ = -1;
+			return fail_("erase failed");
+		}
+		erased_ += kSector;
+	}
+	if (!write_(target_, kBlobAlign + written_, chunk, n)) {
+		target_ = -1;
+		return fail_("write failed");
+	}
+	written_ += n;
+	return true;
+}
+
+bool ModelStore::finishUpdate() {
+	if (target_ < 0) return fail_("no update in progress");
+	const int slot = target_;
+	target_ = -1;
+	BlobHeader h;
+	if (written_ < sizeof(h) || !read_(slot, kBlobAlign, &h, sizeof(h))) return fail_("blob too short");
+	if (h.magic != kBlobMagic || h.version != kBlobVersion) return fail_("not a KWSM blob");
+	if (h.total_size != written_) return fail_("blob size does not match its header");
+
+	// Read back what landed in flash: body CRC against the header, and the
+	// whole-blob CRC for the record.
+	uint8_t buf[kChunk];
+	uint32_t body = 0, whole = ModelRuntime::crc32(reinterpret_cast<const uint8_t*>(&h), sizeof(h));
+	for (size_t off = sizeof(h); off < written_; off += kChunk) {
+		const size_t n = written_ - off < kChunk ? written_ - off : kChunk;
+		if (!read_(slot, kBlobAlign + off, buf, n)) return fail_("read-back failed");
+		body = ModelRuntime::crc32(buf, n, body);
+		whole = ModelRuntime::crc32(buf, n, whole);
+	}
+	if (body != h.crc32) return fail_("CRC mismatch");
+
+	uint32_t seq = 0;
+	for (int i = 0; i < kSlots; ++i) {
+		if (valid_[i] && (int32_t)(records_[i].sequence - seq) > 0) seq = records_[i].sequence;
+	}
+	ModelSlotRecord r = { kSlotMagic, seq + 1, (uint32_t)written_, whole };
+	if (!write_(slot, 0, &r, sizeof(r))) return fail_("record write failed");
+	records_[slot] = r;
+	valid_[slot] = true;
+	Serial.printf("DEBUG: ModelStore slot %s committed: seq %u, %u bytes\n", label(slot), (unsigned)r.sequence, (unsigned)r.size);
+	Serial.flush();
+	return true;
+}
+
+void ModelStore::abortUpdate() {
+	target_ = -1;
+	written_ = 0;
+	erased_ = 0;
+}
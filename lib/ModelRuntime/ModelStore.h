@@ -0,0 +1,96 @@
+#ifndef MODELSTORE_H
+#define MODELSTORE_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+// Partition labels of the two model slots (partitions_kws.csv). On the host
+// each slot is a file <MODELSTORE_HOST_DIR>/<label>.bin.
+#ifndef MODELSTORE_LABEL_A
+#define MODELSTORE_LABEL_A "model_a"
+#endif
+#ifndef MODELSTORE_LABEL_B
+#define MODELSTORE_LABEL_B "model_b"
+#endif
+#ifndef MODELSTORE_HOST_DIR
+#define MODELSTORE_HOST_DIR "."
+#endif
+#ifndef MODELSTORE_HOST_SLOT_SIZE
+#define MODELSTORE_HOST_SLOT_SIZE (128 * 1024)
+#endif
+
+// Written at offset 0 of a slot once its blob is complete and verified.
+// The blob itself starts at kBlobAlign.
+struct ModelSlotRecord {
+	uint32_t	magic;		// ModelStore::kSlotMagic
+	uint32_t	sequence;	// the newest valid slot is the active one
+	uint32_t	size;		// blob bytes
+	uint32_t	crc32;		// of the whole blob, header included
+};
+
+// KWSM model blobs kept in two flash partitions and read in place:
+// esp_partition_mmap on the target, mmap of the slot file on the host.
+// Nothing is copied into RAM; ModelRuntime::load() takes data()/size().
+//
+// Model-only OTA writes the inactive slot, erasing sectors as the chunks
+// arrive, and commits it by writing its record last. A torn or corrupt
+// update therefore never touches the running model, and the new one is
+// picked up by the next begin() (after a restart).
+class ModelStore {
+public:
+	static const uint32_t kSlotMagic = 0x5353574B;	// "KWSS"
+	static const int kSlots = 2;
+
+	ModelStore();
+	~ModelStore();
+
+	// Maps the newest slot whose record and CRC check out.
+	bool begin();
+	// Maps the other valid slot instead, e.g. when the runtime rejects the
+	// newest blob. False if there is none.
+	bool fallback();
+
+	const uint8_t*	data() const { return data_; }
+	size_t			size() const { return data_ ? records_[active_].size : 0; }
+	uint32_t		sequence() const { return data_ ? records_[active_].sequence : 0; }
+	int				activeSlot() const { return data_ ? active_ : -1; }
+	const char*		label(int slot) const;
+
+	// OTA into the slot that is not mapped. Chunks must arrive in order.
+	bool	beginUpdate();
+	bool	writeUpdate(const uint8_t* chunk, size_t n);
+	bool	finishUpdate();		// verifies magic, size and CRC, then commits
+	void	abortUpdate();
+	size_t	updateBytes() const { return written_; }
+
+	const char* error() const { return error_; }
+
+private:
+	ModelSlotRecord	records_[kSlots];
+	bool			valid_[kSlots];
+	size_t			capacity_[kSlots];
+	const void*		part_[kSlots];		// esp_partition_t* on the target, unused on the host
+	int				active_ = -1;
+	const uint8_t*	data_ = nullptr;
+	uint32_t		map_handle_ = 0;	// spi_flash_mmap_handle_t
+	void*			map_ = nullptr;		// host mmap
+	size_t			map_size_ = 0;
+
+	int				target_ = -1;		// slot being updated
+	size_t			written_ = 0;
+	size_t			erased_ = 0;
+	const char*		error_ = "not started";
+
+	bool	fail_(const char* why);
+	bool	mapSlot_(int slot);
+	void	unmapSlot_();
+	bool	checkSlot_(int slot);
+
+	// Raw slot access (partition or file).
+	bool	open_(int slot);
+	bool	read_(int slot, size_t offset, void* dst, size_t n);
+	bool	erase_(int slot, size_t offset, size_t n);
+	bool	write_(int slot, size_t offset, const void* src, size_t n);
+};
+
+#endif
@@ -0,0 +1,67 @@
+#ifndef LATENCYHISTOGRAM_H
+#define LATENCYHISTOGRAM_H
+
+#include <stdint.h>
+#include <atomic>
+
+// Log-bucketed histogram of 32-bit durations (cycles or microseconds).
+// Each power of two is split into four buckets, so a bucket is at most 25%
+// wide and 124 of them cover the whole range; values below 4 get one each.
+//
+// add() is a few relaxed atomic increments and never blocks, so it is safe
+// from any task or core; readers see each counter exactly but the set of
+// them only approximately consistent, which is fine for percentiles.
+// Counters run from boot: a collector subtracts two snapshots to get the
+// distribution over an interval.
+class LatencyHistogram {
+public:
+	static const int kBuckets = 124;
+
+	static int bucket(uint32_t v) {
+		if (v < 4) return (int)v;
+		const int e = 31 - __builtin_clz(v);	// >= 2
+		return (e - 1) * 4 + (int)((v >> (e - 2)) & 3);
+	}
+	// Smallest value that falls into bucket i.
+	static uint32_t lower(int i) {
+		if (i < 4) return (uint32_t)i;
+		const int e = i / 4 + 1;
+		return (uint32_t)(4 + i % 4) << (e - 2);
+	}
+
+	void add(uint32_t v) {
+		counts_[bucket(v)].fetch_add(1, std::memory_order_relaxed);
+		count_.fetch_add(1, std::memory_order_relaxed);
+		uint32_t m = max_.load(std::memory_order_relaxed);
+		while (v > m && !max_.compare_exchange_weak(m, v, std::memory_order_relaxed)) {}
+	}
+
+	uint32_t count() const { return count_.load(std::memory_order_relaxed); }
+	uint32_t max() const { return max_.load(std::memory_order_relaxed); }
+	uint32_t at(int i) const { return counts_[i].load(std::memory_order_relaxed); }
+
+	// Upper edge of the bucket holding the q-quantile, capped at max();
+	// 0 when empty.
+	uint32_t quantile(float q) const {
+		uint32_t total = 0;
+		for (int i = 0; i < kBuckets; ++i) total += at(i);
+		if (total == 0) return 0;
+		const uint32_t rank = (uint32_t)(q * (float)(total - 1));
+		uint32_t seen = 0;
+		for (int i = 0; i < kBuckets; ++i) {
+			seen += at(i);
+			if (seen > rank) {
+				const uint32_t hi = i + 1 < kBuckets ? lower(i + 1) - 1 : UINT32_MAX;
+				return hi < max() ? hi : max();
+			}
+		}
+		return max();
+	}
+
+private:
+	std::atomic<uint32_t>	counts_[kBuckets] = {};
+	std::atomic<uint32_t>	count_{ 0 };
+	std::atomic<uint32_t>	max_{ 0 };
+};
+
+#endif
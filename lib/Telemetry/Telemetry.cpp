@@ -0,0 +1,116 @@
+#include "Telemetry.h"
+#include <Arduino.h>
+#include <stdarg.h>
+#include <stdio.h>
+#include "frontend_params.h"
+#include "CycleCounter.h"
+#ifdef ARDUINO
+#include <esp_heap_caps.h>
+#include <freertos/FreeRTOS.h>
+#include <freertos/task.h>
+#endif
+
+namespace telemetry {
+
+LatencyHistogram stages[kStageCount];
+
+static const char* const kStageNames[kStageCount] = { "frontend", "vad", "inference", "capture_to_decision" };
+static const char* const kStageUnits[kStageCount] = { "cycles", "cycles", "cycles", "us" };
+
+#if defined(ARDUINO) && configGENERATE_RUN_TIME_STATS && configUSE_TRACE_FACILITY
+
+// Busy share per core from how much of the run-time clock its idle task got.
+static void sampleCpu_(float* busy) {
+	static uint32_t last_idle[portNUM_PROCESSORS];
+	static uint32_t last_clock = 0;
+	const uint32_t clock = (uint32_t)portGET_RUN_TIME_COUNTER_VALUE();
+	const uint32_t span = clock - last_clock;
+	for (int c = 0; c < 2; ++c) {
+		busy[c] = -1.0f;
+		if (c >= portNUM_PROCESSORS) continue;
+		TaskStatus_t st;
+		vTaskGetInfo(xTaskGetIdleTaskHandleForCPU(c), &st, pdFALSE, eRunning);
+		const uint32_t idle = st.ulRunTimeCounter - last_idle[c];
+		last_idle[c] = st.ulRunTimeCounter;
+		if (span) busy[c] = idle >= span ? 0.0f : 1.0f - (float)idle / (float)span;
+	}
+	last_clock = clock;
+}
+
+#else
+
+static void sampleCpu_(float* busy) {
+	busy[0] = busy[1] = -1.0f;
+}
+
+#endif
+
+void sampleSystem(System& s) {
+	s.uptime_ms = millis();
+	sampleCpu_(s.cpu_busy);
+#ifdef ARDUINO
+	s.sram_free = heap_caps_get_free_size(MALLOC_CAP_INTERNAL);
+	s.sram_min_free = heap_caps_get_minimum_free_size(MALLOC_CAP_INTERNAL);
+	s.psram_free = heap_caps_get_free_size(MALLOC_CAP_SPIRAM);
+	s.psram_min_free = heap_caps_get_minimum_free_size(MALLOC_CAP_SPIRAM);
+#else
+	s.sram_free = s.sram_min_free = s.psram_free = s.psram_min_free = 0;
+#endif
+}
+
+size_t json(char* buf, size_t cap, const Counters& c, const System& s) {
+	size_t n = 0;
+	bool ok = true;
+	auto put = [&](const char* fmt, ...) {
+		va_list ap;
+		va_start(ap, fmt);
+		const int w = vsnprintf(buf + n, n < cap ? cap - n : 0, fmt, ap);
+		va_end(ap);
+		n += w > 0 ? (size_t)w : 0;
+		ok = ok && n < cap;
+	};
+#ifdef ARDUINO
+	const char* target = "esp32s3";
+#else
+	const char* target = "host";
+#endif
+	put("{\"target\":\"%s\",\"uptime_ms\":%u,\"cycle_hz\":%llu,\"sample_rate\":%d,",
+	    target, (unsigned)s.uptime_ms, (unsigned long long)cycleHz(), KWS_SAMPLE_RATE_HZ);
+	put("\"counters\":{\"hops\":%u,\"gated_hops\":%u,\"inferences\":%u,\"detections\":%u,"
+	    "\"near_misses\":%u,\"suppressed\":%u,\"dropped_samples\":%u,\"overflows\":%u,"
+	    "\"queue_drops\":%u,\"coalesced\":%u,\"overwritten\":%u},",
+	    (unsigned)c.hops, (unsigned)c.gated_hops, (unsigned)c.inferences, (unsigned)c.detections,
+	    (unsigned)c.near_misses, (unsigned)c.suppressed,
+	    (unsigned)c.dropped_samples, (unsigned)c.overflows, (unsigned)c.queue_drops,
+	    (unsigned)c.coalesced, (unsigned)c.overwritten);
+	put("\"cpu_busy\":[");
+	for (int i = 0; i < 2; ++i) {
+		if (s.cpu_busy[i] < 0.0f) put("%snull", i ? "," : "");
+		else put("%s%.3f", i ? "," : "", s.cpu_busy[i]);
+	}
+	put("],\"memory\":{\"sram_free\":%u,\"sram_min_free\":%u,\"psram_free\":%u,\"psram_min_free\":%u,"
+	    "\"stack_min_free\":[%u,%u]},",
+	    (unsigned)s.sram_free, (unsigned)s.sram_min_free, (unsigned)s.psram_free, (unsigned)s.psram_min_free,
+	    (unsigned)s.stack_min_free[0], (unsigned)s.stack_min_free[1]);
+
+	// Non-empty buckets as [lower bound, count].
+	put("\"stages\":[");
+	for (int i = 0; i < kStageCount; ++i) {
+		const LatencyHistogram& h = stages[i];
+		put("%s\n{\"name\":\"%s\",\"unit\":\"%s\",\"count\":%u,\"p50\":%u,\"p90\":%u,\"p99\":%u,\"max\":%u,\"buckets\":[",
+		    i ? "," : "", kStageNames[i], kStageUnits[i], (unsigned)h.count(),
+		    (unsigned)h.quantile(0.50f), (unsigned)h.quantile(0.90f), (unsigned)h.quantile(0.99f), (unsigned)h.max());
+		bool first = true;
+		for (int b = 0; b < LatencyHistogram::kBuckets; ++b) {
+			const uint32_t k = h.at(b);
+			if (!k) continue;
+			put("%s[%u,%u]", first ? "" : ",", (unsigned)LatencyHistogram::lower(b), (unsigned)k);
+			first = false;
+		}
+		put("]}");
+	}
+	put("\n]}\n");
+	return ok ? n : 0;
+}
+
+}  // namespace telemetry
@@ -0,0 +1,58 @@
+#pragma once
+#include <stddef.h>
+#include <stdint.h>
+#include "env.h"
+#include "LatencyHistogram.h"
+
+// Pipeline telemetry: per-stage latency histograms recorded on the hot
+// path, plus counters and system figures gathered when someone asks.
+// json() renders a snapshot; the firmware serves it at
+// http://<ip>:TELEMETRY_PORT/telemetry, kws_run -j writes it to a file, and
+// tools/telemetry_collect.py reads either.
+namespace telemetry {
+
+enum Stage : uint8_t {
+	STAGE_FRONTEND,		// processFrame(), cycles
+	STAGE_VAD,			// VadGate::update(), cycles
+	STAGE_INFERENCE,	// one model run, cycles
+	STAGE_LATENCY,		// newest sample of the window to the decision, microseconds
+	kStageCount
+};
+extern LatencyHistogram stages[kStageCount];
+
+inline void record(Stage s, uint32_t v) { stages[s].add(v); }
+
+// Totals since boot.
+struct Counters {
+	uint32_t	hops;				// frontend rows published
+	uint32_t	gated_hops;			// inference skipped, voice gate closed
+	uint32_t	inferences;
+	uint32_t	detections;
+	uint32_t	near_misses;		// smoothed posterior peaked just under the threshold
+	uint32_t	suppressed;			// threshold crossings inside the refractory period
+	uint32_t	dropped_samples;	// audio lost to DMA overflows or a full ring
+	uint32_t	overflows;			// I2S RX_Q_OVF events
+	uint32_t	queue_drops;		// hops refused by the full hop queue
+	uint32_t	coalesced;
+	uint32_t	overwritten;
+};
+
+struct System {
+	uint32_t	uptime_ms;
+	float		cpu_busy[2];		// per core since the previous sample, 0..1; < 0 unavailable
+	uint32_t	sram_free;			// internal heap
+	uint32_t	sram_min_free;		// its low-water mark since boot
+	uint32_t	psram_free;			// 0 without PSRAM
+	uint32_t	psram_min_free;
+	uint32_t	stack_min_free[2];	// kwsTask, captureTask; filled by the caller, 0 unknown
+};
+
+// Heap and uptime now; CPU load since the previous call (the first call
+// reports the load since boot). CPU needs FreeRTOS run-time stats
+// (configGENERATE_RUN_TIME_STATS) and reads as -1 without them.
+void sampleSystem(System& s);
+
+// One JSON object into buf; returns its length, 0 if it did not fit.
+size_t json(char* buf, size_t cap, const Counters& c, const System& s);
+
+}  // namespace telemetry
@@ -0,0 +1,61 @@
+#include "Trace.h"
+#ifdef ARDUINO
+#include <Arduino.h>
+#include <freertos/task.h>
+#endif
+
+namespace trace {
+
+TraceRing rings[kCores];
+
+static Sink g_sink = nullptr;
+static const size_t kBatchEvents = 32;	// 528-byte frames, one UDP datagram each
+
+size_t drain() {
+	if (!g_sink) return 0;
+	struct {
+		TraceBatch	hdr;
+		TraceEvent	ev[kBatchEvents];
+	} frame;
+	size_t total = 0;
+	for (int c = 0; c < kCores; ++c) {
+		for (;;) {
+			const size_t n = rings[c].pop(frame.ev, kBatchEvents);
+			const uint32_t dropped = rings[c].takeDropped();
+			if (n == 0 && dropped == 0) break;
+			frame.hdr = TraceBatch{ kTraceMagic, kTraceVersion, (uint8_t)c, (uint16_t)n, (uint32_t)cycleHz(), dropped };
+			g_sink(reinterpret_cast<const uint8_t*>(&frame), sizeof(frame.hdr) + n * sizeof(TraceEvent));
+			total += n;
+			if (n < kBatchEvents) break;
+		}
+	}
+	return total;
+}
+
+#ifdef ARDUINO
+
+static void drainTask(void* param) {
+	while (1) {
+		drain();
+		vTaskDelay(pdMS_TO_TICKS(TRACE_DRAIN_MS));
+	}
+}
+
+void begin(Sink sink) {
+	g_sink = sink;
+	static TaskHandle_t task = nullptr;
+	if (!task && TRACE_LEVEL > 0) {
+		// Lowest priority above idle, on whichever core is free.
+		xTaskCreate(drainTask, "trace", 3072, nullptr, tskIDLE_PRIORITY + 1, &task);
+	}
+}
+
+#else
+
+void begin(Sink sink) {
+	g_sink = sink;
+}
+
+#endif
+
+}  // namespace trace
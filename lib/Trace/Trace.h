@@ -0,0 +1,158 @@
+#pragma once
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+#include <atomic>
+#include "env.h"
+#ifdef ARDUINO
+#include <freertos/FreeRTOS.h>
+#endif
+#include "CycleCounter.h"
+#include "TraceEvents.h"
+
+// Binary tracing for the audio hot path. TRACE(id, a, b) stores a 16-byte
+// event (ID, core, cycle timestamp, two payload words) in its core's ring
+// and returns: no formatting, no locks, no UART. A low-priority task
+// (trace::begin) drains the rings in batches to a sink, the serial port or
+// UDP, and tools/trace_decode.py turns the stream into a timeline.
+//
+// Each event has a level in TraceEvents.h; events above TRACE_LEVEL, and
+// everything at TRACE_LEVEL 0, compile to nothing, arguments included.
+// Work done only to feed an event goes under if (TRACE_ON(id)).
+//
+// A full ring drops new events and counts them; the count travels in the
+// next batch header.
+
+#ifndef TRACE_LEVEL
+#define TRACE_LEVEL 2
+#endif
+#ifndef TRACE_RING_EVENTS
+#define TRACE_RING_EVENTS 256	// per core; power of two
+#endif
+#ifndef TRACE_DRAIN_MS
+#define TRACE_DRAIN_MS 50
+#endif
+
+struct TraceEvent {
+	uint16_t	id;			// TraceId
+	uint8_t		core;
+	uint8_t		reserved;
+	uint32_t	cycles;		// cycles() when emitted, per core
+	uint32_t	a;
+	uint32_t	b;
+};
+static_assert(sizeof(TraceEvent) == 16, "trace events are 16 bytes on the wire");
+
+// Sink framing: a header, then count events, all little-endian.
+struct TraceBatch {
+	uint32_t	magic;		// kTraceMagic
+	uint8_t		version;
+	uint8_t		core;
+	uint16_t	count;
+	uint32_t	cycle_hz;
+	uint32_t	dropped;	// events this core's ring refused since the last batch
+};
+static_assert(sizeof(TraceBatch) == 16, "trace batch header is 16 bytes on the wire");
+
+static const uint32_t kTraceMagic = 0x5453574B;	// "KWST"
+static const uint8_t kTraceVersion = 1;
+
+static constexpr uint8_t kTraceLevels[] = {
+#define TRACE_LEVEL_(name, level, a, b) level,
+	TRACE_EVENT_LIST(TRACE_LEVEL_)
+#undef TRACE_LEVEL_
+};
+
+// Bounded multi-producer / single-consumer ring. Any task or ISR on the
+// core claims a slot with a CAS on head_, fills it and publishes it through
+// the slot's sequence number; the drain task takes published slots in order
+// and stops at one still being written.
+class TraceRing {
+	static_assert((TRACE_RING_EVENTS & (TRACE_RING_EVENTS - 1)) == 0, "TRACE_RING_EVENTS must be a power of two");
+
+public:
+	bool push(const TraceEvent& ev) {
+		uint32_t head = head_.load(std::memory_order_relaxed);
+		do {
+			if (head - tail_.load(std::memory_order_acquire) >= TRACE_RING_EVENTS) {
+				dropped_.fetch_add(1, std::memory_order_relaxed);
+				return false;
+			}
+		} while (!head_.compare_exchange_weak(head, head + 1, std::memory_order_relaxed));
+		Slot& s = slots_[head & (TRACE_RING_EVENTS - 1)];
+		s.ev = ev;
+		s.seq.store(head + 1, std::memory_order_release);
+		return true;
+	}
+
+	// Consumer only.
+	size_t pop(TraceEvent* out, size_t max) {
+		uint32_t tail = tail_.load(std::memory_order_relaxed);
+		size_t n = 0;
+		while (n < max) {
+			const Slot& s = slots_[tail & (TRACE_RING_EVENTS - 1)];
+			if (s.seq.load(std::memory_order_acquire) != tail + 1) break;
+			out[n++] = s.ev;
+			tail_.store(++tail, std::memory_order_release);
+		}
+		return n;
+	}
+	uint32_t takeDropped() { return dropped_.exchange(0, std::memory_order_relaxed); }
+
+private:
+	struct Slot {
+		TraceEvent				ev;
+		std::atomic<uint32_t>	seq{ 0 };	// head + 1 once ev is complete
+	};
+	Slot					slots_[TRACE_RING_EVENTS];
+	std::atomic<uint32_t>	head_{ 0 };
+	std::atomic<uint32_t>	tail_{ 0 };
+	std::atomic<uint32_t>	dropped_{ 0 };
+};
+
+namespace trace {
+
+// Writes one framed batch; called from the drain task only.
+typedef void (*Sink)(const uint8_t* data, size_t n);
+
+#ifdef ARDUINO
+static const int kCores = portNUM_PROCESSORS;
+inline int core() { return xPortGetCoreID(); }
+#else
+static const int kCores = 1;
+inline int core() { return 0; }
+#endif
+extern TraceRing rings[kCores];
+
+inline void emit(TraceId id, uint32_t a, uint32_t b) {
+	const uint32_t t = cycles();
+	const int c = core();
+	rings[c].push(TraceEvent{ (uint16_t)id, (uint8_t)c, 0, t, a, b });
+}
+
+inline uint32_t word(float v) {
+	uint32_t w;
+	memcpy(&w, &v, sizeof(w));
+	return w;
+}
+inline uint32_t word(double v) { return word((float)v); }
+template <typename T>
+inline uint32_t word(T v) { return (uint32_t)v; }
+
+// Sets the sink and, on the target, starts the drain task.
+void begin(Sink sink);
+// Sends everything queued so far; returns the number of events. The drain
+// task calls it every TRACE_DRAIN_MS; the host calls it directly.
+size_t drain();
+
+}  // namespace trace
+
+#define TRACE_ON(id) (TRACE_LEVEL > 0 && kTraceLevels[id] <= TRACE_LEVEL)
+#if TRACE_LEVEL > 0
+#define TRACE(id, a, b) \
+	do { \
+		if (TRACE_ON(id)) trace::emit(id, trace::word(a), trace::word(b)); \
+	} while (0)
+#else
+#define TRACE(id, a, b) ((void)0)
+#endif
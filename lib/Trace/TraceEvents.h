@@ -0,0 +1,31 @@
+#pragma once
+#include <stdint.h>
+
+// Every trace event, in ID order. tools/trace_decode.py reads this list, so
+// append new events and keep one X(...) per line:
+//   X(name, level, "a", "b")
+// Payload formats: u unsigned, i signed, f float bits, x hex, - unused.
+// Levels: 1 rare (errors, detections), 2 per inference, 3 per frame.
+#define TRACE_EVENT_LIST(X) \
+	X(CAPTURE_READ_FAIL,    1, "u", "u") /* buffered, needed samples */ \
+	X(CAPTURE_GAP,          1, "u", "u") /* stream position (low 32 bits), samples lost */ \
+	X(FRAME_PCM,            3, "f", "u") /* frame RMS, sum of |pcm| */ \
+	X(MFCC_POWER,           3, "f", "f") /* power sum, power[0] */ \
+	X(MFCC_MEL,             3, "f", "f") /* log mel[0], mel[1] */ \
+	X(MFCC_ROW,             3, "u", "f") /* bus seq the row publishes as, row[0] */ \
+	X(MFCC_WINDOW,          2, "f", "u") /* computeMFCCFloat: mean |mfcc|, ring full */ \
+	X(HOP_QUEUED,           3, "u", "u") /* bus seq, voice gate open */ \
+	X(INFER_BEGIN,          2, "u", "u") /* window seq, hops folded in */ \
+	X(INFER_RESULT,         2, "f", "f") /* p_conf, smoothed posterior */ \
+	X(INFER_OVERWRITTEN,    1, "u", "-") /* window seq dropped mid-inference */ \
+	X(DETECTION,            1, "f", "u") /* smoothed peak, stream position (low 32 bits) */ \
+	X(SCHED_DUTY,           2, "f", "f") /* inference duty, VAD gated share */ \
+	X(KWS_LOOP,             2, "u", "u") /* detect_once duration ms, fired */ \
+	X(KWS_HEALTH,           2, "u", "u") /* stack high water bytes, free heap bytes */
+
+enum TraceId : uint16_t {
+#define TRACE_ID_(name, level, a, b) name,
+	TRACE_EVENT_LIST(TRACE_ID_)
+#undef TRACE_ID_
+	kTraceIdCount
+};
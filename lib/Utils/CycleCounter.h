@@ -0,0 +1,48 @@
+#ifndef CYCLECOUNTER_H
+#define CYCLECOUNTER_H
+
+#include <stdint.h>
+
+// Cheapest available timestamp, for timing code rather than telling time:
+//   ESP32-S3  CCOUNT, CPU cycles (wraps after ~17 s at 240 MHz)
+//   x86-64    TSC ticks (constant rate, close to nominal clock)
+//   other     CLOCK_MONOTONIC nanoseconds
+// Differences of cycles() are valid across a wrap as long as the interval
+// fits in 32 bits; cycleHz() converts them to time.
+#if defined(ARDUINO) && defined(ESP_PLATFORM)
+#include <Arduino.h>
+
+inline uint32_t cycles() { return ESP.getCycleCount(); }
+inline uint64_t cycleHz() { return (uint64_t)getCpuFrequencyMhz() * 1000000u; }
+
+#elif defined(__x86_64__) || defined(_M_X64)
+#include <x86intrin.h>
+#include <chrono>
+
+inline uint32_t cycles() { return (uint32_t)__rdtsc(); }
+
+// TSC rate, measured once against steady_clock over ~20 ms.
+inline uint64_t cycleHz() {
+	static const uint64_t hz = [] {
+		const std::chrono::steady_clock::time_point t0 = std::chrono::steady_clock::now();
+		const uint64_t c0 = __rdtsc();
+		while (std::chrono::steady_clock::now() - t0 < std::chrono::milliseconds(20)) {}
+		const double s = std::chrono::duration<double>(std::chrono::steady_clock::now() - t0).count();
+		return (uint64_t)((double)(__rdtsc() - c0) / s);
+	}();
+	return hz;
+}
+
+#else
+#include <time.h>
+
+inline uint32_t cycles() {
+	struct timespec ts;
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return (uint32_t)((uint64_t)ts.tv_sec * 1000000000u + ts.tv_nsec);
+}
+inline uint64_t cycleHz() { return 1000000000u; }
+
+#endif
+
+#endif
@@ -0,0 +1,53 @@
+#include "Framer.h"
+#include <string.h>
+
+Framer::Framer() : pos_(0), filled_(0), frames_(0) {
+	memset(buf_, 0, sizeof(buf_));
+	memset(hop_, 0, sizeof(hop_));
+}
+
+void Framer::reset() {
+	pos_ = 0;
+	filled_ = 0;
+	frames_ = 0;
+	staging_.reset();
+}
+
+bool Framer::pushHop(const int16_t* hop) {
+	int done = 0;
+	while (done < AP_HOP_SAMPLES) {
+		int n = AP_HOP_SAMPLES - done;
+		if (n > kCap - pos_) n = kCap - pos_;
+		memcpy(&buf_[pos_], &hop[done], n * sizeof(int16_t));
+		memcpy(&buf_[pos_ + kCap], &hop[done], n * sizeof(int16_t));
+		pos_ = (pos_ + n) % kCap;
+		done += n;
+	}
+	if (filled_ < kCap) filled_ += AP_HOP_SAMPLES;
+	if (!ready()) return false;
+	frames_++;
+	return true;
+}
+
+size_t Framer::feed(const int16_t* pcm, size_t n) {
+	return staging_.write(pcm, n);
+}
+
+bool Framer::nextWindow(const int16_t*& window) {
+	while (staging_.available() >= (size_t)AP_HOP_SAMPLES) {
+		// Frame straight out of the ring unless the hop wraps around its end.
+		const RingBuffer<int16_t, kStaging>::Spans s = staging_.peek();
+		const int16_t* hop = s.first;
+		if (s.first_n < (size_t)AP_HOP_SAMPLES) {
+			staging_.read(hop_, AP_HOP_SAMPLES);
+			hop = hop_;
+		}
+		const bool ready = pushHop(hop);
+		if (hop != hop_) staging_.consume(AP_HOP_SAMPLES);
+		if (ready) {
+			window = this->window();
+			return true;
+		}
+	}
+	return false;
+}
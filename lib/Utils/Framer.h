@@ -0,0 +1,45 @@
+#ifndef FRAMER_H
+#define FRAMER_H
+
+#include <Arduino.h>
+#include "frontend_params.h"
+#include "RingBuffer.h"
+
+// Overlapping analysis framer: one AP_FRAME_SAMPLES window per AP_HOP_SAMPLES
+// of input (20 ms windows at a 10 ms stride -> 100 frames/s).
+//
+// Samples are kept in a mirrored buffer (sample i is stored at i and
+// i + AP_FRAME_SAMPLES), so the current window is always one contiguous span
+// and window() hands out a pointer into it instead of copying.
+class Framer {
+public:
+	Framer();
+	void reset();
+
+	// Append exactly one hop. Returns true once window() holds a full frame.
+	bool pushHop(const int16_t* hop);
+
+	// Append an arbitrary-length block (e.g. a DMA buffer) to the staging ring;
+	// returns how many samples were accepted (the rest count as overruns).
+	// nextWindow() then frames it hop by hop.
+	size_t feed(const int16_t* pcm, size_t n);
+	bool nextWindow(const int16_t*& window);
+	uint32_t stagingOverruns() const { return staging_.overruns(); }
+
+	const int16_t* window() const { return &buf_[pos_]; }	// oldest sample first
+	bool ready() const { return filled_ >= AP_FRAME_SAMPLES; }
+	uint32_t frames() const { return frames_; }
+
+private:
+	static const int kCap = AP_FRAME_SAMPLES;
+	static const size_t kStaging = 1024;	// samples (6.4 hops at 16 kHz); power of two
+
+	int16_t		buf_[2 * kCap];
+	int			pos_;		// next write position == oldest sample of the window
+	int			filled_;
+	uint32_t	frames_;
+	RingBuffer<int16_t, kStaging>	staging_;
+	int16_t		hop_[AP_HOP_SAMPLES];
+};
+
+#endif
@@ -1,24 +1,150 @@
 #ifndef RINGBUFFER_H
 #define RINGBUFFER_H
 
-#include <Arduino.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+#include <atomic>
+#include <type_traits>
 
-template<typename T>
+// Lock-free single-producer / single-consumer ring of trivially copyable
+// elements, for handing data between cores, or between an ISR and a task.
+//
+// N is a power of two; head/tail run freely and are masked on access, so
+// full and empty never need a spare slot. The producer only stores head_
+// (release) and the consumer only stores tail_ (release); each loads the
+// other's index with acquire, which orders the element copies against it.
+// Bulk transfers are at most two memcpy()s. peek() hands the consumer the
+// readable data, and reserve() the producer the free space, as one or two
+// contiguous spans, so either side can work in place.
+//
+// Nothing blocks. A write that does not fit stores what it can and counts
+// the rest in overruns(); a read that finds fewer elements than asked for
+// counts one underrun.
+template <typename T, size_t N>
 class RingBuffer {
+	static_assert(N >= 2 && (N & (N - 1)) == 0, "RingBuffer capacity must be a power of two");
+	static_assert(std::is_trivially_copyable<T>::value, "RingBuffer copies elements with memcpy");
+
 public:
-    RingBuffer(size_t size);
-    ~RingBuffer();
-    void write(T value);
-    size_t read(T* data, size_t length);
-    void reset();
-    size_t available();
+	// Readable data in order: first, then second (empty unless it wraps).
+	struct Spans {
+		const T*	first;
+		size_t		first_n;
+		const T*	second;
+		size_t		second_n;
+		size_t size() const { return first_n + second_n; }
+	};
+
+	RingBuffer() : head_(0), tail_(0), overruns_(0), underruns_(0), high_water_(0) {}
+
+	static constexpr size_t capacity() { return N; }
+
+	// Producer. Returns how many elements were stored.
+	size_t write(const T* src, size_t n) {
+		const uint32_t head = head_.load(std::memory_order_relaxed);
+		const size_t used = head - tail_.load(std::memory_order_acquire);
+		size_t fit = N - used;
+		if (n > fit) {
+			overruns_.fetch_add((uint32_t)(n - fit), std::memory_order_relaxed);
+			n = fit;
+		}
+		if (n == 0) return 0;
+		const size_t at = head & (N - 1);
+		const size_t first = n < N - at ? n : N - at;
+		memcpy(&buf_[at], src, first * sizeof(T));
+		memcpy(&buf_[0], src + first, (n - first) * sizeof(T));
+		head_.store(head + (uint32_t)n, std::memory_order_release);
+		if (used + n > high_water_.load(std::memory_order_relaxed)) {
+			high_water_.store((uint32_t)(used + n), std::memory_order_relaxed);
+		}
+		return n;
+	}
+	bool write(const T& v) { return write(&v, 1) == 1; }
+	size_t space() const { return N - available(); }
+
+	// Zero-copy write: fill (a prefix of) the free space in place, then
+	// commit() it. Refused data is the caller's to count with addOverruns().
+	struct WriteSpans {
+		T*		first;
+		size_t	first_n;
+		T*		second;
+		size_t	second_n;
+		size_t size() const { return first_n + second_n; }
+	};
+	WriteSpans reserve() {
+		const uint32_t head = head_.load(std::memory_order_relaxed);
+		const size_t n = N - (head - tail_.load(std::memory_order_acquire));
+		const size_t at = head & (N - 1);
+		const size_t first = n < N - at ? n : N - at;
+		return WriteSpans{ &buf_[at], first, &buf_[0], n - first };
+	}
+	void commit(size_t n) {
+		const uint32_t head = head_.load(std::memory_order_relaxed);
+		const size_t used = head - tail_.load(std::memory_order_relaxed);
+		head_.store(head + (uint32_t)n, std::memory_order_release);
+		if (used + n > high_water_.load(std::memory_order_relaxed)) {
+			high_water_.store((uint32_t)(used + n), std::memory_order_relaxed);
+		}
+	}
+	void addOverruns(size_t n) { overruns_.fetch_add((uint32_t)n, std::memory_order_relaxed); }
+
+	// Consumer. Returns how many elements were copied out.
+	size_t read(T* dst, size_t n) {
+		const Spans s = peek();
+		if (n > s.size()) {
+			underruns_.fetch_add(1, std::memory_order_relaxed);
+			n = s.size();
+		}
+		const size_t first = n < s.first_n ? n : s.first_n;
+		memcpy(dst, s.first, first * sizeof(T));
+		memcpy(dst + first, s.second, (n - first) * sizeof(T));
+		consume(n);
+		return n;
+	}
+	bool read(T& v) { return read(&v, 1) == 1; }
+
+	// Zero-copy read: look at everything readable, then consume() what was
+	// used. The spans stay valid until then.
+	Spans peek() const {
+		const uint32_t tail = tail_.load(std::memory_order_relaxed);
+		const size_t n = head_.load(std::memory_order_acquire) - tail;
+		const size_t at = tail & (N - 1);
+		const size_t first = n < N - at ? n : N - at;
+		return Spans{ &buf_[at], first, &buf_[0], n - first };
+	}
+	void consume(size_t n) {
+		const uint32_t tail = tail_.load(std::memory_order_relaxed);
+		const size_t avail = head_.load(std::memory_order_acquire) - tail;
+		tail_.store(tail + (uint32_t)(n < avail ? n : avail), std::memory_order_release);
+	}
+
+	// Exact from the consumer, a lower bound from the producer.
+	size_t available() const {
+		return head_.load(std::memory_order_acquire) - tail_.load(std::memory_order_acquire);
+	}
+	bool empty() const { return available() == 0; }
+
+	// Only while neither side is running.
+	void reset() {
+		head_.store(0, std::memory_order_relaxed);
+		tail_.store(0, std::memory_order_relaxed);
+		overruns_.store(0, std::memory_order_relaxed);
+		underruns_.store(0, std::memory_order_relaxed);
+		high_water_.store(0, std::memory_order_relaxed);
+	}
+
+	uint32_t overruns() const { return overruns_.load(std::memory_order_relaxed); }	// elements dropped by write()
+	uint32_t underruns() const { return underruns_.load(std::memory_order_relaxed); }	// short read() calls
+	uint32_t highWater() const { return high_water_.load(std::memory_order_relaxed); }	// most elements ever held
 
 private:
-    T* buffer;
-    size_t size;
-    size_t head;
-    size_t tail;
-    size_t count;
+	T						buf_[N];
+	std::atomic<uint32_t>	head_;		// written by the producer only
+	std::atomic<uint32_t>	tail_;		// written by the consumer only
+	std::atomic<uint32_t>	overruns_;
+	std::atomic<uint32_t>	underruns_;
+	std::atomic<uint32_t>	high_water_;
 };
 
-#endif
\ No newline at end of file
+#endif
@@ -0,0 +1,82 @@
+#include "VadGate.h"
+#include <math.h>
+#include <string.h>
+
+VadGate::VadGate() : VadGate(Config()) {}
+
+VadGate::VadGate(const Config& cfg) : cfg_(cfg) {
+	reset();
+}
+
+void VadGate::reset() {
+	memset(&stats_, 0, sizeof(stats_));
+	memset(prev_band_, 0, sizeof(prev_band_));
+	open_ = false;
+	primed_ = false;
+	prev_valid_ = false;
+	prev_loud_ = false;
+	run_ = 0;
+	hang_ = 0;
+	onset_frame_ = 0;
+}
+
+void VadGate::spectral_(const float* power, float& flatness, float& flux) {
+	const float* band = &power[kBandLo];
+	float sum = 0.0f, log_sum = 0.0f, rise = 0.0f;
+	for (int k = 0; k < kBandBins; ++k) {
+		const float p = band[k] + 1e-6f;
+		sum += p;
+		log_sum += logf(p);
+		if (prev_valid_ && p > prev_band_[k]) rise += p - prev_band_[k];
+		prev_band_[k] = p;
+	}
+	// Geometric over arithmetic mean.
+	flatness = expf(log_sum / (float)kBandBins) / (sum / (float)kBandBins);
+	flux = prev_valid_ ? rise / sum : 0.0f;
+	prev_valid_ = true;
+}
+
+bool VadGate::update(float pcm_rms, const float* power) {
+	const uint32_t frame = stats_.frames++;
+	const float e_db = 20.0f * log10f(pcm_rms + 1e-3f);
+	stats_.last_energy_db = e_db;
+	if (!primed_) {
+		stats_.noise_floor_db = e_db;
+		primed_ = true;
+	}
+
+	// Stage 1: energy.
+	const bool loud = e_db > stats_.noise_floor_db + cfg_.margin_db;
+
+	// Stage 2: spectral shape, computed every frame to keep the flux history.
+	bool speech_like = loud;
+	if (power) {
+		spectral_(power, stats_.last_flatness, stats_.last_flux);
+		speech_like = loud && (stats_.last_flatness < cfg_.flatness_max || stats_.last_flux > cfg_.flux_min);
+	}
+
+	// Stage 3: debounce / hangover.
+	if (loud && !prev_loud_) onset_frame_ = frame;
+	prev_loud_ = loud;
+	run_ = speech_like ? run_ + 1 : 0;
+	if (!open_) {
+		if (run_ >= cfg_.onset_frames) {
+			open_ = true;
+			hang_ = cfg_.hangover_frames;
+			stats_.opens++;
+			if (frame - onset_frame_ > (uint32_t)cfg_.pre_roll_frames) stats_.missed_onsets++;
+		}
+	} else if (speech_like) {
+		hang_ = cfg_.hangover_frames;
+	} else if (--hang_ <= 0) {
+		open_ = false;
+	}
+
+	// The floor only follows the signal while nothing is being detected.
+	if (!open_) {
+		const float d = e_db - stats_.noise_floor_db;
+		stats_.noise_floor_db += d * (d < 0.0f ? cfg_.floor_down : cfg_.floor_up);
+		stats_.gated++;
+	}
+	return open_;
+}
@@ -0,0 +1,74 @@
+#pragma once
+#include <stdint.h>
+#include "frontend_params.h"
+#include "env.h"
+
+// Voice activity gate that decides whether a hop is worth running the
+// network on. Stages, cheapest first:
+//   1. energy: frame level against an adaptive noise floor (fast down, slow up,
+//      only tracked while the gate is closed so speech never raises it)
+//   2. spectrum: flatness (noise is flat, voiced speech is not) or flux
+//      (onsets) over the speech band of the frontend's power spectrum
+//   3. onset debounce and a hangover that keeps the gate open between words
+// With no spectrum (int8 frontend) stage 2 is skipped.
+//
+// Pre-roll: the feature window already holds the frames before the gate
+// opened, so nothing is replayed; pre_roll_frames is the onset lag still
+// considered safe. Openings that lag the first loud frame by more than that
+// are counted as missed onsets.
+class VadGate {
+public:
+	struct Config {
+		float	margin_db = VAD_ENERGY_MARGIN_DB;	// over the noise floor
+		float	flatness_max = VAD_FLATNESS_MAX;	// 0 (tonal) .. 1 (white)
+		float	flux_min = VAD_FLUX_MIN;			// positive change / total power
+		int		onset_frames = VAD_ONSET_FRAMES;
+		int		hangover_frames = VAD_HANGOVER_FRAMES;
+		int		pre_roll_frames = VAD_PRE_ROLL_FRAMES;
+		float	floor_up = 0.005f;					// per-frame floor tracking rates
+		float	floor_down = 0.2f;
+	};
+
+	struct Stats {
+		uint32_t	frames;
+		uint32_t	gated;			// frames with the gate closed (inference skipped)
+		uint32_t	opens;
+		uint32_t	missed_onsets;	// opened later than pre_roll_frames after the onset
+		float		noise_floor_db;
+		float		last_energy_db;
+		float		last_flatness;
+		float		last_flux;
+	};
+
+	VadGate();
+	explicit VadGate(const Config& cfg);
+	void reset();
+	void setConfig(const Config& cfg) { cfg_ = cfg; }
+	const Config& config() const { return cfg_; }
+
+	// One call per hop. power: AP_FFT_BINS bins or nullptr. Returns isOpen().
+	bool update(float pcm_rms, const float* power);
+	bool isOpen() const { return open_; }
+
+	const Stats& stats() const { return stats_; }
+	float gatedShare() const { return stats_.frames ? (float)stats_.gated / (float)stats_.frames : 0.0f; }
+
+private:
+	// Speech band for the spectral stage, in FFT bins.
+	static const int kBandLo = (int)(200L * AP_FFT_SIZE / KWS_SAMPLE_RATE_HZ);
+	static const int kBandHi = (int)(4000L * AP_FFT_SIZE / KWS_SAMPLE_RATE_HZ);
+	static const int kBandBins = kBandHi - kBandLo;
+
+	Config		cfg_;
+	Stats		stats_;
+	bool		open_;
+	bool		primed_;		// noise floor initialized
+	bool		prev_valid_;	// prev_band_ holds last frame
+	bool		prev_loud_;
+	int			run_;			// consecutive speech-like frames
+	int			hang_;
+	uint32_t	onset_frame_;	// first loud frame of the current run
+	float		prev_band_[kBandBins];
+
+	void spectral_(const float* power, float& flatness, float& flux);
+};
@@ -1,6 +1,10 @@
 #include "VoiceCommands.h"
 #include "env.h"
-VoiceCommands::VoiceCommands(AudioProcessor* proc) : processor(proc), interpreter(nullptr), initialized(false) {}
+#include "model_weights.h"
+#include <math.h>
+#include <string.h>
+static const int kInputValues = KWS_FRAMES * KWS_NUM_MFCC;
+VoiceCommands::VoiceCommands(AudioProcessor* proc) : processor(proc), interpreter(nullptr), initialized(false), same_quant(false) {}
 bool VoiceCommands::init() {
     static tflite::AllOpsResolver resolver;
     const tflite::Model* model = tflite::GetModel(g_command_model);
@@ -11,15 +15,46 @@ bool VoiceCommands::init() {
     if (interpreter->AllocateTensors() != kTfLiteOk) return false;
     input = interpreter->input(0);
     output = interpreter->output(0);
+    // The input must take one bus window, no more and no less.
+    if (input->type == kTfLiteInt8) {
+        if (input->bytes != (size_t)kInputValues) return false;
+    } else if (input->type == kTfLiteFloat32) {
+        if (input->bytes != kInputValues * sizeof(float)) return false;
+    } else {
+        return false;
+    }
+    if (output->type != kTfLiteFloat32 || output->bytes < 3 * sizeof(float)) return false;
+    // The bus rows are quantized for the wake model; they can be copied
+    // only if the command model quantizes its input the same way.
+    same_quant = input->type == kTfLiteInt8 &&
+                 input->params.scale == input_scale && input->params.zero_point == input_zero_point;
     initialized = true;
     return true;
 }
 int VoiceCommands::detect() {
     if (!initialized) return -1;
-    float* mfcc = processor->getMFCC();
-    for (int i = 0; i < MFCC_NUM_COEFFS * MFCC_NUM_FRAMES; i++) {
-        input->data.f[i] = mfcc[i];
+    // Shares the wake-word detector's frontend output via the feature bus.
+    const FeatureBus& bus = processor->features();
+    FeatureWindow w;
+    if (!bus.window(w)) return -1;
+    const int n = kInputValues;
+    if (input->type == kTfLiteInt8) {
+        if (w.mfcc_q && same_quant) {
+            memcpy(input->data.int8, w.mfcc_q, n);
+        } else {
+            const float scale = input->params.scale;
+            const int32_t zp = input->params.zero_point;
+            for (int i = 0; i < n; i++) {
+                const float v = w.mfcc ? w.mfcc[i] : FeatureBus::dequantize(w.mfcc_q[i]);
+                int32_t q = (int32_t)lrintf(v / scale) + zp;
+                input->data.int8[i] = (int8_t)(q > 127 ? 127 : (q < -128 ? -128 : q));
+            }
+        }
+    } else {
+        if (w.mfcc) memcpy(input->data.f, w.mfcc, n * sizeof(float));
+        else for (int i = 0; i < n; i++) input->data.f[i] = FeatureBus::dequantize(w.mfcc_q[i]);
     }
+    if (!bus.valid(w)) return -1;
     if (interpreter->Invoke() != kTfLiteOk) return -1;
     float* output_data = output->data.f;
     int max_idx = 0;
@@ -14,6 +14,7 @@ private:
     TfLiteTensor* output;
     uint8_t tensor_arena[32 * 1024]; // 32KB arena
     bool initialized;
+    bool same_quant;  // int8 input quantized like the feature bus rows
 public:
     VoiceCommands(AudioProcessor* proc);
     bool init();
@@ -0,0 +1,121 @@
+#include "DecisionEngine.h"
+#include <math.h>
+#include <string.h>
+
+DecisionEngine::DecisionEngine() : DecisionEngine(Config()) {}
+
+DecisionEngine::DecisionEngine(const Config& cfg) {
+	setConfig(cfg);
+	reset();
+}
+
+void DecisionEngine::setConfig(const Config& cfg) {
+	cfg_ = cfg;
+	if (cfg_.smooth_n < 1) cfg_.smooth_n = 1;
+	if (cfg_.smooth_n > kMaxSmooth) cfg_.smooth_n = kMaxSmooth;
+	restart_();
+}
+
+void DecisionEngine::reset() {
+	memset(&stats_, 0, sizeof(stats_));
+	hits_any_ = false;
+	memset(&last_, 0, sizeof(last_));
+	restart_();
+}
+
+void DecisionEngine::restart_() {
+	memset(hist_, 0, sizeof(hist_));
+	hist_i_ = 0;
+	smooth_ = 0.0f;
+	have_prev_ = false;
+	armed_ = false;
+	have_before_ = false;
+	wait_ = 0;
+	above_ = false;
+	excursion_ = 0.0f;
+}
+
+bool DecisionEngine::update(float p, uint64_t pos) {
+	stats_.decisions++;
+	hist_[hist_i_] = p;
+	hist_i_ = (hist_i_ + 1) % cfg_.smooth_n;
+	float sum = 0.0f;
+	for (int i = 0; i < cfg_.smooth_n; ++i) sum += hist_[i];
+	smooth_ = sum / (float)cfg_.smooth_n;
+	const Point cur = { pos, smooth_, p };
+	bool fired = false;
+
+	// An excursion over near_miss that falls back without reaching the
+	// threshold is a near miss.
+	if (smooth_ >= cfg_.near_miss) {
+		if (smooth_ > excursion_) excursion_ = smooth_;
+	} else if (excursion_ > 0.0f) {
+		if (excursion_ < cfg_.threshold) {
+			stats_.near_misses++;
+			if (excursion_ > stats_.best_miss) stats_.best_miss = excursion_;
+		}
+		excursion_ = 0.0f;
+	}
+
+	const bool above = smooth_ >= cfg_.threshold;
+	if (armed_) {
+		if (smooth_ > peak_.smooth) {
+			before_ = peak_;
+			have_before_ = true;
+			peak_ = cur;
+			if (++wait_ >= cfg_.peak_wait) {
+				fire_(nullptr);
+				fired = true;
+			}
+		} else {
+			fire_(&cur);
+			fired = true;
+		}
+	} else if (above && !above_) {
+		// One crossing arms at most once: a mean still high when the
+		// refractory period ends does not fire again.
+		if (refractory(pos)) {
+			stats_.suppressed++;
+		} else {
+			armed_ = true;
+			peak_ = cur;
+			before_ = prev_;
+			have_before_ = have_prev_;
+			wait_ = 0;
+			if (cfg_.peak_wait <= 0) {
+				fire_(nullptr);
+				fired = true;
+			}
+		}
+	}
+
+	prev_ = cur;
+	have_prev_ = true;
+	above_ = above;
+	return fired;
+}
+
+// Places the detection at the vertex of the parabola through the peak and
+// its neighbours, kept within half a step of the peak window.
+void DecisionEngine::fire_(const Point* next) {
+	int64_t offset = 0;
+	if (next && have_before_) {
+		const float d0 = (float)(int64_t)(before_.pos - peak_.pos);	// <= 0
+		const float d2 = (float)(int64_t)(next->pos - peak_.pos);		// >= 0
+		const float a = before_.smooth - peak_.smooth;
+		const float b = next->smooth - peak_.smooth;
+		const float den = a * d2 - b * d0;
+		if (den != 0.0f) {
+			float x = 0.5f * (a * d2 * d2 - b * d0 * d0) / den;
+			if (x < 0.5f * d0) x = 0.5f * d0;
+			if (x > 0.5f * d2) x = 0.5f * d2;
+			offset = (int64_t)lroundf(x);
+		}
+	}
+	last_.at = peak_.pos + offset;
+	last_.peak = peak_.smooth;
+	last_.p_conf = peak_.p;
+	hits_any_ = true;
+	armed_ = false;
+	stats_.hits++;
+}
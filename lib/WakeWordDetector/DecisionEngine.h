@@ -0,0 +1,89 @@
+#pragma once
+#include <stdint.h>
+#include "env.h"
+#include "frontend_params.h"
+
+// Turns per-window posteriors into detections, without ever waiting.
+//   smoothing:  mean of the last smooth_n posteriors
+//   peak:       once the mean reaches `threshold`, the detection is held
+//               until the mean stops rising (at most peak_wait more
+//               posteriors) and placed at the peak, interpolated between
+//               the neighbouring windows
+//   refractory: for `refractory` samples of stream time after a detection,
+//               threshold crossings are counted but not reported
+// Positions are stream sample positions (AudioCapture::position() past the
+// window's newest sample), so timestamps resolve below a hop and the
+// refractory period holds in stream time however late inference runs.
+// Capture, frontend and inference keep running throughout.
+class DecisionEngine {
+public:
+	static const int kMaxSmooth = 16;
+
+	struct Config {
+		int			smooth_n = DECISION_SMOOTH_N;		// 1..kMaxSmooth
+		float		threshold = WAKE_PROB_THRESH;
+		float		near_miss = DECISION_NEAR_MISS;		// peaks from here to threshold count as near misses
+		int			peak_wait = DECISION_PEAK_WAIT;
+		uint32_t	refractory = (uint32_t)((uint64_t)KWS_SAMPLE_RATE_HZ * DETECTION_COOLDOWN_MS / 1000);
+	};
+
+	struct Detection {
+		uint64_t	at;			// stream position of the interpolated peak
+		float		peak;		// smoothed posterior there
+		float		p_conf;		// raw posterior of the peak window
+	};
+
+	struct Stats {
+		uint32_t	decisions;		// posteriors seen, gated hops' zeros included
+		uint32_t	hits;			// detections reported
+		uint32_t	near_misses;	// excursions that peaked between near_miss and threshold
+		uint32_t	suppressed;		// threshold crossings inside a refractory period
+		float		best_miss;		// highest near-miss peak
+	};
+
+	DecisionEngine();
+	explicit DecisionEngine(const Config& cfg);
+	// Clears everything: stats, the last detection and the smoothing.
+	void reset();
+	// Takes effect from the next posterior. Keeps stats() and the last
+	// detection, so its refractory period still holds; restarts the
+	// smoothing and drops a detection still waiting for its peak.
+	void setConfig(const Config& cfg);
+	const Config& config() const { return cfg_; }
+
+	// p: posterior of the window ending at pos; positions never go back.
+	// True when a detection completed, described by detection().
+	bool update(float p, uint64_t pos);
+
+	float smoothed() const { return smooth_; }
+	bool refractory(uint64_t pos) const { return hits_any_ && pos < last_.at + cfg_.refractory; }
+	const Detection& detection() const { return last_; }
+	const Stats& stats() const { return stats_; }
+
+private:
+	struct Point {
+		uint64_t	pos;
+		float		smooth;
+		float		p;
+	};
+
+	Config		cfg_;
+	Stats		stats_;
+	float		hist_[kMaxSmooth];
+	int			hist_i_;
+	float		smooth_;
+	Point		prev_;			// the decision before cur
+	bool		have_prev_;
+	bool		armed_;			// waiting for the peak
+	Point		before_;		// the decision before peak_
+	bool		have_before_;
+	Point		peak_;
+	int			wait_;
+	bool		above_;			// smooth_ was at or over the threshold
+	float		excursion_;		// max of the current run over near_miss, 0 outside one
+	bool		hits_any_;
+	Detection	last_;
+
+	void fire_(const Point* next);
+	void restart_();		// smoothing and peak state only
+};
@@ -0,0 +1,40 @@
+#include "InferenceScheduler.h"
+#include <string.h>
+
+InferenceScheduler::InferenceScheduler() : InferenceScheduler(Policy()) {}
+
+InferenceScheduler::InferenceScheduler(const Policy& policy) : policy_(policy) {
+	reset();
+}
+
+void InferenceScheduler::reset() {
+	memset(&counters_, 0, sizeof(counters_));
+	since_run_ = 0;
+	alert_left_ = 0;
+}
+
+bool InferenceScheduler::shouldRun(bool audio_active) {
+	counters_.hops++;
+	since_run_++;
+	if (!audio_active) {
+		alert_left_ = 0;
+		counters_.skipped_silence++;
+		return false;
+	}
+	if (alert_left_ > 0) {
+		alert_left_--;
+		counters_.alert_hops++;
+	} else if (since_run_ < policy_.idle_stride) {
+		counters_.skipped_cadence++;
+		return false;
+	}
+	since_run_ = 0;
+	counters_.inferences++;
+	return true;
+}
+
+void InferenceScheduler::onResult(float p_conf, float p_avg) {
+	if (p_conf >= policy_.suspicious || p_avg >= policy_.suspicious) {
+		alert_left_ = policy_.alert_hold;
+	}
+}
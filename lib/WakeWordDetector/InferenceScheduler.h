@@ -0,0 +1,52 @@
+#pragma once
+#include <stdint.h>
+#include "env.h"
+
+// Decides, once per hop, whether the network runs on the current window.
+//   idle:    every idle_stride hops while nothing looks like the keyword
+//   alert:   every hop once the wake class's probability (raw or smoothed)
+//            reaches `suspicious`, held for alert_hold hops after the last
+//            suspicious result; confident non-wake classes keep it idle
+//   silence: never while the voice gate is closed
+// A 650 ms window shifted by idle_stride hops still covers any keyword, so
+// the idle stride only adds up to idle_stride - 1 hops of latency before the
+// alert cadence takes over.
+class InferenceScheduler {
+public:
+	struct Policy {
+		int		idle_stride = KWS_IDLE_STRIDE_HOPS;
+		float	suspicious = KWS_SUSPICIOUS_PROB;
+		int		alert_hold = KWS_ALERT_HOLD_HOPS;
+	};
+
+	struct Counters {
+		uint32_t	hops;
+		uint32_t	inferences;
+		uint32_t	skipped_silence;
+		uint32_t	skipped_cadence;
+		uint32_t	alert_hops;		// hops spent at the every-hop cadence
+	};
+
+	InferenceScheduler();
+	explicit InferenceScheduler(const Policy& policy);
+	void reset();
+	void setPolicy(const Policy& policy) { policy_ = policy; }
+	const Policy& policy() const { return policy_; }
+
+	// audio_active: false when the hop is below the noise floor.
+	bool shouldRun(bool audio_active);
+	// p_conf: probs[WAKE_CLASS_INDEX] of the window just run; p_avg: its
+	// smoothed value (DecisionEngine::smoothed()).
+	void onResult(float p_conf, float p_avg);
+
+	bool alert() const { return alert_left_ > 0; }
+	const Counters& counters() const { return counters_; }
+	// Share of hops that ran the network (1.0 = continuous per-hop inference).
+	float duty() const { return counters_.hops ? (float)counters_.inferences / (float)counters_.hops : 0.0f; }
+
+private:
+	Policy		policy_;
+	Counters	counters_;
+	int			since_run_;
+	int			alert_left_;
+};
@@ -1,52 +1,176 @@
 #include "WakeWordDetector.h"
 #include "frontend_params.h"
+#include "env.h"
 #include <Arduino.h>
+#include "Trace.h"
+#include "CycleCounter.h"
 
 bool WakeWordDetector::begin() {
 	Serial.println("DEBUG: WakeWordDetector begin");
+	// A model with int8 input reads the integer frontend's rows in place
+	// instead of quantizing a float window per inference. The VAD then
+	// gates on energy alone (no power spectrum).
+#if KWS_MODEL_BLOB
+	const bool int8_input = net_.header() && net_.header()->in_type == kTypeI8;
+#elif KWS_MODEL_INT8
+	const bool int8_input = true;
+#else
+	const bool int8_input = false;
+#endif
+	if (int8_input && !proc_.setMode(AudioProcessor::Mode::Int8)) {
+		Serial.println("DEBUG: int8 frontend unavailable, the model quantizes float rows");
+	}
+	Serial.printf("DEBUG: frontend %s\n", proc_.mode() == AudioProcessor::Mode::Int8 ? "int8" : "float");
 	return true;
 }
 
 bool WakeWordDetector::detect_once(float& p_conf, float& p_avg) {
-	Serial.println("DEBUG: detect_once started");
-	int16_t pcm[AP_FRAME_SAMPLES];
-	if (!cap_.readFrame(pcm)) {
-		Serial.println("DEBUG: readFrame failed");
+	if (!captureHop() && hops_.empty()) {
 		p_conf = 0.0f;
-		p_avg = p_avg_;
-		Serial.flush();
+		p_avg = decision_.smoothed();
 		return false;
 	}
-	Serial.println("DEBUG: readFrame succeeded");
-
-	proc_.processFrame(pcm);
-	Serial.println("DEBUG: processFrame called");
+	return inferPending(p_conf, p_avg);
+}
 
-	float mfcc[KWS_FRAMES * KWS_NUM_MFCC];
-	proc_.computeMFCCFloat(mfcc);
-	Serial.println("DEBUG: computeMFCCFloat called");
+bool WakeWordDetector::captureHop() {
+	int16_t hop[AP_HOP_SAMPLES];
+	if (!cap_.readHop(hop)) {
+		stats_.read_errors++;
+		return false;
+	}
 
-	p_conf = net_.predict_proba(mfcc);
-	Serial.printf("DEBUG: predict_proba returned p_conf=%.4f\n", p_conf);
+	// Windows overlap by half: each 10 ms hop completes a new 20 ms frame.
+	if (!framer_.pushHop(hop)) return false;
+	uint32_t t0 = cycles();
+	proc_.processFrame(framer_.window());
+	telemetry::record(telemetry::STAGE_FRONTEND, cycles() - t0);
+	stats_.hops++;
+
+	bool active = true;
+#if VAD_ENABLED
+	t0 = cycles();
+	active = vad_.update(proc_.lastPcmRms(), proc_.lastPower());
+	telemetry::record(telemetry::STAGE_VAD, cycles() - t0);
+#endif
+	// A full queue drops the event, not the audio: the row is already on
+	// the bus and the next inference reads the newest window anyway.
+	const uint32_t seq = proc_.features().seq();
+	TRACE(HOP_QUEUED, seq, active);
+	const uint64_t at = cap_.position();
+	return hops_.write(HopEvent{ seq, active, cap_.sampleTimeUs(at), at });
+}
 
-	p_avg_ = 0.9f * p_avg_ + 0.1f * p_conf;
-	p_avg = p_avg_;
+bool WakeWordDetector::inferPending(float& p_conf, float& p_avg) {
+	p_conf = 0.0f;
+	int runs = 0;
+	bool fired = false;
+	// Drain everything queued so far in place, then release it in one go.
+	const RingBuffer<HopEvent, KWS_HOP_QUEUE_LEN>::Spans s = hops_.peek();
+	for (size_t i = 0; i < s.first_n; ++i) fired |= schedule_(s.first[i], runs);
+	for (size_t i = 0; i < s.second_n; ++i) fired |= schedule_(s.second[i], runs);
+	HopEvent newest = {};
+	if (s.size()) newest = s.second_n ? s.second[s.second_n - 1] : s.first[s.first_n - 1];
+	hops_.consume(s.size());
+	p_avg = decision_.smoothed();
+	if (runs == 0) return fired;
+	// A lagging consumer runs once, on the newest window, which covers the
+	// audio of every hop that asked for a run.
+	stats_.coalesced += runs - 1;
+	TRACE(INFER_BEGIN, proc_.features().seq(), runs);
+	fired |= infer_(newest.at, p_conf, p_avg);
+	// The window can be newer than the queued hops, never older, so this
+	// bounds the latency from above.
+	telemetry::record(telemetry::STAGE_LATENCY, micros() - newest.t_us);
+	return fired;
+}
 
-	bool detected = p_conf >= WAKE_PROB_THRESH;
-	if (detected) {
-		Serial.println("DEBUG: Wake word detected!");
+bool WakeWordDetector::schedule_(const HopEvent& ev, int& runs) {
+	if (sched_.shouldRun(ev.active)) {
+		runs++;
+		return false;
 	}
-	Serial.printf("DEBUG: detect_once done, p_conf=%.4f, p_avg=%.4f\n", p_conf, p_avg);
-	Serial.flush();
-	return detected;
+	// Silence counts as a zero posterior, which ends a pending peak and
+	// drains the smoothing window; a cadence skip leaves the decision alone.
+	// The frontend keeps the feature history current either way.
+	const bool fired = !ev.active && decision_.update(0.0f, ev.at);
+	if (fired) TRACE(DETECTION, decision_.detection().peak, decision_.detection().at);
+	const InferenceScheduler::Counters& sc = sched_.counters();
+	if (TRACE_ON(SCHED_DUTY) && sc.hops % 100 == 0) {
+		TRACE(SCHED_DUTY, sched_.duty(), vad_.gatedShare());
+	}
+	return fired;
 }
 
+bool WakeWordDetector::infer_(uint64_t at, float& p_conf, float& p_avg) {
+	// Read the window straight from the feature bus. The int8 models take
+	// int8 rows in place; otherwise only a format mismatch needs a converted copy.
+	FeatureWindow w;
+	proc_.features().window(w);
+	const uint32_t t0 = cycles();
+#if !KWS_MODEL_STREAMS
+	if (w.mfcc_q) {
+		p_conf = net_.predict_proba_q(w.mfcc_q);
+	} else {
+		p_conf = net_.predict_proba(w.mfcc);
+	}
+#else
+	const float* mfcc = w.mfcc;
+	if (!mfcc) {
+		// From w itself, so the rows match w.seq; valid(w) below covers the copy.
+		for (int i = 0; i < KWS_FRAMES * KWS_NUM_MFCC; ++i) mfcc_dq_[i] = FeatureBus::dequantize(w.mfcc_q[i]);
+		mfcc = mfcc_dq_;
+	}
+	// Consecutive windows only differ in a few rows, so the float model runs
+	// incrementally; a format switch rewrites every row and restarts it.
+	if (w.gen != stream_gen_) {
+		net_.reset_stream();
+		stream_gen_ = w.gen;
+	}
+	p_conf = net_.predict_proba_stream(mfcc, w.seq);
+#endif
+	telemetry::record(telemetry::STAGE_INFERENCE, cycles() - t0);
+	if (!proc_.features().valid(w)) {
+		TRACE(INFER_OVERWRITTEN, w.seq, 0);
+#if KWS_MODEL_STREAMS
+		net_.reset_stream();
+#endif
+		stats_.overwritten++;
+		p_conf = 0.0f;
+		p_avg = decision_.smoothed();
+		return false;
+	}
 
+	const bool detected = decision_.update(p_conf, at);
+	p_avg = decision_.smoothed();
+	sched_.onResult(p_conf, p_avg);
+	TRACE(INFER_RESULT, p_conf, p_avg);
+	if (detected) TRACE(DETECTION, decision_.detection().peak, decision_.detection().at);
+	return detected;
+}
 
+WakeWordDetector::PipelineStats WakeWordDetector::pipelineStats() const {
+	PipelineStats s = stats_;
+	s.detections = decision_.stats().hits;
+	s.queue_drops = hops_.overruns();
+	s.backlog_max = hops_.highWater();
+	return s;
+}
 
-
-
-
-
-
-
+telemetry::Counters WakeWordDetector::counters() const {
+	const InferenceScheduler::Counters& sc = sched_.counters();
+	const AudioCapture::Stats& cs = cap_.stats();
+	telemetry::Counters c = {};
+	c.hops = stats_.hops;
+	c.gated_hops = sc.skipped_silence;
+	c.inferences = sc.inferences - stats_.coalesced;	// runs the scheduler asked for, less those folded together
+	c.detections = decision_.stats().hits;
+	c.near_misses = decision_.stats().near_misses;
+	c.suppressed = decision_.stats().suppressed;
+	c.dropped_samples = cs.dropped;
+	c.overflows = cs.overflows;
+	c.queue_drops = hops_.overruns();
+	c.coalesced = stats_.coalesced;
+	c.overwritten = stats_.overwritten;
+	return c;
+}
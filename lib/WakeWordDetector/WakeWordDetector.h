@@ -3,31 +3,91 @@
 
 #include "AudioCapture.h"
 #include "AudioProcessor.h"
+#include "env.h"
+#if KWS_MODEL_BLOB
+#include "ModelRuntime.h"
+typedef ModelRuntime KwsModel;
+#elif KWS_MODEL_INT8
+#include "Int8DSCNN.h"
+typedef Int8DSCNN KwsModel;
+#else
 #include "ManualDSCNN.h"
-
-class WakeWordDetector {
-public:
-  WakeWordDetector(AudioCapture& cap, AudioProcessor& proc, ManualDSCNN& net)
-    : cap_(cap), proc_(proc), net_(net) {}
-  bool begin();
-  bool detect_once(float& p_conf, float& p_avg);
-
-private:
-  AudioCapture& cap_;
-  AudioProcessor& proc_;
-  ManualDSCNN& net_;
-  float p_avg_ = 0.0f;
-};
-
+typedef ManualDSCNN KwsModel;
 #endif
+#include "Framer.h"
+#include "RingBuffer.h"
+#include "VadGate.h"
+#include "InferenceScheduler.h"
+#include "DecisionEngine.h"
+#include "Telemetry.h"
 
+// Only the float ManualDSCNN keeps per-row state between windows.
+#define KWS_MODEL_STREAMS (!KWS_MODEL_BLOB && !KWS_MODEL_INT8)
 
+// One published frontend row, handed from capture to inference.
+struct HopEvent {
+	uint32_t	seq;	// FeatureBus::seq() after the row was published
+	bool		active;	// voice gate state for the hop
+	uint32_t	t_us;	// micros() when the hop's newest sample was taken
+	uint64_t	at;		// stream position just past that sample
+};
 
+// Producer side (captureHop) and consumer side (inferPending) may run on
+// different cores: they only share the FeatureBus, which is safe for that,
+// and the hop queue. detect_once() runs both in turn on one task.
+class WakeWordDetector {
+public:
+	struct PipelineStats {
+		uint32_t	hops;			// rows the frontend published
+		uint32_t	read_errors;	// failed I2S reads
+		uint32_t	queue_drops;	// hops refused by a full queue (inference lagged > KWS_HOP_QUEUE_LEN)
+		uint32_t	backlog_max;	// queue high-water mark
+		uint32_t	coalesced;		// queued hops folded into a newer window instead of run
+		uint32_t	overwritten;	// windows the frontend overwrote during inference
+		uint32_t	detections;		// DecisionEngine hits
+	};
 
+	WakeWordDetector(AudioCapture& cap, AudioProcessor& proc, KwsModel& net)
+		: cap_(cap), proc_(proc), net_(net) {}
+	// After the frontend's begin() and the model's load/begin(): switches the
+	// frontend to int8 rows when the model takes int8 input.
+	bool begin();
+	bool detect_once(float& p_conf, float& p_avg);
 
+	// Producer: read one hop, run the frontend and the voice gate, queue the
+	// row. Never blocks on inference; false when no row was queued.
+	bool captureHop();
+	// Consumer: drain the queued hops through the scheduler and run the
+	// network once on the newest window if any of them asked for it. Returns
+	// true on a detection (see decision().detection()); p_conf is 0 when
+	// nothing ran, p_avg is the smoothed posterior.
+	bool inferPending(float& p_conf, float& p_avg);
+	bool pending() const { return !hops_.empty(); }
 
+	PipelineStats pipelineStats() const;
+	// Everything telemetry::Counters holds, from the detector, scheduler and capture.
+	telemetry::Counters counters() const;
+	const VadGate& vad() const { return vad_; }
+	InferenceScheduler& scheduler() { return sched_; }
+	DecisionEngine& decision() { return decision_; }
 
+private:
+	AudioCapture& cap_;
+	AudioProcessor& proc_;
+	KwsModel& net_;
+	Framer framer_;
+	VadGate vad_;
+	InferenceScheduler sched_;
+	DecisionEngine decision_;
+	RingBuffer<HopEvent, KWS_HOP_QUEUE_LEN> hops_;
+	PipelineStats stats_ = {};
+#if KWS_MODEL_STREAMS
+	float mfcc_dq_[KWS_FRAMES * KWS_NUM_MFCC];	// only used when the frontend runs int8
+	uint32_t stream_gen_ = 0;					// bus generation the streaming state belongs to
+#endif
 
+	bool schedule_(const HopEvent& ev, int& runs);
+	bool infer_(uint64_t at, float& p_conf, float& p_avg);
+};
 
-
-
+#endif
@@ -0,0 +1,106 @@
+#pragma once
+
+// Generated by tools/model_compiler.py from models/model_weights_float.h. Do not edit.
+// ManualDSCNN weights with every BatchNorm folded into the next linear
+// layer, in the layout its kernels read them. Shapes and CRC-32s are in
+// models/model_float_manifest.json.
+// Dropped (unused by the float network): 23 arrays.
+
+// fp_conv_w 9x16: [tap][oc], tap = (kt + 1) * 3 + (kf + 1), crc32 004ddfe4
+alignas(16) constexpr float fp_conv_w[144] = {
+  0.100335322f, 0.0957867131f, -0.0717111453f, 0.218748942f, -0.213983715f, 0.0176951513f, 0.200806379f, -0.159964085f,
+  -0.0588502176f, 0.0301331747f, -0.0714505985f, 0.122828722f, 0.148007423f, -0.0846852511f, 0.0839138031f, 0.0743279159f,
+  -0.195103049f, -0.150678769f, -0.105654031f, -0.24067831f, -0.207512677f, 0.262069851f, 0.188474745f, -0.0938382968f,
+  0.12579836f, -0.174001053f, 0.0611085892f, -0.0447636992f, 0.144532874f, -0.216706008f, -0.172525436f, 0.193329766f,
+  -0.22281979f, -0.0209104624f, -0.0252425633f, 0.133031353f, 0.0810810104f, -0.131469563f, -0.113352664f, 0.146950826f,
+  -0.278534502f, 0.0766031072f, 0.0536663458f, -0.0324288979f, 0.203885123f, 0.0670994148f, 0.00874485262f, -0.12591511f,
+  -0.142820328f, 0.0108494796f, 0.0774815679f, 0.0801728293f, -0.128078684f, -0.135385901f, 0.121670164f, 0.154625148f,
+  -0.0358174331f, -0.0535124615f, -0.0865677744f, -0.107831381f, -0.0449697189f, 0.0639425293f, -0.0946732238f, 0.0985611901f,
+  0.0126705123f, 0.0903267264f, -0.177215055f, -0.0842661783f, 0.137799129f, 0.0680891126f, 0.124778584f, 0.1409356f,
+  0.174952179f, 0.00649848161f, 0.102998085f, -0.208181188f, 0.111579888f, 0.0440697037f, 0.00515265716f, -0.136484593f,
+  -0.12030372f, 0.13305445f, -0.100266218f, 0.124732301f, -0.0831243098f, -0.0519022048f, 0.0970745459f, 0.223749653f,
+  -0.0452803262f, -0.0112450765f, 0.176833302f, 0.0772191882f, -0.042303361f, -0.223957658f, 0.142081693f, -0.112695254f,
+  0.0911053792f, 0.228409693f, 0.0356151052f, -0.068286024f, 0.254971713f, 0.170167759f, -0.177991763f, -0.146139592f,
+  -0.0532834902f, 0.123611122f, -0.122803085f, -0.0863532051f, 0.118055336f, -0.017119715f, -0.121535555f, 0.0583921112f,
+  0.134499535f, 0.125202045f, -0.0220181029f, -0.170654535f, 0.128156915f, -0.178243369f, -0.110753007f, -0.133146659f,
+  0.113024257f, -0.222827658f, -0.155719012f, 0.165583342f, -0.0931496024f, -0.0149264326f, 0.192340732f, -0.199628711f,
+  0.275844783f, -0.229306042f, 0.163904294f, 0.0413976386f, 0.0874323174f, -0.061228618f, -0.00213862071f, -0.0488006994f,
+  -0.0464786105f, -0.139270261f, 0.355936438f, -0.192540422f, -0.313730121f, -0.136877567f, -0.0107699046f, 0.103752442f,
+};
+
+// fp_pw_w 24x16: [oc][ic], BN7 folded in, crc32 d99883a9
+alignas(16) constexpr float fp_pw_w[384] = {
+  0.172605634f, -0.0260992851f, 0.0214121807f, -0.0179590769f, -0.124586888f, -0.0641311631f, -0.0263539385f, 0.0772420317f,
+  -0.0183929186f, -0.0202433094f, 0.00233115675f, -0.0272506401f, 0.0380303711f, 0.0427843407f, -0.0749996006f, 0.0499396287f,
+  -0.0166493542f, 0.00415055361f, 0.0574695729f, -0.0393102542f, 0.116583116f, 0.0123976143f, 0.0182734728f, -0.0341259167f,
+  -0.0174958985f, -0.00261058984f, 0.0467083044f, 0.0207706206f, -0.0262422729f, 0.00200197008f, -0.150813431f, 0.0461727306f,
+  0.00313529954f, 0.0277366694f, -0.0698509812f, -0.0251487512f, 0.0461777598f, 0.0253094155f, -0.0152781811f, -0.0172375552f,
+  0.0321505181f, -0.0191239789f, -0.0335524529f, -0.0560085289f, -0.0151075833f, 0.0820252523f, -0.150863573f, 0.0269267242f,
+  -0.0792044103f, 0.0127401091f, -0.0185407661f, 0.0175465308f, -0.046732761f, 0.0407236181f, 0.0496917032f, 0.083914943f,
+  -0.0337543301f, 0.0066451407f, 0.020902317f, 0.0975040272f, 0.0329986587f, -0.0668196306f, 0.0145596517f, -0.00791618042f,
+  -0.11624071f, 0.0185129009f, -0.0121804653f, -0.00357962982f, 0.128288552f, 0.0418152697f, -0.0159127265f, -0.043931406f,
+  0.00581098255f, -0.0315487385f, 0.0248433221f, -0.0565245673f, 0.00835702103f, 0.0889167488f, -0.117557153f, 0.0346947126f,
+  0.105539426f, -0.0138234822f, 0.0140721174f, 0.00648677396f, -0.118011512f, -0.026260037f, 0.0485258438f, 0.0783122629f,
+  0.0225399025f, 0.0366532914f, -0.0346423462f, -0.150795892f, -0.0157078244f, -0.0352169238f, -0.084541589f, 0.0295474213f,
+  -0.109811448f, 0.0417303108f, -0.0168921277f, 0.0325614884f, -0.113118067f, 0.0259377696f, 0.0329505019f, -0.0626729056f,
+  -0.0176354051f, 0.011599089f, -0.00409455504f, -0.00295879249f, -0.0377006307f, 0.054497093f, 0.0627286732f, -0.0367271267f,
+  0.00456935354f, 0.0117362114f, -0.0575512126f, 0.033974953f, -0.0207418986f, 0.061675448f, -0.050483916f, 0.128362358f,
+  0.026431771f, 0.024888359f, 0.0237118248f, -0.106996641f, 0.0173844118f, 0.0182958245f, -0.12454246f, -0.00385753508f,
+  -0.110497743f, -0.0469948836f, 0.0429217704f, 0.00990126189f, 0.0684441328f, -0.0497582294f, -0.0249820612f, 0.13300778f,
+  0.0290268604f, -0.0404674299f, 0.00769942906f, -0.00814757403f, 0.0597196408f, 0.00367655093f, -0.0146020595f, 0.0282537173f,
+  -0.150812656f, -0.0112162502f, -0.0634014234f, 0.00181706867f, 0.00545095839f, -0.0913517401f, -0.00239467761f, -0.135721058f,
+  -0.0201853942f, 0.0264422093f, 0.0380280986f, 0.104516163f, 0.00743216602f, 0.0350533687f, -0.0913333446f, -0.0460558645f,
+  -0.0439656153f, 0.057565432f, 0.026942011f, -0.0113538159f, -0.112419017f, -0.00119952345f, -0.020981865f, 0.0460658222f,
+  -0.0108739035f, -0.0391062051f, 0.0390397198f, -0.179115131f, -0.0327196382f, 0.0238788053f, 0.0158961974f, -0.0470213741f,
+  0.0616620257f, 0.0119988602f, 0.00998466369f, -0.0240827333f, 0.0437184796f, 0.0826305225f, -0.034880165f, 0.0884941146f,
+  0.0227260105f, 0.0539858639f, -0.0036039839f, -0.0648063868f, 0.0184082668f, -0.102465332f, -0.161362603f, 0.0446565934f,
+  -0.00895121321f, 0.0179269463f, 0.0569027476f, 0.0034862156f, -0.0130472267f, 0.076948151f, -0.0326649733f, 0.0968022048f,
+  -0.0288430471f, 0.0204559155f, -0.0552948043f, 0.0771553889f, 0.0594461076f, 0.0276878905f, 0.0947686508f, 0.0289303157f,
+  0.12583366f, 0.0219931006f, 0.0240030941f, 0.0181747172f, -0.0264125913f, 0.0503877774f, 0.0171929821f, -0.084546335f,
+  0.0104032326f, 0.0541567542f, -0.0942000523f, -0.0734699592f, -0.0109529737f, -0.0543439314f, 0.0501183197f, -0.0124513786f,
+  -0.0352257155f, -0.010410673f, -0.00770144723f, 0.00723085552f, -0.0102056274f, 0.0626626313f, -0.0440780222f, -0.150627255f,
+  -0.00746829016f, 0.00722473301f, -0.0771012977f, 0.0354537219f, 0.0331304818f, -0.0948007852f, -0.0461292863f, -0.0104528368f,
+  -0.0217489637f, -0.0452335998f, -0.0178611372f, -0.012617819f, 0.112091713f, 0.103016831f, 0.00679097697f, 0.0130634336f,
+  0.0317032151f, 0.0456889756f, -0.00947666913f, 0.0253544748f, 0.00272430852f, 0.00563156744f, -0.0743039027f, 0.0605715364f,
+  -0.00873738434f, 0.000635085395f, -0.0479931682f, -0.0135159213f, -0.0391860791f, -0.00106387015f, -0.0275537446f, 0.0438446924f,
+  -0.0270270705f, -0.00237980299f, -0.034239471f, -0.00130525033f, 0.0124245528f, -0.0435838439f, -0.0843723491f, 0.0336752981f,
+  0.0100651793f, 0.0497570112f, -0.0577266961f, 0.000191949322f, -0.0656100735f, -0.0811712146f, -0.0242523048f, 0.0922538638f,
+  -0.0174683332f, -0.0581544116f, -0.0468095094f, -0.0311910361f, -0.0150355743f, -0.0126806097f, -0.0258155558f, -0.0163931213f,
+  -0.0824171379f, -0.0354848579f, -0.0746672824f, -0.0278345942f, 0.0172086917f, 0.0278205238f, -0.0082412865f, -0.119824506f,
+  0.00994880963f, -0.0705085024f, -0.00956015661f, 0.00745549565f, 0.035940364f, -0.00892688707f, 0.0483621284f, -0.0209786929f,
+  -0.0181776155f, -0.0330093876f, 0.0207363833f, -0.000855668681f, 0.120273851f, -0.0240659248f, 0.00674486673f, 0.16962862f,
+  -0.0096235415f, 0.0451758727f, -0.0619245805f, -0.00168475637f, -0.0311691891f, -0.076954633f, 0.0470382608f, 0.044870127f,
+  -0.0561031252f, 0.00591032393f, 0.0389595591f, -0.0131797511f, 0.0657830834f, -0.0507489927f, 0.0159266237f, 0.0483250283f,
+  -0.0362054668f, 0.0183086358f, 0.00279639498f, 0.00788213592f, -0.0635002106f, 0.0337448716f, -0.0975182727f, -0.0408870056f,
+  0.137530163f, 0.00296283443f, -0.0153843723f, -0.0307141077f, 0.0572823212f, 0.0980610475f, 0.045544859f, 0.0262454711f,
+  -0.0301060621f, -0.0445299745f, -0.00161693001f, -0.0538891777f, -0.00258688326f, 0.032995861f, -0.0677121803f, -0.0012415105f,
+  -0.138764456f, 0.000677068485f, 0.0161102396f, -0.00822437089f, -0.103033453f, 0.0325365551f, 0.00879192445f, -0.0536810346f,
+  0.0336301513f, 0.0374178365f, 0.00905822683f, 0.114029363f, 0.0367704742f, -0.0868989378f, -0.0237916633f, -0.0280720592f,
+  -0.1358376f, 0.0369537137f, -0.0350194685f, -0.00657879096f, -0.0654483065f, 0.00867782626f, -0.000557920663f, 0.001525047f,
+  -0.0320001803f, 0.037887603f, -0.0305455774f, 0.114184931f, 0.00590088544f, 0.00775173865f, 0.014613024f, -0.0597596914f,
+};
+
+// fp_pw_b 24: [oc], BN7 shift folded in, crc32 aeee75cf
+alignas(16) constexpr float fp_pw_b[24] = {
+  -0.161446333f, 0.0641914234f, 0.454383969f, 0.160736993f, 0.244873345f, -0.134144872f, -0.0283861924f, -0.0182596743f,
+  -0.238389537f, -0.0537887216f, -0.310754329f, 0.257826805f, 0.124573492f, 0.192811504f, 0.364214152f, 0.318338633f,
+  0.13007459f, -0.0359975547f, 0.414871544f, -0.349476516f, -0.460981429f, 0.352027059f, 0.286394924f, 0.105806679f,
+};
+
+// fp_dense_w 3x24: [oc][ic], BN9 folded in (zero stub), crc32 ebf26a52
+alignas(16) constexpr float fp_dense_w[72] = {
+  0.0f, 0.0f, 0.0f, 0.0f, 0.0f, 0.0f, 0.0f, 0.0f,
+  0.0f, 0.0f, 0.0f, 0.0f, 0.0f, 0.0f, 0.0f, 0.0f,
+  0.0f, 0.0f, 0.0f, 0.0f, 0.0f, 0.0f, 0.0f, 0.0f,
+  0.0f, 0.0f, 0.0f, 0.0f, 0.0f, 0.0f, 0.0f, 0.0f,
+  0.0f, 0.0f, 0.0f, 0.0f, 0.0f, 0.0f, 0.0f, 0.0f,
+  0.0f, 0.0f, 0.0f, 0.0f, 0.0f, 0.0f, 0.0f, 0.0f,
+  0.0f, 0.0f, 0.0f, 0.0f, 0.0f, 0.0f, 0.0f, 0.0f,
+  0.0f, 0.0f, 0.0f, 0.0f, 0.0f, 0.0f, 0.0f, 0.0f,
+  0.0f, 0.0f, 0.0f, 0.0f, 0.0f, 0.0f, 0.0f, 0.0f,
+};
+
+// fp_dense_b 3: [oc], BN9 shift folded in, crc32 6cc5aba1
+alignas(16) constexpr float fp_dense_b[3] = {
+  -0.100031652f, 0.128862083f, -0.158718333f,
+};
@@ -0,0 +1,162 @@
+#pragma once
+#include <cstdint>
+
+// Generated by tools/export_int8_quant.py from lib/ManualDSCNN/model_int8.cc.bak. Do not edit.
+// Requantization of the int8 DS-CNN in models/model_weights.h, in execution
+// order. x_mult/x_shift: q = MultiplyByQuantizedMultiplier(acc, mult, shift),
+// per output channel (one entry for per-tensor layers); x_out_zp and
+// x_act_min/max give the output zero point and clamp range.
+
+// conv
+constexpr int32_t q8_conv_mult[16] = {
+  1678348667, 1869604460, 1694758333, 1285627606, 1206275446, 1834451332, 1207852251, 1121989413,
+  1701805289, 1966215308, 1602453501, 2003900278, 1446107678, 1463388133, 1924385600, 1802817453,
+};
+constexpr int8_t q8_conv_shift[16] = {
+  -5, -7, -7, -7, -5, -6, -6, -5,
+  -7, -7, -6, -6, -6, -6, -6, -7,
+};
+constexpr int32_t q8_conv_in_zp = 58;
+constexpr int32_t q8_conv_out_zp = -128;
+constexpr int32_t q8_conv_act_min = -128;
+constexpr int32_t q8_conv_act_max = 127;
+
+// b1_dw
+constexpr int32_t q8_b1_dw_mult[16] = {
+  1516300160, 1264270080, 1909343872, 1581717248, 1842046720, 1264849024, 1196422400, 2042015104,
+  1509930112, 1850122368, 1418434560, 1504883328, 1855602176, 2045743232, 1303676800, 1805938688,
+};
+constexpr int8_t q8_b1_dw_shift[16] = {
+  -6, -5, -7, -6, -7, -5, -5, -6,
+  -6, -5, -7, -7, -6, -7, -7, -6,
+};
+constexpr int32_t q8_b1_dw_in_zp = -128;
+constexpr int32_t q8_b1_dw_out_zp = -128;
+constexpr int32_t q8_b1_dw_act_min = -128;
+constexpr int32_t q8_b1_dw_act_max = 127;
+
+// b1_pw
+constexpr int32_t q8_b1_pw_mult[24] = {
+  1708244224, 1334154112, 1119460352, 1632787328, 2030828544, 1315591808, 1542261760, 1731195264,
+  1573892736, 1875550336, 1791506816, 1919611008, 1314270976, 1120536704, 1274054016, 1715462912,
+  1716739968, 1815280128, 1413823360, 1383122560, 1128217344, 1383220352, 1637868288, 1402495360,
+};
+constexpr int8_t q8_b1_pw_shift[24] = {
+  -7, -6, -7, -7, -8, -7, -7, -7,
+  -7, -8, -7, -7, -7, -6, -6, -7,
+  -7, -7, -8, -7, -6, -7, -7, -7,
+};
+constexpr int32_t q8_b1_pw_in_zp = -128;
+constexpr int32_t q8_b1_pw_out_zp = -128;
+constexpr int32_t q8_b1_pw_act_min = -128;
+constexpr int32_t q8_b1_pw_act_max = 127;
+
+// pool1
+constexpr int32_t q8_pool1_in_zp = -128;
+constexpr int32_t q8_pool1_out_zp = -128;
+constexpr int32_t q8_pool1_act_min = -128;
+constexpr int32_t q8_pool1_act_max = 127;
+
+// b2_dw
+constexpr int32_t q8_b2_dw_mult[24] = {
+  2138854784, 1470565888, 1271761408, 1699968256, 1476211840, 1540566912, 1664023040, 2119033984,
+  1789216768, 1505696000, 1281370240, 1109371136, 1165825920, 1555212160, 1457977984, 1612041472,
+  1561859968, 1738096640, 1180487936, 1598416256, 1374319744, 1351906816, 1956765056, 1958021120,
+};
+constexpr int8_t q8_b2_dw_shift[24] = {
+  -7, -6, -5, -7, -7, -8, -6, -8,
+  -6, -6, -5, -6, -7, -6, -6, -6,
+  -6, -6, -4, -7, -7, -5, -7, -6,
+};
+constexpr int32_t q8_b2_dw_in_zp = -128;
+constexpr int32_t q8_b2_dw_out_zp = -128;
+constexpr int32_t q8_b2_dw_act_min = -128;
+constexpr int32_t q8_b2_dw_act_max = 127;
+
+// b2_pw
+constexpr int32_t q8_b2_pw_mult[32] = {
+  1325944832, 1307781632, 1953440640, 1481473536, 1089913984, 1191130752, 1274737536, 1118004096,
+  1577660288, 1954143744, 1950911744, 1108433664, 1906372864, 1987479552, 1791469184, 1418970240,
+  1571139328, 1669473408, 1294810624, 1209565696, 1175703680, 2007095680, 1359753856, 1076638848,
+  1587422848, 1936814592, 1735018880, 1780689664, 1167827200, 1206008192, 1196586112, 1091542144,
+};
+constexpr int8_t q8_b2_pw_shift[32] = {
+  -7, -7, -7, -7, -7, -6, -7, -7,
+  -7, -7, -7, -7, -8, -7, -8, -8,
+  -7, -7, -8, -7, -7, -8, -7, -7,
+  -7, -8, -8, -7, -7, -7, -7, -7,
+};
+constexpr int32_t q8_b2_pw_in_zp = -128;
+constexpr int32_t q8_b2_pw_out_zp = -128;
+constexpr int32_t q8_b2_pw_act_min = -128;
+constexpr int32_t q8_b2_pw_act_max = 127;
+
+// b3_dw
+constexpr int32_t q8_b3_dw_mult[32] = {
+  1596998656, 1253897600, 1612418816, 1562882176, 1610517504, 1719461888, 1735766784, 1091927296,
+  1480027136, 1399267072, 1929328256, 1196353664, 1214205568, 1653913984, 1520476800, 1633986816,
+  2134609664, 1702476416, 1161060992, 1733083904, 2074215424, 1526755712, 1336014080, 1156112640,
+  1357442560, 1288077312, 1933412992, 1319629184, 1765987840, 1594825344, 1524938112, 1373378432,
+};
+constexpr int8_t q8_b3_dw_shift[32] = {
+  -7, -6, -6, -7, -7, -7, -6, -7,
+  -7, -7, -7, -7, -6, -7, -6, -7,
+  -8, -7, -5, -7, -7, -7, -6, -6,
+  -7, -7, -6, -6, -8, -6, -6, -6,
+};
+constexpr int32_t q8_b3_dw_in_zp = -128;
+constexpr int32_t q8_b3_dw_out_zp = -128;
+constexpr int32_t q8_b3_dw_act_min = -128;
+constexpr int32_t q8_b3_dw_act_max = 127;
+
+// b3_pw
+constexpr int32_t q8_b3_pw_mult[48] = {
+  1533747840, 1260619392, 2124675840, 1152008960, 1142470784, 1998902656, 1536599936, 1340066176,
+  1763721728, 1702951296, 1573830528, 1441509376, 1275580160, 1258828160, 1548899200, 1124858496,
+  1665572480, 1565733248, 1806352896, 1097097856, 1904638208, 1658542592, 1216451584, 1583091968,
+  2050084352, 1090507520, 1482567168, 2006827776, 1352886656, 1705250176, 1490855936, 1200341760,
+  1196607232, 1566118144, 1823088384, 1741890176, 1089046272, 1714894464, 1888963840, 1790332160,
+  1197332992, 1357193600, 1495061504, 1825554944, 1178423552, 1930909440, 1673933696, 1968254080,
+};
+constexpr int8_t q8_b3_pw_shift[48] = {
+  -7, -6, -7, -6, -6, -7, -6, -6,
+  -6, -6, -6, -6, -6, -5, -7, -6,
+  -7, -6, -7, -6, -7, -7, -6, -6,
+  -7, -6, -6, -7, -6, -6, -6, -6,
+  -6, -6, -7, -7, -6, -7, -7, -7,
+  -6, -6, -6, -6, -6, -7, -6, -7,
+};
+constexpr int32_t q8_b3_pw_in_zp = -128;
+constexpr int32_t q8_b3_pw_out_zp = -128;
+constexpr int32_t q8_b3_pw_act_min = -128;
+constexpr int32_t q8_b3_pw_act_max = 127;
+
+// pool2
+constexpr int32_t q8_pool2_in_zp = -128;
+constexpr int32_t q8_pool2_out_zp = -128;
+constexpr int32_t q8_pool2_act_min = -128;
+constexpr int32_t q8_pool2_act_max = 127;
+
+// gap
+constexpr int32_t q8_gap_mult = 1333018059;
+constexpr int q8_gap_shift = 2;
+constexpr int32_t q8_gap_in_zp = -128;
+constexpr int32_t q8_gap_out_zp = -128;
+constexpr int32_t q8_gap_act_min = -128;
+constexpr int32_t q8_gap_act_max = 127;
+
+// dense
+constexpr int32_t q8_dense_mult[1] = {
+  1439676695,
+};
+constexpr int8_t q8_dense_shift[1] = {
+  -10,
+};
+constexpr int32_t q8_dense_in_zp = -128;
+constexpr int32_t q8_dense_out_zp = -39;
+constexpr int32_t q8_dense_act_min = -128;
+constexpr int32_t q8_dense_act_max = 127;
+
+// softmax
+constexpr float q8_softmax_in_scale = 0.0699474439f;
+constexpr int32_t q8_softmax_in_zp = -39;
@@ -1,11 +1,11 @@
 #pragma once
 #include <cstdint>
 
-const float input_scale = 0.6634234189987183f;
-const int32_t input_zero_point = 58;
+constexpr float input_scale = 0.6634234189987183f;
+constexpr int32_t input_zero_point = 58;
 
-const float output_scale = 0.00390625f;
-const int32_t output_zero_point = -128;
+constexpr float output_scale = 0.00390625f;
+constexpr int32_t output_zero_point = -128;
 
 const int32_t ds_cnn_tiny_v2_dense_BiasAdd_ReadVariableOp[] = {
   -2184, 2814, -3466,
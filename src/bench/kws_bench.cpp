@@ -0,0 +1,370 @@
+// Hot-path microbenchmarks, one stage at a time: env:bench on the board,
+// env:native_bench on the host. Every stage runs the production code on
+// fixed synthetic input. Each call is timed on its own with cycles()
+// (CycleCounter.h), less the timer's own overhead, and reported as
+// min/median/p99 together with the bytes the stage reads and writes.
+//
+// The result is one JSON object: on stdout (or -o file) on the host, and
+// between BENCH_JSON_BEGIN/BENCH_JSON_END lines on the board's serial port.
+// tools/bench_compare.py checks it against a stored baseline.
+#include <Arduino.h>
+#include <math.h>
+#include <stdarg.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <algorithm>
+#include <vector>
+
+#include "env.h"
+#include "frontend_params.h"
+#include "AudioProcessor.h"
+#include "CycleCounter.h"
+#include "DSPKernels.h"
+#include "FrontendTables.h"
+#include "Int8DSCNN.h"
+#include "ManualDSCNN.h"
+#include "RingBuffer.h"
+
+#ifndef BENCH_ITERATIONS
+#ifdef ARDUINO
+#define BENCH_ITERATIONS 200
+#else
+#define BENCH_ITERATIONS 2000
+#endif
+#endif
+#define BENCH_WARMUP 10
+
+// Keeps the compiler from dropping or hoisting a stage whose results land
+// in memory nobody reads.
+#define BENCH_CLOBBER() asm volatile("" ::: "memory")
+
+static AudioProcessor	g_proc;
+static ManualDSCNN		g_net;
+static Int8DSCNN		g_int8;
+
+class KwsBench {
+public:
+	explicit KwsBench(int iterations) : samples_(iterations) {}
+
+	void run() {
+		calibrate_();
+		capture_();
+		frontend_();
+		frontendInt8_();
+		model_();
+		modelInt8_();
+	}
+
+	// JSON into buf; false if it did not fit.
+	bool json(char* buf, size_t cap) const {
+		size_t n = 0;
+		bool ok = true;
+		auto put = [&](const char* fmt, ...) {
+			va_list ap;
+			va_start(ap, fmt);
+			const int w = vsnprintf(buf + n, n < cap ? cap - n : 0, fmt, ap);
+			va_end(ap);
+			n += w > 0 ? (size_t)w : 0;
+			ok = ok && n < cap;
+		};
+#ifdef ARDUINO
+		const char* target = "esp32s3";
+#else
+		const char* target = "host";
+#endif
+		put("{\"suite\":\"kws_bench\",\"target\":\"%s\",\"dsp\":\"%s\",\"iterations\":%u,"
+		    "\"cycle_hz\":%llu,\"timer_overhead\":%u,\"stages\":[",
+		    target, dspk::variantName(), (unsigned)samples_.size(),
+		    (unsigned long long)cycleHz(), (unsigned)overhead_);
+		for (size_t i = 0; i < results_.size(); ++i) {
+			const Result& r = results_[i];
+			put("%s\n{\"name\":\"%s\",\"min\":%u,\"median\":%u,\"p99\":%u,\"bytes\":%u}",
+			    i ? "," : "", r.name, (unsigned)r.min, (unsigned)r.median, (unsigned)r.p99, (unsigned)r.bytes);
+		}
+		put("\n]}\n");
+		return ok;
+	}
+
+private:
+	struct Result {
+		const char*	name;
+		uint32_t	min;
+		uint32_t	median;
+		uint32_t	p99;
+		uint32_t	bytes;	// read + written per call, each buffer and table once
+	};
+
+	std::vector<uint32_t>	samples_;
+	std::vector<Result>		results_;
+	uint32_t				overhead_ = 0;
+
+	int16_t		pcm_[AP_FRAME_SAMPLES];
+	int32_t		raw_[AUDIO_DMA_BUF_LEN];
+	int16_t		conv_[AUDIO_DMA_BUF_LEN];
+	int16_t		hop_[AP_HOP_SAMPLES];
+	RingBuffer<int16_t, AUDIO_RING_SAMPLES>	ring_;
+	float		window_[ManualDSCNN::kWindow];
+	float		mel_[KWS_NUM_MEL];
+	float		row_[KWS_NUM_MFCC];
+	float		col_[ManualDSCNN::kC2];
+	float		gap_[ManualDSCNN::kC2];
+	float		logits_[KWS_NUM_CLASSES];
+	float		probs_[KWS_NUM_CLASSES];
+	int8_t		window_q_[Int8DSCNN::kWindow];
+
+	template <typename F>
+	void time_(const char* name, uint32_t bytes, F&& stage) {
+		for (int i = 0; i < BENCH_WARMUP; ++i) {
+			stage();
+			BENCH_CLOBBER();
+		}
+		for (uint32_t& s : samples_) {
+			const uint32_t t0 = cycles();
+			stage();
+			BENCH_CLOBBER();
+			const uint32_t dt = cycles() - t0;
+			s = dt > overhead_ ? dt - overhead_ : 0;
+		}
+		std::sort(samples_.begin(), samples_.end());
+		const size_t n = samples_.size();
+		results_.push_back(Result{ name, samples_[0], samples_[n / 2], samples_[n * 99 / 100], bytes });
+	}
+
+	// The cheapest empty measurement is the timer's own cost.
+	void calibrate_() {
+		overhead_ = 0;
+		time_("timer", 0, [] {});
+		overhead_ = results_.back().min;
+		results_.pop_back();
+	}
+
+	// One DMA buffer of 24-in-32 samples through every compiled-in variant.
+	void capture_() {
+		for (int i = 0; i < AUDIO_DMA_BUF_LEN; ++i) {
+			raw_[i] = (int32_t)(8388607.0f * sinf(0.05f * i)) << 8;
+		}
+		static char names[8][32];
+		for (int k = 0; k < dspk::kNumVariants && k < 8; ++k) {
+			const dspk::Pcm24Fn fn = dspk::kVariants[k].pcm24;
+			snprintf(names[k], sizeof(names[k]), "capture.pcm24.%s", dspk::kVariants[k].name);
+			time_(names[k], AUDIO_DMA_BUF_LEN * (sizeof(int32_t) + sizeof(int16_t)),
+			      [&] { fn(raw_, conv_, AUDIO_DMA_BUF_LEN, AUDIO_GAIN_SHIFT); });
+		}
+		static_assert(AUDIO_DMA_BUF_LEN >= AP_HOP_SAMPLES, "capture.ring.hop writes a hop from conv_");
+		// One hop into the capture ring and out again. The ring's position
+		// advances every call, so the wrapped two-copy case is timed too.
+		ring_.reset();
+		time_("capture.ring.hop", 4 * AP_HOP_SAMPLES * sizeof(int16_t), [&] {
+			ring_.write(conv_, AP_HOP_SAMPLES);
+			ring_.read(hop_, AP_HOP_SAMPLES);
+		});
+	}
+
+	// computeMfcc_() stage by stage on a tone-plus-noise frame, then whole.
+	void frontend_() {
+		uint32_t seed = 1;
+		for (int i = 0; i < AP_FRAME_SAMPLES; ++i) {
+			seed = seed * 1664525u + 1013904223u;
+			pcm_[i] = (int16_t)(6000.0f * sinf(0.3f * i) + (int32_t)(seed >> 22) - 512);
+		}
+		AudioProcessor& p = g_proc;
+		const FrontendTables& T = kFrontendTables;
+		const uint32_t fft = AP_FFT_SIZE * sizeof(float);
+		const uint32_t bins = AP_FFT_BINS * sizeof(float);
+		const uint32_t mel = KWS_NUM_MEL * sizeof(float);
+		const uint32_t row = KWS_NUM_MFCC * sizeof(float);
+
+		time_("frontend.window", AP_FRAME_SAMPLES * (sizeof(int16_t) + sizeof(float)) + fft,
+		      [&] { p.stageWindow_(pcm_); });
+		p.stageWindow_(pcm_);
+		// In place, so each run transforms the previous output; the cost
+		// does not depend on the values.
+		time_("frontend.fft", fft, [&] { p.stageFFT_(); });
+		p.stageWindow_(pcm_);
+		p.stageFFT_();
+		time_("frontend.power", fft + bins, [&] { p.stagePower_(); });
+		time_("frontend.mel", bins + T.mel_num_weights * sizeof(float) + KWS_NUM_MEL * sizeof(MelSpan) + mel,
+		      [&] { AudioProcessor::stageMel_(p.power_, mel_); });
+		float energies[KWS_NUM_MEL];
+		AudioProcessor::stageMel_(p.power_, energies);
+		time_("frontend.log", mel, [&] {
+			memcpy(mel_, energies, sizeof(mel_));
+			AudioProcessor::stageLog_(mel_);
+		});
+		time_("frontend.dct", mel + KWS_NUM_MFCC * mel + 2 * row,
+		      [&] { AudioProcessor::stageDct_(mel_, row_); });
+		time_("frontend.row", AP_FRAME_SAMPLES * sizeof(int16_t) + fft + bins + row,
+		      [&] { p.computeMfcc_(pcm_, row_); });
+		time_("frontend.processFrame", AP_FRAME_SAMPLES * 2 * sizeof(int16_t) + fft + bins + row,
+		      [&] { p.processFrame(pcm_); });
+
+		// A full window, so computeMFCCFloat() copies rather than zero-fills.
+		for (int i = 0; i < KWS_FRAMES; ++i) p.processFrame(pcm_);
+		time_("features.computeMFCCFloat", 2 * ManualDSCNN::kWindow * sizeof(float),
+		      [&] { p.computeMFCCFloat(window_); });
+	}
+
+	// computeMfccQ_() stage by stage on the same frame, then whole, and
+	// computeMFCCInt8() for the window Int8DSCNN runs on. Leaves the
+	// frontend in int8 mode.
+	void frontendInt8_() {
+		AudioProcessor& p = g_proc;
+		for (int i = 0; i < KWS_FRAMES; ++i) p.processFrame(pcm_);
+		memset(window_q_, (int8_t)input_zero_point, sizeof(window_q_));
+#if AP_HAS_INT8_FRONTEND
+		p.setMode(AudioProcessor::Mode::Int8);
+		const FrontendTables& T = kFrontendTables;
+		const uint32_t fft = AP_FFT_SIZE * sizeof(int32_t);
+		const uint32_t mel = KWS_NUM_MEL * sizeof(int32_t);
+		int32_t log_mel[KWS_NUM_MEL];
+		int8_t row[KWS_NUM_MFCC];
+
+		time_("frontend.int8.window", AP_FRAME_SAMPLES * 2 * sizeof(int16_t) + fft,
+		      [&] { p.stageWindowQ_(pcm_); });
+		p.stageWindowQ_(pcm_);
+		// In place like frontend.fft; the block exponent renormalizes each run.
+		time_("frontend.int8.fft", fft, [&] { p.stageFFTQ_(); });
+		p.stageWindowQ_(pcm_);
+		const int exponent = p.stageFFTQ_();
+		time_("frontend.int8.mel_log2", fft + T.mel_num_weights * sizeof(uint16_t) + KWS_NUM_MEL * sizeof(MelSpan) + mel,
+		      [&] { p.stageLogMelQ_(exponent, log_mel); });
+		time_("frontend.int8.dct", mel + KWS_NUM_MFCC * mel + KWS_NUM_MFCC * (sizeof(int64_t) + 1),
+		      [&] { AudioProcessor::stageDctQ_(log_mel, row); });
+		time_("frontend.int8.row", AP_FRAME_SAMPLES * sizeof(int16_t) + fft + KWS_NUM_MFCC,
+		      [&] { p.computeMfccQ_(pcm_, row); });
+		time_("frontend.int8.processFrame", AP_FRAME_SAMPLES * 2 * sizeof(int16_t) + fft + KWS_NUM_MFCC,
+		      [&] { p.processFrame(pcm_); });
+		time_("features.computeMFCCInt8", 2 * Int8DSCNN::kWindow,
+		      [&] { p.computeMFCCInt8(window_q_); });
+#endif
+	}
+
+	// Each ManualDSCNN layer on the window computeMFCCFloat() produced.
+	void model_() {
+		ManualDSCNN& m = g_net;
+		const int C1 = ManualDSCNN::kC1, C2 = ManualDSCNN::kC2;
+		const uint32_t conv_w = (9 * C1 + C1) * sizeof(float);	// 3x3 kernel + bias
+		const uint32_t pw_w = (C2 * C1 + C2) * sizeof(float);
+		const uint32_t dense_w = (KWS_NUM_CLASSES * C2 + KWS_NUM_CLASSES) * sizeof(float);
+		const uint32_t input = ManualDSCNN::kWindow * sizeof(float);
+
+		time_("model.column", 3 * KWS_NUM_MFCC * sizeof(float) + conv_w + pw_w + C2 * sizeof(float),
+		      [&] { m.column_(window_, 1, ManualDSCNN::kWindow, KWS_FRAMES / 2, col_); });
+		time_("model.conv_pw_gap", input + conv_w + pw_w + C2 * sizeof(float),
+		      [&] { m.pool_(window_, 1, ManualDSCNN::kWindow, gap_); });
+		time_("model.dense", C2 * sizeof(float) + dense_w + KWS_NUM_CLASSES * sizeof(float),
+		      [&] { ManualDSCNN::dense_(gap_, logits_); });
+		time_("model.softmax", 2 * KWS_NUM_CLASSES * sizeof(float),
+		      [&] { ManualDSCNN::softmax_(logits_, probs_); });
+		time_("model.predict_full", input + conv_w + pw_w + dense_w + 2 * KWS_NUM_CLASSES * sizeof(float),
+		      [&] { m.predict_full(window_, probs_, logits_); });
+		// One new row per call, the steady state of the streaming detector.
+		uint32_t seq = KWS_FRAMES;
+		m.reset_stream();
+		m.predict_stream(window_, seq, probs_, logits_);
+		time_("model.predict_stream", 3 * KWS_NUM_MFCC * sizeof(float) + conv_w + pw_w + dense_w,
+		      [&] { m.predict_stream(window_, ++seq, probs_, logits_); });
+	}
+
+	// Each Int8DSCNN step on the window computeMFCCInt8() produced. Bytes
+	// count the step's input and output tensors and its weights and biases.
+	void modelInt8_() {
+		Int8DSCNN& m = g_int8;
+		const int H0 = Int8DSCNN::kH0 * Int8DSCNN::kW, H1 = Int8DSCNN::kH1 * Int8DSCNN::kW;
+		struct Step {
+			const char*			name;
+			Int8DSCNN::Layer	layer;
+			uint32_t			bytes;
+		};
+		const Step steps[] = {
+			{ "model.int8.conv", Int8DSCNN::kLayerConv, (uint32_t)(H0 + H0 * 16 + sizeof(ds_cnn_tiny_v2_conv2d_Conv2D) +
+			  sizeof(ds_cnn_tiny_v2_batch_normalization_FusedBatchNormV3)) },
+			{ "model.int8.b1_dw", Int8DSCNN::kLayerB1Dw, (uint32_t)(2 * H0 * 16 + sizeof(ds_cnn_tiny_v2_b1_dw_depthwise) +
+			  sizeof(ds_cnn_tiny_v2_batch_normalization_1_FusedBatchNormV3)) },
+			{ "model.int8.b1_pw_pool", Int8DSCNN::kLayerB1Pw, (uint32_t)(H0 * 16 + 2 * H0 * 24 + H1 * 24 +
+			  sizeof(ds_cnn_tiny_v2_b1_pw_Conv2D) + sizeof(m.b1_pw_bias_)) },
+			{ "model.int8.b2_dw", Int8DSCNN::kLayerB2Dw, (uint32_t)(2 * H1 * 24 + sizeof(ds_cnn_tiny_v2_b2_dw_depthwise) +
+			  sizeof(ds_cnn_tiny_v2_batch_normalization_3_FusedBatchNormV3)) },
+			{ "model.int8.b2_pw", Int8DSCNN::kLayerB2Pw, (uint32_t)(H1 * 24 + H1 * 32 + sizeof(ds_cnn_tiny_v2_b2_pw_Conv2D) +
+			  sizeof(m.b2_pw_bias_)) },
+			{ "model.int8.b3_dw", Int8DSCNN::kLayerB3Dw, (uint32_t)(2 * H1 * 32 + sizeof(ds_cnn_tiny_v2_b3_dw_depthwise) +
+			  sizeof(ds_cnn_tiny_v2_batch_normalization_5_FusedBatchNormV3)) },
+			{ "model.int8.b3_pw_gap", Int8DSCNN::kLayerB3PwGap, (uint32_t)(H1 * 32 + 48 + sizeof(ds_cnn_tiny_v2_b3_pw_Conv2D) +
+			  sizeof(m.b3_pw_bias_)) },
+			{ "model.int8.dense", Int8DSCNN::kLayerDense, (uint32_t)(48 + KWS_NUM_CLASSES + sizeof(ds_cnn_tiny_v2_dense_MatMul) +
+			  sizeof(ds_cnn_tiny_v2_dense_BiasAdd_ReadVariableOp)) },
+		};
+		static_assert(sizeof(steps) / sizeof(steps[0]) == Int8DSCNN::kNumLayers, "one bench stage per Int8DSCNN step");
+
+		// Every step reads its predecessor's output, so run them all once first.
+		m.predict_full_q(window_q_, probs_, logits_);
+		uint32_t total = 0;
+		for (const Step& st : steps) {
+			time_(st.name, st.bytes, [&] { m.layer_(st.layer, window_q_, 0); });
+			total += st.bytes;
+		}
+		time_("model.int8.predict_full_q", total + 2 * KWS_NUM_CLASSES * sizeof(float),
+		      [&] { m.predict_full_q(window_q_, probs_, logits_); });
+	}
+};
+
+static char g_json[8192];
+
+#ifdef ARDUINO
+
+void setup() {
+	Serial.begin(115200);
+	delay(2000);	// let the monitor attach
+	g_proc.begin();
+	g_net.begin();
+	g_int8.begin();
+	static KwsBench bench(BENCH_ITERATIONS);
+	bench.run();
+	const bool ok = bench.json(g_json, sizeof(g_json));
+	Serial.println("BENCH_JSON_BEGIN");
+	Serial.print(g_json);
+	Serial.println("BENCH_JSON_END");
+	if (!ok) Serial.println("ERROR: bench JSON truncated");
+	Serial.flush();
+}
+
+void loop() {
+	delay(1000);
+}
+
+#else
+
+int main(int argc, char** argv) {
+	int iterations = BENCH_ITERATIONS;
+	const char* out = nullptr;
+	for (int i = 1; i < argc; ++i) {
+		if (!strcmp(argv[i], "-n") && i + 1 < argc) iterations = atoi(argv[++i]);
+		else if (!strcmp(argv[i], "-o") && i + 1 < argc) out = argv[++i];
+		else {
+			fprintf(stderr, "usage: kws_bench [-n iterations] [-o result.json]\n");
+			return 2;
+		}
+	}
+	if (iterations < 1) iterations = 1;
+	Serial.mute(true);
+	g_proc.begin();
+	g_net.begin();
+	g_int8.begin();
+	static KwsBench bench(iterations);
+	bench.run();
+	if (!bench.json(g_json, sizeof(g_json))) {
+		fprintf(stderr, "kws_bench: JSON truncated\n");
+		return 1;
+	}
+	FILE* f = out ? fopen(out, "w") : stdout;
+	if (!f) {
+		fprintf(stderr, "kws_bench: cannot write %s\n", out);
+		return 1;
+	}
+	fputs(g_json, f);
+	if (out) fclose(f);
+	return 0;
+}
+
+#endif
@@ -3,6 +3,7 @@
 #include <Wire.h>
 #include <AHT10.h>
 #include <ArduinoOTA.h>
+#include <WiFiUdp.h>
 #include <freertos/FreeRTOS.h>
 #include <freertos/task.h>
 
@@ -11,18 +12,35 @@
 
 #include "AudioCapture.h"
 #include "AudioProcessor.h"
-#include "ManualDSCNN.h"
 #include "WakeWordDetector.h"
+#include "Trace.h"
+#include "Telemetry.h"
+#include <WebServer.h>
+#if KWS_MODEL_BLOB
+#include "ModelStore.h"
+#endif
 
 // ====== Globals ======
 static AudioCapture		g_cap;
 static AudioProcessor	g_proc;
-static ManualDSCNN		g_net;
+static KwsModel		g_net;
 static WakeWordDetector g_det(g_cap, g_proc, g_net);
+#if KWS_MODEL_BLOB
+static ModelStore		g_store;
+static WebServer		g_model_http(MODEL_OTA_PORT);
+static bool				g_model_upload_ok = false;
+#endif
+
+static WebServer		g_telemetry_http(TELEMETRY_PORT);
+static char				g_telemetry_json[8192];
 
 static AHT10 g_aht10(AHT10_ADDRESS_0X38);
+#if TRACE_SINK == TRACE_SINK_UDP
+static WiFiUDP g_trace_udp;
+#endif
 
 static TaskHandle_t task_loop = nullptr;
+static TaskHandle_t task_capture = nullptr;
 static volatile bool ota_active = false;
 
 // ====== WiFi & OTA ======
@@ -42,6 +60,7 @@ static void setupOTA() {
 	ArduinoOTA.setPassword(OTA_PASSWORD);
 	ArduinoOTA.onStart([]() {
 		ota_active = true;
+		if (task_capture) vTaskDelete(task_capture);
 		if (task_loop) vTaskDelete(task_loop);
 		Serial.println("OTA Start");
 		Serial.flush();
@@ -60,33 +79,171 @@ static void setupOTA() {
 	Serial.flush();
 }
 
-// ====== Worker Task ======
+#if KWS_MODEL_BLOB
+// ====== Model OTA ======
+// Writes only the inactive model partition, then restarts into it:
+//   curl -u MODEL_OTA_USER:OTA_PASSWORD -F model=@models/ds_cnn_tiny_v2_int8.kwsm http://<ip>:MODEL_OTA_PORT/model
+static void setupModelOTA() {
+	g_model_http.on("/model", HTTP_POST, []() {
+		if (!g_model_http.authenticate(MODEL_OTA_USER, OTA_PASSWORD)) return g_model_http.requestAuthentication();
+		if (!g_model_upload_ok) {
+			g_model_http.send(400, "text/plain", String("model rejected: ") + g_store.error() + "\n");
+			return;
+		}
+		g_model_http.send(200, "text/plain", "model stored, restarting\n");
+		delay(200);
+		ESP.restart();
+	}, []() {
+		HTTPUpload& up = g_model_http.upload();
+		switch (up.status) {
+		case UPLOAD_FILE_START:
+			g_model_upload_ok = g_model_http.authenticate(MODEL_OTA_USER, OTA_PASSWORD) && g_store.beginUpdate();
+			break;
+		case UPLOAD_FILE_WRITE:
+			if (g_model_upload_ok) g_model_upload_ok = g_store.writeUpdate(up.buf, up.currentSize);
+			break;
+		case UPLOAD_FILE_END:
+			if (g_model_upload_ok) g_model_upload_ok = g_store.finishUpdate();
+			break;
+		default:
+			g_store.abortUpdate();
+			g_model_upload_ok = false;
+			break;
+		}
+	});
+	g_model_http.begin();
+	Serial.printf("🔧 Model OTA ready on :%d/model\n", MODEL_OTA_PORT);
+	Serial.flush();
+}
+
+// Newest valid slot first, the previous one if the runtime rejects it.
+static bool loadModel() {
+	if (!g_store.begin()) return false;
+	if (g_net.load(g_store.data(), g_store.size())) return true;
+	return g_store.fallback() && g_net.load(g_store.data(), g_store.size());
+}
+#endif
+
+// ====== Telemetry ======
+// CPU load in each snapshot covers the time since the previous request:
+//   python3 tools/telemetry_collect.py http://<ip>:TELEMETRY_PORT/telemetry
+static void setupTelemetry() {
+	g_telemetry_http.on("/telemetry", HTTP_GET, []() {
+		telemetry::System sys;
+		telemetry::sampleSystem(sys);
+		sys.stack_min_free[0] = task_loop ? uxTaskGetStackHighWaterMark(task_loop) * sizeof(StackType_t) : 0;
+		sys.stack_min_free[1] = task_capture ? uxTaskGetStackHighWaterMark(task_capture) * sizeof(StackType_t) : 0;
+		if (!telemetry::json(g_telemetry_json, sizeof(g_telemetry_json), g_det.counters(), sys)) {
+			g_telemetry_http.send(500, "text/plain", "telemetry snapshot truncated\n");
+			return;
+		}
+		g_telemetry_http.send(200, "application/json", g_telemetry_json);
+	});
+	g_telemetry_http.begin();
+	Serial.printf("🔧 Telemetry on :%d/telemetry\n", TELEMETRY_PORT);
+	Serial.flush();
+}
+
+// ====== Trace ======
+// Called from the trace drain task with one batch at a time.
+static void traceSink(const uint8_t* data, size_t n) {
+#if TRACE_SINK == TRACE_SINK_UDP
+	if (ota_active || WiFi.status() != WL_CONNECTED) return;
+	g_trace_udp.beginPacket(TRACE_UDP_HOST, TRACE_UDP_PORT);
+	g_trace_udp.write(data, n);
+	g_trace_udp.endPacket();
+#else
+	Serial.write(data, n);
+#endif
+}
+
+// ====== Worker Tasks ======
+// The beep runs while audio keeps flowing: indicateDetection() starts it and
+// updateIndicator(), called every hop, ends it. The cooldown is the decision
+// engine's refractory period, in stream time.
+static unsigned long g_beep_start = 0;
+static bool g_beeping = false;
+
+static void indicateDetection() {
+	digitalWrite(LED_PIN, HIGH);
+	ledcWriteTone(BUZZER_CHANNEL, 1000);
+	g_beep_start = millis();
+	g_beeping = true;
+}
+
+static void updateIndicator() {
+	if (!g_beeping || millis() - g_beep_start < DETECTION_BEEP_MS) return;
+	digitalWrite(LED_PIN, LOW);
+	ledcWriteTone(BUZZER_CHANNEL, 0);
+	g_beeping = false;
+}
+
+#if KWS_PIPELINE
+// Core 0: every hop goes through the frontend as soon as I2S delivers it,
+// whatever inference is doing. No delay: readHop() waits on DMA events,
+// pacing the loop at one hop (10 ms).
+static void captureTask(void* param) {
+	while (1) {
+		if (g_det.captureHop() && task_loop) xTaskNotifyGive(task_loop);
+	}
+}
+
+// Core 1: wakes on queued hops and runs the network on the newest window.
+// Hops queued while it runs are folded into the next run; more than
+// KWS_HOP_QUEUE_LEN of them are counted as drops.
+static void kwsTask(void* param) {
+	float p_conf, p_avg;
+	unsigned long last_stats = 0;
+	while (1) {
+		ulTaskNotifyTake(pdTRUE, pdMS_TO_TICKS(100));
+		updateIndicator();
+		if (!g_det.pending()) continue;
+		const bool fired = g_det.inferPending(p_conf, p_avg);
+		if (DEBUG_LEVEL >= 2 && millis() - last_stats >= 5000) {
+			last_stats = millis();
+			const WakeWordDetector::PipelineStats ps = g_det.pipelineStats();
+			Serial.printf("DEBUG: pipeline hops=%u read_errors=%u queue_drops=%u backlog_max=%u coalesced=%u overwritten=%u\n",
+			              ps.hops, ps.read_errors, ps.queue_drops, ps.backlog_max, ps.coalesced, ps.overwritten);
+			const AudioCapture::Stats& cs = g_cap.stats();
+			Serial.printf("DEBUG: capture dma_blocks=%u overflows=%u dropped=%u ring_overruns=%u\n",
+			              cs.dma_blocks, cs.overflows, cs.dropped, cs.ring_overruns);
+			const DecisionEngine::Stats& ds = g_det.decision().stats();
+			Serial.printf("DEBUG: decisions hits=%u near_misses=%u (best %.3f) suppressed=%u\n",
+			              ds.hits, ds.near_misses, ds.best_miss, ds.suppressed);
+			AudioCapture::Gap gap;
+			while (g_cap.popGap(gap)) {
+				Serial.printf("DEBUG: audio gap: %u samples lost at sample %llu (t=%u us)\n",
+				              gap.samples, (unsigned long long)gap.at, gap.time_us);
+			}
+			Serial.printf("DEBUG: kwsTask stack high water mark: %u bytes, free heap: %u bytes\n",
+			              uxTaskGetStackHighWaterMark(nullptr) * sizeof(StackType_t), ESP.getFreeHeap());
+			Serial.flush();
+		}
+		if (fired) indicateDetection();
+	}
+}
+#else
 static void kwsTask(void* param) {
 	float p_conf, p_avg;
 	bool fired = false;
 	while (1) {
 		unsigned long start = millis();
-		Serial.println("DEBUG: kwsTask loop");
-		UBaseType_t stackHighWater = uxTaskGetStackHighWaterMark(nullptr);
-		Serial.printf("DEBUG: kwsTask stack high water mark: %u bytes\n", stackHighWater * sizeof(StackType_t));
-		Serial.printf("DEBUG: Free heap: %u bytes\n", ESP.getFreeHeap());
+		if (TRACE_ON(KWS_HEALTH)) {
+			TRACE(KWS_HEALTH, uxTaskGetStackHighWaterMark(nullptr) * sizeof(StackType_t), ESP.getFreeHeap());
+		}
 		if (g_det.detect_once(p_conf, p_avg)) {
 			fired = true;
 		}
-		Serial.printf("DEBUG: kwsTask p_conf=%.4f p_avg=%.4f fired=%d, duration=%lu ms\n", p_conf, p_avg, fired, millis() - start);
-		Serial.flush();
+		TRACE(KWS_LOOP, millis() - start, fired);
 		if (fired) {
-			digitalWrite(LED_PIN, HIGH);
-			ledcWriteTone(BUZZER_CHANNEL, 1000);
-			delay(200);
-			digitalWrite(LED_PIN, LOW);
-			ledcWriteTone(BUZZER_CHANNEL, 0);
-			delay(DETECTION_COOLDOWN_MS);
+			indicateDetection();
 			fired = false;
 		}
-		vTaskDelay(pdMS_TO_TICKS(100));  // Increased to 100ms
+		updateIndicator();
+		// No delay: readHop() waits on DMA events, pacing the loop at one hop (10 ms).
 	}
 }
+#endif
 
 // ====== Arduino ======
 void setup() {
@@ -99,6 +256,11 @@ void setup() {
 
     connectWiFi();
     setupOTA();
+#if KWS_MODEL_BLOB
+    setupModelOTA();
+#endif
+    setupTelemetry();
+    trace::begin(traceSink);
 
     // I2C (AHT10)
     Wire.end();  // Reset I2C bus
@@ -187,8 +349,16 @@ void setup() {
     if (!g_proc.begin()) {
         Serial.println("❌ AudioProcessor init failed"); while (true) delay(1000);
     }
+#if KWS_MODEL_BLOB
+    // Without a usable model keep loop() running, so one can be uploaded.
+    if (!loadModel()) {
+        Serial.printf("❌ No usable model in %s/%s, upload one to :%d/model\n",
+                      g_store.label(0), g_store.label(1), MODEL_OTA_PORT);
+        return;
+    }
+#endif
     if (!g_net.begin()) {
-        Serial.println("❌ ManualDSCNN init failed"); while (true) delay(1000);
+        Serial.println("❌ KWS model init failed"); while (true) delay(1000);
     }
     g_det.begin();
 
@@ -199,6 +369,9 @@ void setup() {
 
     // Start detection task with increased stack
     xTaskCreatePinnedToCore(kwsTask, "kwsTask", 16384, nullptr, 1, &task_loop, 1);
+#if KWS_PIPELINE
+    xTaskCreatePinnedToCore(captureTask, "captureTask", 8192, nullptr, KWS_CAPTURE_PRIO, &task_capture, 0);
+#endif
 }
 
 unsigned long last_env = 0;
@@ -206,6 +379,10 @@ unsigned long last_env = 0;
 void loop() {
 	ArduinoOTA.handle();
 	if (ota_active) { delay(1000); return; }
+#if KWS_MODEL_BLOB
+	g_model_http.handleClient();
+#endif
+	g_telemetry_http.handleClient();
 
 	const unsigned long now = millis();
 	if (now - last_env >= 2000) {
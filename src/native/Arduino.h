@@ -0,0 +1,64 @@
+#pragma once
+// Just enough of the Arduino core for the audio and inference libraries to
+// build on the host (env:native): Serial, millis/micros/delay and
+// ESP.getFreeHeap. Anything else is a build error on purpose, so target-only
+// code stays behind #ifdef ARDUINO.
+#include <stdint.h>
+#include <stddef.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <algorithm>
+#include <chrono>
+#include <thread>
+
+using std::min;
+using std::max;
+
+// Serial goes to stderr, so a runner's own report on stdout stays clean;
+// mute() drops it altogether (formatting included) for timing runs.
+class HostSerial {
+public:
+	void begin(unsigned long) {}
+	void mute(bool on) { muted_ = on; }
+
+	template <typename... Args>
+	int printf(const char* fmt, Args... args) {
+		return muted_ ? 0 : fprintf(stderr, fmt, args...);
+	}
+	size_t print(const char* s) {
+		if (muted_) return 0;
+		fputs(s, stderr);
+		return strlen(s);
+	}
+	size_t println(const char* s = "") {
+		if (muted_) return 0;
+		fputs(s, stderr);
+		fputc('\n', stderr);
+		return strlen(s) + 1;
+	}
+	void flush() { if (!muted_) fflush(stderr); }
+
+private:
+	bool muted_ = false;
+};
+
+// The host has no fixed heap; report nothing free rather than a made-up
+// number.
+class HostEsp {
+public:
+	uint32_t getFreeHeap() const { return 0; }
+};
+
+inline HostSerial Serial;
+inline HostEsp ESP;
+
+// Time since the first call, like time since boot.
+inline uint64_t hostMicros_() {
+	static const std::chrono::steady_clock::time_point t0 = std::chrono::steady_clock::now();
+	return (uint64_t)std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - t0).count();
+}
+inline unsigned long micros() { return (unsigned long)hostMicros_(); }
+inline unsigned long millis() { return (unsigned long)(hostMicros_() / 1000); }
+inline void delay(unsigned long ms) { std::this_thread::sleep_for(std::chrono::milliseconds(ms)); }
@@ -0,0 +1,150 @@
+// Host runner (env:native): streams WAV files through the same
+// AudioCapture -> AudioProcessor -> model -> WakeWordDetector chain as the
+// firmware, as fast as the CPU allows, and reports detections with their
+// stream time and the real-time factor.
+//
+//   kws_run [-v] [-m model.kwsm] [-t trace.bin] [-j telemetry.json] file.wav...
+//
+// Files play back to back as one stream, as if the microphone heard them
+// in turn. -v keeps the libraries' Serial output (on stderr); it is muted by
+// default so it does not distort the timing. -t writes the trace events
+// (lib/Trace) to a file for tools/trace_decode.py, -j the final telemetry
+// snapshot (lib/Telemetry) for tools/telemetry_collect.py.
+#include <Arduino.h>
+#include <chrono>
+#include <stdio.h>
+#include <string.h>
+
+#include "env.h"
+#include "frontend_params.h"
+
+#include "AudioCapture.h"
+#include "AudioProcessor.h"
+#include "WakeWordDetector.h"
+#include "Trace.h"
+#include "Telemetry.h"
+#if KWS_MODEL_BLOB
+#include "ModelStore.h"
+#endif
+
+static AudioCapture		g_cap;
+static AudioProcessor	g_proc;
+static KwsModel			g_net;
+static WakeWordDetector	g_det(g_cap, g_proc, g_net);
+#if KWS_MODEL_BLOB
+static ModelStore		g_store;
+#endif
+static FILE*			g_trace = nullptr;
+static char				g_telemetry_json[8192];
+
+static int usage() {
+	fprintf(stderr, "usage: kws_run [-v] [-m model.kwsm] [-t trace.bin] [-j telemetry.json] file.wav...\n");
+	return 2;
+}
+
+static void traceSink(const uint8_t* data, size_t n) {
+	fwrite(data, 1, n, g_trace);
+}
+
+// Without -m, the blob comes from the slot files, as on the board.
+static bool loadModel(const char* path) {
+#if KWS_MODEL_BLOB
+	if (path) return g_net.loadFile(path);
+	if (!g_store.begin()) return false;
+	if (g_net.load(g_store.data(), g_store.size())) return true;
+	return g_store.fallback() && g_net.load(g_store.data(), g_store.size());
+#else
+	if (path) fprintf(stderr, "kws_run: -m needs a KWS_MODEL_BLOB build, using the built-in model\n");
+	return true;
+#endif
+}
+
+int main(int argc, char** argv) {
+	bool verbose = false;
+	const char* model = nullptr;
+	const char* trace_path = nullptr;
+	const char* telemetry_path = nullptr;
+	int first = 1;
+	for (; first < argc && argv[first][0] == '-'; ++first) {
+		if (!strcmp(argv[first], "-v")) verbose = true;
+		else if (!strcmp(argv[first], "-m") && first + 1 < argc) model = argv[++first];
+		else if (!strcmp(argv[first], "-t") && first + 1 < argc) trace_path = argv[++first];
+		else if (!strcmp(argv[first], "-j") && first + 1 < argc) telemetry_path = argv[++first];
+		else return usage();
+	}
+	if (first == argc) return usage();
+	Serial.mute(!verbose);
+	if (trace_path) {
+		g_trace = fopen(trace_path, "wb");
+		if (!g_trace) {
+			fprintf(stderr, "kws_run: cannot write %s\n", trace_path);
+			return 1;
+		}
+		trace::begin(traceSink);
+	}
+
+	if (!g_cap.begin() || !g_proc.begin() || !loadModel(model) || !g_net.begin()) {
+		fprintf(stderr, "kws_run: init failed%s\n", verbose ? "" : " (-v for the reason)");
+		return 1;
+	}
+	g_det.begin();
+
+	const double fs = KWS_SAMPLE_RATE_HZ;
+	int detections = 0;
+	double busy = 0.0;
+	float p_conf, p_avg;
+
+	for (int f = first; f < argc; ++f) {
+		if (!g_cap.openWav(argv[f])) {
+			fprintf(stderr, "kws_run: cannot stream %s%s\n", argv[f], verbose ? "" : " (-v for the reason)");
+			return 1;
+		}
+		const uint64_t file_start = g_cap.stats().samples;
+		printf("%s: %.2f s\n", argv[f], g_cap.wavSamples() / fs);
+
+		const std::chrono::steady_clock::time_point t0 = std::chrono::steady_clock::now();
+		while (!g_cap.sourceDone()) {
+			// The board drains from its own task; here, once per hop keeps
+			// the rings from filling at TRACE_LEVEL 3.
+			if (g_trace) trace::drain();
+			g_det.captureHop();
+			if (!g_det.pending() || !g_det.inferPending(p_conf, p_avg)) continue;
+			// The end of the peak window, as the board reports it; the
+			// refractory period is already applied in stream time.
+			const DecisionEngine::Detection& d = g_det.decision().detection();
+			detections++;
+			printf("  detection at %.3f s (stream %.3f s) p=%.3f smoothed=%.3f\n",
+			       ((double)d.at - (double)file_start) / fs, d.at / fs, d.p_conf, d.peak);
+		}
+		busy += std::chrono::duration<double>(std::chrono::steady_clock::now() - t0).count();
+	}
+
+	if (g_trace) {
+		trace::drain();
+		fclose(g_trace);
+	}
+
+	const double audio = g_cap.stats().samples / fs;
+	const WakeWordDetector::PipelineStats ps = g_det.pipelineStats();
+	printf("%d file(s), %.2f s of audio in %.3f s: RTF %.4f (%.0fx real time), %d detection(s)\n",
+	       argc - first, audio, busy, audio > 0 ? busy / audio : 0.0, busy > 0 ? audio / busy : 0.0, detections);
+	printf("hops=%u coalesced=%u overwritten=%u, inference duty %.1f%%\n",
+	       ps.hops, ps.coalesced, ps.overwritten, 100.0f * g_det.scheduler().duty());
+	const DecisionEngine::Stats& ds = g_det.decision().stats();
+	printf("decisions=%u hits=%u near_misses=%u (best %.3f) suppressed=%u\n",
+	       ds.decisions, ds.hits, ds.near_misses, ds.best_miss, ds.suppressed);
+
+	if (telemetry_path) {
+		telemetry::System sys = {};
+		telemetry::sampleSystem(sys);
+		FILE* f = fopen(telemetry_path, "w");
+		if (!f || !telemetry::json(g_telemetry_json, sizeof(g_telemetry_json), g_det.counters(), sys)) {
+			fprintf(stderr, "kws_run: cannot write %s\n", telemetry_path);
+			if (f) fclose(f);
+			return 1;
+		}
+		fputs(g_telemetry_json, f);
+		fclose(f);
+	}
+	return 0;
+}
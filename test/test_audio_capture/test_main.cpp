@@ -0,0 +1,139 @@
+// AudioCapture's host stand-in driven with injectBlock()/injectOverflow():
+// conversion of 24-in-32 samples, the stream position, and the accounting
+// of lost audio (dropped samples, ring overruns and the gap log).
+#include <unity.h>
+#include <string.h>
+#include "AudioCapture.h"
+
+static AudioCapture g_cap;
+static int32_t g_raw[AUDIO_DMA_BUF_LEN];
+
+void setUp(void) {
+	g_cap.begin();
+}
+void tearDown(void) {}
+
+static int16_t expected(int32_t raw) {
+	const int32_t s = raw >> AUDIO_GAIN_SHIFT;
+	return (int16_t)(s > 32767 ? 32767 : (s < -32768 ? -32768 : s));
+}
+
+// Block b carries sample values that identify it: (b * AUDIO_DMA_BUF_LEN + i)
+// at the 16-bit level after the gain shift.
+static void makeBlock(int b) {
+	for (int i = 0; i < AUDIO_DMA_BUF_LEN; ++i) {
+		g_raw[i] = (int32_t)((b * AUDIO_DMA_BUF_LEN + i) % 30000) << AUDIO_GAIN_SHIFT;
+	}
+}
+
+static void test_block_converts_and_positions(void) {
+	makeBlock(0);
+	g_raw[0] = INT32_MAX;	// saturates high
+	g_raw[1] = INT32_MIN;	// saturates low
+	g_raw[2] = -(1 << AUDIO_GAIN_SHIFT) - 1;	// rounds toward -inf
+	g_cap.injectBlock(g_raw, AUDIO_DMA_BUF_LEN);
+	TEST_ASSERT_EQUAL_UINT32(1, g_cap.stats().dma_blocks);
+	TEST_ASSERT_EQUAL_UINT64(AUDIO_DMA_BUF_LEN, g_cap.stats().samples);
+	TEST_ASSERT_EQUAL_UINT32(AUDIO_DMA_BUF_LEN, (uint32_t)g_cap.buffered());
+	TEST_ASSERT_EQUAL_UINT64(0, g_cap.position());
+
+	int16_t hop[AP_HOP_SAMPLES];
+	TEST_ASSERT_TRUE(g_cap.readHop(hop));
+	for (int i = 0; i < AP_HOP_SAMPLES; ++i) TEST_ASSERT_EQUAL_INT(expected(g_raw[i]), hop[i]);
+	TEST_ASSERT_EQUAL_INT(32767, hop[0]);
+	TEST_ASSERT_EQUAL_INT(-32768, hop[1]);
+	TEST_ASSERT_EQUAL_INT(-2, hop[2]);
+	TEST_ASSERT_EQUAL_UINT64(AP_HOP_SAMPLES, g_cap.position());
+
+	// Not enough left for a second hop: the read fails, zero-filled, and
+	// consumes nothing.
+	if (AUDIO_DMA_BUF_LEN < 2 * AP_HOP_SAMPLES) {
+		TEST_ASSERT_FALSE(g_cap.readHop(hop));
+		TEST_ASSERT_EQUAL_INT(0, hop[0]);
+		TEST_ASSERT_EQUAL_UINT64(AP_HOP_SAMPLES, g_cap.position());
+	}
+	TEST_ASSERT_EQUAL_UINT32(0, g_cap.stats().dropped);
+}
+
+static void test_overflow_leaves_a_gap_in_the_stream(void) {
+	makeBlock(0);
+	g_cap.injectBlock(g_raw, AUDIO_DMA_BUF_LEN);
+	g_cap.injectOverflow(100);
+	makeBlock(1);
+	g_cap.injectBlock(g_raw, AUDIO_DMA_BUF_LEN);
+
+	const AudioCapture::Stats& s = g_cap.stats();
+	TEST_ASSERT_EQUAL_UINT32(1, s.overflows);
+	TEST_ASSERT_EQUAL_UINT32(100, s.dropped);
+	TEST_ASSERT_EQUAL_UINT32(0, s.ring_overruns);
+	TEST_ASSERT_EQUAL_UINT64(2 * AUDIO_DMA_BUF_LEN + 100, s.samples);
+	TEST_ASSERT_EQUAL_UINT32(2 * AUDIO_DMA_BUF_LEN, (uint32_t)g_cap.buffered());
+	// Positions count the lost samples, so the next one read sits 100
+	// samples further along than the ring alone would say.
+	TEST_ASSERT_EQUAL_UINT64(100, g_cap.position());
+
+	AudioCapture::Gap g;
+	TEST_ASSERT_TRUE(g_cap.popGap(g));
+	TEST_ASSERT_EQUAL_UINT64(AUDIO_DMA_BUF_LEN, g.at);
+	TEST_ASSERT_EQUAL_UINT32(100, g.samples);
+	TEST_ASSERT_FALSE(g_cap.popGap(g));
+}
+
+static void test_full_ring_drops_the_tail(void) {
+	const int blocks = AUDIO_RING_SAMPLES / AUDIO_DMA_BUF_LEN;
+	for (int b = 0; b < blocks; ++b) {
+		makeBlock(b);
+		g_cap.injectBlock(g_raw, AUDIO_DMA_BUF_LEN);
+	}
+	TEST_ASSERT_EQUAL_UINT32(0, g_cap.stats().dropped);
+	TEST_ASSERT_EQUAL_UINT32(AUDIO_RING_SAMPLES, (uint32_t)g_cap.buffered());
+
+	// Make room for one hop: the next block keeps its head, loses its tail.
+	int16_t hop[AP_HOP_SAMPLES];
+	TEST_ASSERT_TRUE(g_cap.readHop(hop));
+	makeBlock(blocks);
+	g_cap.injectBlock(g_raw, AUDIO_DMA_BUF_LEN);
+	const uint32_t lost = AUDIO_DMA_BUF_LEN - AP_HOP_SAMPLES;
+	const AudioCapture::Stats& s = g_cap.stats();
+	TEST_ASSERT_EQUAL_UINT32(lost, s.dropped);
+	TEST_ASSERT_EQUAL_UINT32(lost, s.ring_overruns);
+	TEST_ASSERT_EQUAL_UINT32(0, s.overflows);
+	TEST_ASSERT_EQUAL_UINT64((uint64_t)(blocks + 1) * AUDIO_DMA_BUF_LEN, s.samples);
+
+	AudioCapture::Gap g;
+	TEST_ASSERT_TRUE(g_cap.popGap(g));
+	TEST_ASSERT_EQUAL_UINT64((uint64_t)blocks * AUDIO_DMA_BUF_LEN + AP_HOP_SAMPLES, g.at);
+	TEST_ASSERT_EQUAL_UINT32(lost, g.samples);
+
+	// Everything kept reads back in order across the ring's wrap.
+	int expect = AP_HOP_SAMPLES;
+	while (g_cap.buffered() >= AP_HOP_SAMPLES) {
+		TEST_ASSERT_TRUE(g_cap.readHop(hop));
+		for (int i = 0; i < AP_HOP_SAMPLES; ++i, ++expect) TEST_ASSERT_EQUAL_INT(expect % 30000, hop[i]);
+	}
+}
+
+static void test_gap_log_keeps_the_oldest(void) {
+	for (int i = 0; i < 20; ++i) g_cap.injectOverflow(10 + i);
+	TEST_ASSERT_EQUAL_UINT32(20, g_cap.stats().overflows);
+	TEST_ASSERT_EQUAL_UINT32(20 * 10 + 190, g_cap.stats().dropped);
+	AudioCapture::Gap g;
+	int n = 0;
+	uint64_t at = 0;
+	while (g_cap.popGap(g)) {
+		TEST_ASSERT_EQUAL_UINT32(10 + n, g.samples);
+		TEST_ASSERT_EQUAL_UINT64(at, g.at);
+		at += g.samples;
+		++n;
+	}
+	TEST_ASSERT_EQUAL_INT(16, n);
+}
+
+int main(int argc, char** argv) {
+	UNITY_BEGIN();
+	RUN_TEST(test_block_converts_and_positions);
+	RUN_TEST(test_overflow_leaves_a_gap_in_the_stream);
+	RUN_TEST(test_full_ring_drops_the_tail);
+	RUN_TEST(test_gap_log_keeps_the_oldest);
+	return UNITY_END();
+}
@@ -0,0 +1,97 @@
+// predict_batch() against one predict_full() per window, for both engines:
+// probabilities and logits must be bit-identical, for disjoint windows and
+// for overlapping ones one row apart (stride KWS_NUM_MFCC), across more
+// windows than one kMaxBatch group holds. The shipped float dense layer is
+// a zero stub, so ManualDSCNN's logits do not depend on the input; its
+// pooled features are compared as well. env:native keeps Int8DSCNN at one
+// window per batch; env:native_batch builds this suite with four.
+#include <unity.h>
+#include <string.h>
+#include "ManualDSCNN.h"
+#include "Int8DSCNN.h"
+#include "FeatureBus.h"
+
+static ManualDSCNN g_float;
+static Int8DSCNN g_int8;
+
+static const int kManualN = 2 * ManualDSCNN::kMaxBatch + 3;
+static const int kInt8N = 2 * Int8DSCNN::kMaxBatch + 3;
+static const int kMaxN = kManualN > kInt8N ? kManualN : kInt8N;
+static const int kOut = kMaxN * KWS_NUM_CLASSES;
+
+// Room for kMaxN disjoint windows; overlapping ones use the front of it.
+static float g_rows[kMaxN * ManualDSCNN::kWindow];
+static int8_t g_rows_q[kMaxN * Int8DSCNN::kWindow];
+
+void setUp(void) {}
+void tearDown(void) {}
+
+// LCG features in the normalized MFCC range, and their int8 quantization.
+static void fill(void) {
+	uint32_t seed = 2024;
+	for (int i = 0; i < kMaxN * ManualDSCNN::kWindow; ++i) {
+		seed = seed * 1664525u + 1013904223u;
+		g_rows[i] = ((float)(seed >> 8) / 16777216.0f - 0.5f) * 6.0f;
+		g_rows_q[i] = FeatureBus::quantize(g_rows[i]);
+	}
+}
+
+static void checkManual(int n, int stride) {
+	static float probs[kOut], logits[kOut], pooled[kMaxN * ManualDSCNN::kPooled];
+	g_float.predict_batch(g_rows, n, probs, logits, stride, pooled);
+	for (int b = 0; b < n; ++b) {
+		float p[KWS_NUM_CLASSES], l[KWS_NUM_CLASSES];
+		g_float.predict_full(&g_rows[b * stride], p, l);
+		TEST_ASSERT_EQUAL_MEMORY(p, &probs[b * KWS_NUM_CLASSES], sizeof(p));
+		TEST_ASSERT_EQUAL_MEMORY(l, &logits[b * KWS_NUM_CLASSES], sizeof(l));
+		TEST_ASSERT_EQUAL_MEMORY(g_float.lastPooled(), &pooled[b * ManualDSCNN::kPooled],
+		                         ManualDSCNN::kPooled * sizeof(float));
+	}
+	// Windows one row apart must still differ, or the comparison says nothing.
+	TEST_ASSERT_TRUE(memcmp(&pooled[0], &pooled[ManualDSCNN::kPooled], ManualDSCNN::kPooled * sizeof(float)) != 0);
+}
+
+static void checkInt8(int n, int stride, bool quantized) {
+	static float probs[kOut], logits[kOut];
+	if (quantized) g_int8.predict_batch_q(g_rows_q, n, probs, logits, stride);
+	else g_int8.predict_batch(g_rows, n, probs, logits, stride);
+	for (int b = 0; b < n; ++b) {
+		float p[KWS_NUM_CLASSES], l[KWS_NUM_CLASSES];
+		if (quantized) g_int8.predict_full_q(&g_rows_q[b * stride], p, l);
+		else g_int8.predict_full(&g_rows[b * stride], p, l);
+		TEST_ASSERT_EQUAL_MEMORY(p, &probs[b * KWS_NUM_CLASSES], sizeof(p));
+		TEST_ASSERT_EQUAL_MEMORY(l, &logits[b * KWS_NUM_CLASSES], sizeof(l));
+	}
+	// A window that picked up a neighbour's activations must show.
+	TEST_ASSERT_TRUE(memcmp(&logits[0], &logits[KWS_NUM_CLASSES], KWS_NUM_CLASSES * sizeof(float)) != 0);
+}
+
+static void test_manual_batch_disjoint(void) {
+	TEST_ASSERT_TRUE(g_float.begin());
+	fill();
+	checkManual(kManualN, ManualDSCNN::kWindow);
+}
+
+static void test_manual_batch_overlapping(void) {
+	checkManual(kManualN, KWS_NUM_MFCC);
+}
+
+static void test_int8_batch_disjoint(void) {
+	TEST_ASSERT_TRUE(g_int8.begin());
+	checkInt8(kInt8N, Int8DSCNN::kWindow, false);
+	checkInt8(kInt8N, Int8DSCNN::kWindow, true);
+}
+
+static void test_int8_batch_overlapping(void) {
+	checkInt8(kInt8N, KWS_NUM_MFCC, false);
+	checkInt8(kInt8N, KWS_NUM_MFCC, true);
+}
+
+int main(int argc, char** argv) {
+	UNITY_BEGIN();
+	RUN_TEST(test_manual_batch_disjoint);
+	RUN_TEST(test_manual_batch_overlapping);
+	RUN_TEST(test_int8_batch_disjoint);
+	RUN_TEST(test_int8_batch_overlapping);
+	return UNITY_END();
+}
@@ -0,0 +1,159 @@
+// DecisionEngine fed hand-made posterior sequences: where a detection is
+// placed (the parabola through the peak and its neighbours, the peak_wait
+// cap), what the refractory period suppresses, near-miss counting, and
+// that setConfig() keeps the stats and the last detection.
+#include <unity.h>
+#include "DecisionEngine.h"
+
+static const uint64_t kStep = 160;		// stream samples between windows
+
+void setUp(void) {}
+void tearDown(void) {}
+
+// No smoothing, so the posteriors below are the means the engine sees.
+static DecisionEngine::Config config(void) {
+	DecisionEngine::Config c;
+	c.smooth_n = 1;
+	c.threshold = 0.5f;
+	c.near_miss = 0.2f;
+	c.peak_wait = 3;
+	c.refractory = 10 * kStep;
+	return c;
+}
+
+// Feeds n posteriors, window i ending at (first + i) * kStep; returns how
+// many of them completed a detection.
+static int feed(DecisionEngine& d, const float* p, int n, uint64_t first) {
+	int fired = 0;
+	for (int i = 0; i < n; ++i) fired += d.update(p[i], (first + i) * kStep);
+	return fired;
+}
+
+static void test_peak_is_interpolated(void) {
+	DecisionEngine d(config());
+	// Crosses at window 1, peaks at 2, and window 3 ends the wait.
+	const float p[] = { 0.1f, 0.6f, 0.8f, 0.7f };
+	TEST_ASSERT_FALSE(d.update(p[0], 0));
+	TEST_ASSERT_FALSE(d.update(p[1], kStep));
+	TEST_ASSERT_FALSE(d.update(p[2], 2 * kStep));
+	TEST_ASSERT_TRUE(d.update(p[3], 3 * kStep));
+	// Vertex of the parabola through (-1, 0.6), (0, 0.8), (1, 0.7): 1/6 step
+	// past the peak, towards the higher neighbour.
+	TEST_ASSERT_EQUAL_UINT64(2 * kStep + 27, d.detection().at);
+	TEST_ASSERT_FLOAT_WITHIN(1e-6f, 0.8f, d.detection().peak);
+	TEST_ASSERT_FLOAT_WITHIN(1e-6f, 0.8f, d.detection().p_conf);
+	TEST_ASSERT_EQUAL_UINT32(1, d.stats().hits);
+	TEST_ASSERT_EQUAL_UINT32(4, d.stats().decisions);
+}
+
+static void test_symmetric_peak_sits_on_its_window(void) {
+	DecisionEngine d(config());
+	const float p[] = { 0.0f, 0.6f, 0.9f, 0.6f };
+	TEST_ASSERT_EQUAL_INT(1, feed(d, p, 4, 0));
+	TEST_ASSERT_EQUAL_UINT64(2 * kStep, d.detection().at);
+}
+
+// Reported as a smoothed peak; the raw posterior of that window is kept
+// alongside it.
+static void test_smoothed_peak_keeps_raw_posterior(void) {
+	DecisionEngine::Config c = config();
+	c.smooth_n = 2;
+	DecisionEngine d(c);
+	// Means: 0.2, 0.55, 0.8, 0.65.
+	const float p[] = { 0.4f, 0.7f, 0.9f, 0.4f };
+	d.update(0.0f, 0);
+	TEST_ASSERT_EQUAL_INT(1, feed(d, p, 4, 1));
+	TEST_ASSERT_FLOAT_WITHIN(1e-6f, 0.8f, d.detection().peak);
+	TEST_ASSERT_FLOAT_WITHIN(1e-6f, 0.9f, d.detection().p_conf);
+}
+
+// A mean that keeps rising is reported peak_wait windows after the
+// crossing, at the last window, with no right neighbour to interpolate with.
+static void test_peak_wait_caps_the_hold(void) {
+	DecisionEngine d(config());
+	const float p[] = { 0.0f, 0.55f, 0.6f, 0.65f, 0.7f, 0.75f };
+	int fired_at = -1;
+	for (int i = 0; i < 6; ++i) {
+		if (d.update(p[i], i * kStep) && fired_at < 0) fired_at = i;
+	}
+	TEST_ASSERT_EQUAL_INT(1 + config().peak_wait, fired_at);
+	TEST_ASSERT_EQUAL_UINT64(fired_at * kStep, d.detection().at);
+	TEST_ASSERT_FLOAT_WITHIN(1e-6f, p[fired_at], d.detection().peak);
+	TEST_ASSERT_EQUAL_UINT32(1, d.stats().hits);
+}
+
+static void test_refractory_suppresses_then_releases(void) {
+	DecisionEngine d(config());
+	const float hit[] = { 0.0f, 0.9f, 0.0f };
+	TEST_ASSERT_EQUAL_INT(1, feed(d, hit, 3, 0));
+	const uint64_t at = d.detection().at;
+	TEST_ASSERT_EQUAL_UINT64(kStep, at);
+
+	// A second crossing inside the period is counted, not reported.
+	const float again[] = { 0.9f, 0.9f, 0.0f };
+	TEST_ASSERT_EQUAL_INT(0, feed(d, again, 3, 4));
+	TEST_ASSERT_EQUAL_UINT32(1, d.stats().suppressed);
+	TEST_ASSERT_EQUAL_UINT32(1, d.stats().hits);
+	TEST_ASSERT_EQUAL_UINT64(at, d.detection().at);
+
+	// A mean still high when the period ends does not fire either: the
+	// crossing it belongs to was suppressed.
+	const uint64_t end = (at + config().refractory) / kStep;
+	const float held[] = { 0.9f, 0.9f, 0.9f, 0.9f };
+	TEST_ASSERT_EQUAL_INT(0, feed(d, held, 4, end - 2));
+	TEST_ASSERT_FALSE(d.refractory((end + 1) * kStep));
+	TEST_ASSERT_EQUAL_UINT32(2, d.stats().suppressed);
+
+	// A fresh crossing after the period is reported.
+	const float late[] = { 0.0f, 0.9f, 0.0f };
+	TEST_ASSERT_EQUAL_INT(1, feed(d, late, 3, end + 2));
+	TEST_ASSERT_EQUAL_UINT32(2, d.stats().hits);
+	TEST_ASSERT_EQUAL_UINT32(2, d.stats().suppressed);
+	TEST_ASSERT_EQUAL_UINT64((end + 3) * kStep, d.detection().at);
+}
+
+static void test_near_misses(void) {
+	DecisionEngine d(config());
+	// Two excursions between near_miss and threshold, one below near_miss.
+	const float p[] = { 0.0f, 0.3f, 0.45f, 0.1f, 0.15f, 0.0f, 0.25f, 0.0f };
+	TEST_ASSERT_EQUAL_INT(0, feed(d, p, 8, 0));
+	TEST_ASSERT_EQUAL_UINT32(2, d.stats().near_misses);
+	TEST_ASSERT_FLOAT_WITHIN(1e-6f, 0.45f, d.stats().best_miss);
+	TEST_ASSERT_EQUAL_UINT32(0, d.stats().hits);
+}
+
+static void test_set_config_keeps_stats_and_refractory(void) {
+	DecisionEngine d(config());
+	const float p[] = { 0.0f, 0.9f, 0.0f, 0.3f, 0.0f };
+	TEST_ASSERT_EQUAL_INT(1, feed(d, p, 5, 0));
+	const uint64_t at = d.detection().at;
+
+	DecisionEngine::Config c = config();
+	c.smooth_n = 3;
+	d.setConfig(c);
+	TEST_ASSERT_EQUAL_INT(3, d.config().smooth_n);
+	TEST_ASSERT_EQUAL_UINT32(5, d.stats().decisions);
+	TEST_ASSERT_EQUAL_UINT32(1, d.stats().hits);
+	TEST_ASSERT_EQUAL_UINT32(1, d.stats().near_misses);
+	TEST_ASSERT_EQUAL_UINT64(at, d.detection().at);
+	TEST_ASSERT_TRUE(d.refractory(at + 1));
+	// The smoothing restarts from empty.
+	TEST_ASSERT_EQUAL_FLOAT(0.0f, d.smoothed());
+
+	d.reset();
+	TEST_ASSERT_EQUAL_UINT32(0, d.stats().decisions);
+	TEST_ASSERT_EQUAL_UINT32(0, d.stats().hits);
+	TEST_ASSERT_FALSE(d.refractory(at + 1));
+}
+
+int main(int argc, char** argv) {
+	UNITY_BEGIN();
+	RUN_TEST(test_peak_is_interpolated);
+	RUN_TEST(test_symmetric_peak_sits_on_its_window);
+	RUN_TEST(test_smoothed_peak_keeps_raw_posterior);
+	RUN_TEST(test_peak_wait_caps_the_hold);
+	RUN_TEST(test_refractory_suppresses_then_releases);
+	RUN_TEST(test_near_misses);
+	RUN_TEST(test_set_config_keeps_stats_and_refractory);
+	return UNITY_END();
+}
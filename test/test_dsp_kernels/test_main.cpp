@@ -0,0 +1,125 @@
+// Every DSP kernel variant compiled into this build (dspk::kVariants)
+// against the scalar reference, for lengths 0..kMaxN so each variant's
+// vector body and scalar tail both run. Products and squares may differ by
+// FMA contraction, sums by accumulation order: window/power are checked to
+// 1e-6 relative, dot to 1e-6 of sum |a*b|. pcm24 must be exact.
+#include <unity.h>
+#include <math.h>
+#include <string.h>
+#include "DSPKernels.h"
+
+static const int kMaxN = 333;
+
+static int16_t	g_pcm[kMaxN];
+static int32_t	g_raw[kMaxN];
+static float	g_a[2 * kMaxN];
+static float	g_b[2 * kMaxN];
+static float	g_ref[2 * kMaxN];
+static float	g_out[2 * kMaxN];
+
+void setUp(void) {}
+void tearDown(void) {}
+
+static uint32_t g_seed = 1;
+static uint32_t next_() {
+	g_seed = g_seed * 1664525u + 1013904223u;
+	return g_seed;
+}
+static float uniform_() { return (float)(next_() >> 8) / 16777216.0f * 2.0f - 1.0f; }
+
+static void fill_() {
+	for (int i = 0; i < kMaxN; ++i) {
+		g_pcm[i] = (int16_t)(next_() >> 16);
+		g_raw[i] = (int32_t)next_();	// full range, so large shifts still saturate
+	}
+	for (int i = 0; i < 2 * kMaxN; ++i) {
+		g_a[i] = 1000.0f * uniform_();
+		g_b[i] = uniform_();
+	}
+}
+
+static void test_variants_listed(void) {
+	TEST_ASSERT_GREATER_OR_EQUAL(1, dspk::kNumVariants);
+	TEST_ASSERT_EQUAL_STRING("scalar", dspk::kVariants[0].name);
+	TEST_ASSERT_EQUAL_STRING(dspk::kVariants[dspk::kNumVariants - 1].name, dspk::variantName());
+}
+
+static void test_window(void) {
+	fill_();
+	for (int v = 0; v < dspk::kNumVariants; ++v) {
+		for (int n = 0; n <= kMaxN; ++n) {
+			dspk::scalar::window(g_pcm, g_b, g_ref, n);
+			memset(g_out, 0, sizeof(g_out));
+			dspk::kVariants[v].window(g_pcm, g_b, g_out, n);
+			for (int i = 0; i < n; ++i) TEST_ASSERT_FLOAT_WITHIN(1e-6f * fabsf(g_ref[i]) + 1e-30f, g_ref[i], g_out[i]);
+			TEST_ASSERT_EQUAL_FLOAT(0.0f, g_out[n]);	// nothing past n written
+		}
+	}
+}
+
+static void test_power(void) {
+	fill_();
+	for (int v = 0; v < dspk::kNumVariants; ++v) {
+		for (int n = 0; n <= kMaxN; ++n) {
+			dspk::scalar::power(g_a, g_ref, n);
+			memset(g_out, 0, sizeof(g_out));
+			dspk::kVariants[v].power(g_a, g_out, n);
+			for (int i = 0; i < n; ++i) TEST_ASSERT_FLOAT_WITHIN(1e-6f * g_ref[i] + 1e-30f, g_ref[i], g_out[i]);
+			TEST_ASSERT_EQUAL_FLOAT(0.0f, g_out[n]);
+		}
+	}
+}
+
+static void test_dot(void) {
+	fill_();
+	for (int v = 0; v < dspk::kNumVariants; ++v) {
+		for (int n = 0; n <= kMaxN; ++n) {
+			double mag = 0.0;
+			for (int i = 0; i < n; ++i) mag += fabs((double)g_a[i] * g_b[i]);
+			const float ref = dspk::scalar::dot(g_a, g_b, n);
+			TEST_ASSERT_FLOAT_WITHIN(1e-6 * mag + 1e-30, ref, dspk::kVariants[v].dot(g_a, g_b, n));
+		}
+	}
+}
+
+static void test_pcm24(void) {
+	fill_();
+	static int16_t ref[kMaxN + 1], out[kMaxN + 1];
+	static const int kShifts[] = { 0, 8, 11, 16, 20 };
+	for (int v = 0; v < dspk::kNumVariants; ++v) {
+		for (int s = 0; s < (int)(sizeof(kShifts) / sizeof(kShifts[0])); ++s) {
+			for (int n = 0; n <= kMaxN; ++n) {
+				dspk::scalar::pcm24(g_raw, ref, n, kShifts[s]);
+				memset(out, 0x5a, sizeof(out));
+				dspk::kVariants[v].pcm24(g_raw, out, n, kShifts[s]);
+				TEST_ASSERT_EQUAL_MEMORY(ref, out, n * sizeof(int16_t));
+				TEST_ASSERT_EQUAL_INT(0x5a5a, (uint16_t)out[n]);
+			}
+		}
+	}
+}
+
+// The reference itself: saturation at both ends, arithmetic shift.
+static void test_pcm24_reference(void) {
+	const int32_t raw[] = { 0x7FFFFF00, (int32_t)0x80000000, 0x00012300, -0x00012300, 256, -256, -1 };
+	int16_t out[7];
+	dspk::scalar::pcm24(raw, out, 7, 8);
+	TEST_ASSERT_EQUAL_INT(32767, out[0]);
+	TEST_ASSERT_EQUAL_INT(-32768, out[1]);
+	TEST_ASSERT_EQUAL_INT(0x123, out[2]);
+	TEST_ASSERT_EQUAL_INT(-0x123, out[3]);
+	TEST_ASSERT_EQUAL_INT(1, out[4]);
+	TEST_ASSERT_EQUAL_INT(-1, out[5]);
+	TEST_ASSERT_EQUAL_INT(-1, out[6]);
+}
+
+int main(int argc, char** argv) {
+	UNITY_BEGIN();
+	RUN_TEST(test_variants_listed);
+	RUN_TEST(test_window);
+	RUN_TEST(test_power);
+	RUN_TEST(test_dot);
+	RUN_TEST(test_pcm24);
+	RUN_TEST(test_pcm24_reference);
+	return UNITY_END();
+}
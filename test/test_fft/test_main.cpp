@@ -0,0 +1,136 @@
+// The FFT backends against ReferenceDFT (double-precision direct DFT), as
+// fftPowerPacked() power spectra: RealFFT at 512, at AP_FRAME_SAMPLES (the
+// AP_FFT_MATCH_FRAME size, mixed radix 4/2/5) and at 480 (which adds
+// radix 3), and FixedRealFFT at 512 on Q15 samples. Signals are a bin-centred
+// tone, two off-bin tones, impulses and noise. The error is measured against
+// the spectrum's peak power: 1e-5 for float, 1e-3 for the Q15 twiddles of the
+// fixed-point path. The packed spectra are also compared directly.
+#include <unity.h>
+#include <math.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+#include "FFTBackend.h"
+#include "FixedRealFFT.h"
+#include "RealFFT.h"
+#include "ReferenceDFT.h"
+#include "frontend_params.h"
+
+static const int kMaxN = 512;
+static const float kFloatTolerance = 1e-5f;
+static const float kFixedTolerance = 1e-3f;
+
+enum Signal { kTone, kOffBin, kImpulse, kShiftedImpulse, kNoise, kNumSignals };
+static const char* const kSignalNames[kNumSignals] = { "tone", "off-bin tones", "impulse", "shifted impulse", "noise" };
+
+static float g_in[kMaxN];
+static float g_out[kMaxN];
+static float g_ref[kMaxN];
+static float g_power[kMaxN / 2 + 1];
+static float g_ref_power[kMaxN / 2 + 1];
+
+void setUp(void) {}
+void tearDown(void) {}
+
+// Within [-1, 1), so the same samples feed the Q15 path.
+static void make(Signal s, int n) {
+	uint32_t seed = 7;
+	for (int t = 0; t < n; ++t) {
+		const double ph = 2.0 * M_PI * t / n;
+		switch (s) {
+		case kTone:				g_in[t] = (float)(0.9 * cos(37.0 * ph + 0.3)); break;
+		case kOffBin:			g_in[t] = (float)(0.6 * sin(12.3 * ph) + 0.3 * cos(101.7 * ph)); break;
+		case kImpulse:			g_in[t] = t == 0 ? 0.9f : 0.0f; break;
+		case kShiftedImpulse:	g_in[t] = t == 5 ? -0.7f : 0.0f; break;
+		default:
+			seed = seed * 1664525u + 1013904223u;
+			g_in[t] = ((float)(seed >> 8) / 16777216.0f - 0.5f) * 1.6f;
+			break;
+		}
+	}
+}
+
+static void reference(int n) {
+	ReferenceDFT dft(n);
+	TEST_ASSERT_EQUAL_INT(n, dft.size());
+	dft.forward(g_in, g_ref);
+	fftPowerPacked(g_ref, n, g_ref_power);
+}
+
+// g_out against g_ref, packed values relative to the peak magnitude and
+// power relative to the peak power.
+static void compare(int n, float tolerance, const char* what) {
+	fftPowerPacked(g_out, n, g_power);
+	float peak = 0.0f;
+	for (int k = 0; k <= n / 2; ++k) peak = g_ref_power[k] > peak ? g_ref_power[k] : peak;
+	TEST_ASSERT_TRUE(peak > 0.0f);
+	const float mag = sqrtf(peak);
+	for (int i = 0; i < n; ++i) {
+		TEST_ASSERT_FLOAT_WITHIN_MESSAGE(tolerance * mag, g_ref[i], g_out[i], what);
+	}
+	for (int k = 0; k <= n / 2; ++k) {
+		TEST_ASSERT_FLOAT_WITHIN_MESSAGE(tolerance * peak, g_ref_power[k], g_power[k], what);
+	}
+}
+
+template <int N>
+static void checkRealFFT(void) {
+	static RealFFT<N> fft;
+	TEST_ASSERT_EQUAL_INT(N, fft.size());
+	for (int s = 0; s < kNumSignals; ++s) {
+		char what[48];
+		snprintf(what, sizeof(what), "RealFFT<%d> %s", N, kSignalNames[s]);
+		make((Signal)s, N);
+		reference(N);
+		fft.forward(g_in, g_out);
+		compare(N, kFloatTolerance, what);
+		// In place, as the frontend calls it.
+		memcpy(g_out, g_in, N * sizeof(float));
+		fft.forward(g_out, g_out);
+		compare(N, kFloatTolerance, what);
+	}
+}
+
+static void test_real_fft_512(void) {
+	checkRealFFT<512>();
+}
+
+static void test_real_fft_frame(void) {
+	checkRealFFT<AP_FRAME_SAMPLES>();
+}
+
+static void test_real_fft_radix3(void) {
+	checkRealFFT<480>();
+}
+
+static void test_fixed_fft_512(void) {
+	static FixedRealFFT<512> fft;
+	static int32_t buf[512];
+	for (int s = 0; s < kNumSignals; ++s) {
+		make((Signal)s, 512);
+		for (int t = 0; t < 512; ++t) {
+			buf[t] = (int32_t)lrintf(g_in[t] * 32768.0f);
+			g_in[t] = (float)buf[t] / 32768.0f;	// the reference sees the same samples
+		}
+		reference(512);
+		const int exponent = fft.forward(buf);
+		for (int i = 0; i < 512; ++i) g_out[i] = ldexpf((float)buf[i], exponent) / 32768.0f;
+		char what[48];
+		snprintf(what, sizeof(what), "FixedRealFFT<512> %s", kSignalNames[s]);
+		compare(512, kFixedTolerance, what);
+	}
+
+	// Silence returns exponent 0 and an all-zero spectrum.
+	memset(buf, 0, sizeof(buf));
+	TEST_ASSERT_EQUAL_INT(0, fft.forward(buf));
+	for (int i = 0; i < 512; ++i) TEST_ASSERT_EQUAL_INT(0, buf[i]);
+}
+
+int main(int argc, char** argv) {
+	UNITY_BEGIN();
+	RUN_TEST(test_real_fft_512);
+	RUN_TEST(test_real_fft_frame);
+	RUN_TEST(test_real_fft_radix3);
+	RUN_TEST(test_fixed_fft_512);
+	return UNITY_END();
+}
@@ -0,0 +1,186 @@
+// The all-integer frontend against the float one on the same frames:
+// every int8 row must match the quantized float row to within 1 LSB of
+// the model's input scale. Before quantization, the Q16 log2 mel energies
+// and the Q40 DCT sums must match the float log-mel and normalized MFCC
+// row, with tolerances in those float units. Until KWS_FRAMES rows are in,
+// both paths hand out an all-zero (float) or all-zero-point (int8) window.
+#include <unity.h>
+#include <math.h>
+#include "AudioProcessor.h"
+#include "model_weights.h"
+
+static AudioProcessor g_float;
+static AudioProcessor g_int8;
+
+static const int kNewest = (KWS_FRAMES - 1) * KWS_NUM_MFCC;
+static const int kToleranceLsb = 1;
+static const float kLogMelTolerance = 0.06f;	// natural log units
+static const float kLogMelBias = 0.01f;			// mean over all bands and frames
+static const float kAccTolerance = 0.02f;		// normalized MFCC units
+
+void setUp(void) {}
+void tearDown(void) {}
+
+// Tone plus LCG noise at the given peak level.
+static void makeFrame(int16_t* pcm, int frame, float amp, uint32_t& seed) {
+	const float f = 0.02f + 0.03f * (float)(frame % 11);
+	for (int i = 0; i < AP_FRAME_SAMPLES; ++i) {
+		seed = seed * 1664525u + 1013904223u;
+		const float noise = ((float)(seed >> 16) / 65536.0f - 0.5f) * 0.2f * amp;
+		float v = amp * sinf(f * (float)(frame * AP_HOP_SAMPLES + i)) + noise;
+		if (v > 32767.0f) v = 32767.0f;
+		if (v < -32768.0f) v = -32768.0f;
+		pcm[i] = (int16_t)v;
+	}
+}
+
+static void test_modes_switch(void) {
+	TEST_ASSERT_TRUE(g_float.begin());
+	TEST_ASSERT_TRUE(g_int8.begin());
+	TEST_ASSERT_TRUE(g_int8.setMode(AudioProcessor::Mode::Int8));
+	TEST_ASSERT_TRUE(g_int8.mode() == AudioProcessor::Mode::Int8);
+	TEST_ASSERT_TRUE(g_float.mode() == AudioProcessor::Mode::Float);
+}
+
+static void test_rows_match_quantized_float(void) {
+	static const float kLevels[] = { 30000.0f, 8000.0f, 1000.0f, 100.0f, 10.0f };
+	int16_t pcm[AP_FRAME_SAMPLES];
+	uint32_t seed = 12345;
+	int rows = 0, exact = 0, worst = 0;
+	for (int frame = 0; frame < 200; ++frame) {
+		makeFrame(pcm, frame, kLevels[frame % 5], seed);
+		g_float.processFrame(pcm);
+		g_int8.processFrame(pcm);
+		FeatureWindow wf, wq;
+		g_float.features().window(wf);
+		g_int8.features().window(wq);
+		TEST_ASSERT_NOT_NULL(wf.mfcc);
+		TEST_ASSERT_NOT_NULL(wq.mfcc_q);
+		bool same = true;
+		for (int c = 0; c < KWS_NUM_MFCC; ++c) {
+			const int expect = FeatureBus::quantize(wf.mfcc[kNewest + c]);
+			const int got = wq.mfcc_q[kNewest + c];
+			const int d = abs(got - expect);
+			if (d > worst) worst = d;
+			same = same && d == 0;
+			TEST_ASSERT_INT_WITHIN(kToleranceLsb, expect, got);
+		}
+		rows++;
+		exact += same;
+	}
+	char msg[80];
+	snprintf(msg, sizeof(msg), "%d/%d rows exact, worst %d LSB", exact, rows, worst);
+	TEST_MESSAGE(msg);
+}
+
+static void test_first_window_waits_for_kws_frames(void) {
+	static AudioProcessor ap;
+	static float window[KWS_FRAMES * KWS_NUM_MFCC];
+	static int8_t window_q[KWS_FRAMES * KWS_NUM_MFCC];
+	TEST_ASSERT_TRUE(ap.begin());
+	TEST_ASSERT_FALSE(ap.hasFullWindow());
+	int16_t pcm[AP_FRAME_SAMPLES];
+	uint32_t seed = 777;
+	for (int frame = 0; frame < KWS_FRAMES; ++frame) {
+		TEST_ASSERT_FALSE(ap.hasFullWindow());
+		ap.computeMFCCFloat(window);
+		for (int i = 0; i < KWS_FRAMES * KWS_NUM_MFCC; ++i) TEST_ASSERT_EQUAL_FLOAT(0.0f, window[i]);
+		makeFrame(pcm, frame, 8000.0f, seed);
+		ap.processFrame(pcm);
+	}
+	TEST_ASSERT_TRUE(ap.hasFullWindow());
+	ap.computeMFCCFloat(window);
+	TEST_ASSERT_TRUE(fabsf(window[kNewest]) > 0.0f);
+
+	// begin() starts over, in either mode.
+	TEST_ASSERT_TRUE(ap.setMode(AudioProcessor::Mode::Int8));
+	TEST_ASSERT_TRUE(ap.begin());
+	TEST_ASSERT_FALSE(ap.hasFullWindow());
+	ap.computeMFCCInt8(window_q);
+	for (int i = 0; i < KWS_FRAMES * KWS_NUM_MFCC; ++i) TEST_ASSERT_EQUAL_INT((int8_t)input_zero_point, window_q[i]);
+	for (int frame = 0; frame < KWS_FRAMES; ++frame) ap.processFrame(pcm);
+	TEST_ASSERT_TRUE(ap.hasFullWindow());
+}
+
+// Runs one frame through both paths stage by stage, keeping what each
+// produces before quantization.
+class FrontendProbe {
+public:
+	float	log_mel[KWS_NUM_MEL];		// ln(E), float path
+	float	row[KWS_NUM_MFCC];			// normalized MFCC, float path
+	int32_t	log_mel_q16[KWS_NUM_MEL];	// log2(E), Q16, int8 path
+	int64_t	acc_q40[KWS_NUM_MFCC];		// DCT sums in quantized units, Q40
+	int8_t	q_row[KWS_NUM_MFCC];
+
+	void run(AudioProcessor& p, const int16_t* pcm) {
+		p.stageWindow_(pcm);
+		p.stageFFT_();
+		p.stagePower_();
+		AudioProcessor::stageMel_(p.power_, log_mel);
+		AudioProcessor::stageLog_(log_mel);
+		AudioProcessor::stageDct_(log_mel, row);
+#if AP_HAS_INT8_FRONTEND
+		p.stageWindowQ_(pcm);
+		const int exponent = p.stageFFTQ_();
+		p.stageLogMelQ_(exponent, log_mel_q16);
+		AudioProcessor::stageDctQ_(log_mel_q16, q_row, acc_q40);
+#endif
+	}
+};
+
+static void test_stages_match_float(void) {
+	static const float kLevels[] = { 30000.0f, 8000.0f, 1000.0f, 100.0f, 10.0f };
+	static AudioProcessor ap;
+	static FrontendProbe probe;
+	TEST_ASSERT_TRUE(ap.begin());
+	int16_t pcm[AP_FRAME_SAMPLES];
+	uint32_t seed = 4242;
+	float worst_mel = 0.0f, worst_acc = 0.0f;
+	double bias = 0.0;
+	for (int frame = 0; frame < 200; ++frame) {
+		makeFrame(pcm, frame, kLevels[frame % 5], seed);
+		probe.run(ap, pcm);
+		for (int m = 0; m < KWS_NUM_MEL; ++m) {
+			const float ln = (float)probe.log_mel_q16[m] / 65536.0f * (float)M_LN2;
+			const float d = fabsf(ln - probe.log_mel[m]);
+			if (d > worst_mel) worst_mel = d;
+			bias += ln - probe.log_mel[m];
+			TEST_ASSERT_FLOAT_WITHIN(kLogMelTolerance, probe.log_mel[m], ln);
+		}
+		for (int c = 0; c < KWS_NUM_MFCC; ++c) {
+			const float v = ((float)probe.acc_q40[c] / 1099511627776.0f - (float)input_zero_point) * input_scale;
+			const float d = fabsf(v - probe.row[c]);
+			if (d > worst_acc) worst_acc = d;
+			TEST_ASSERT_FLOAT_WITHIN(kAccTolerance, probe.row[c], v);
+		}
+	}
+	// Per-band errors are noise; a constant offset would show up here.
+	bias /= 200.0 * KWS_NUM_MEL;
+	TEST_ASSERT_FLOAT_WITHIN(kLogMelBias, 0.0f, (float)bias);
+	char msg[80];
+	snprintf(msg, sizeof(msg), "worst log-mel %.5f (bias %.5f), worst DCT %.5f", worst_mel, bias, worst_acc);
+	TEST_MESSAGE(msg);
+}
+
+// Silence sits on the log floor in both paths.
+static void test_silence(void) {
+	int16_t pcm[AP_FRAME_SAMPLES] = {};
+	g_float.processFrame(pcm);
+	g_int8.processFrame(pcm);
+	FeatureWindow wf, wq;
+	g_float.features().window(wf);
+	g_int8.features().window(wq);
+	for (int c = 0; c < KWS_NUM_MFCC; ++c) {
+		TEST_ASSERT_INT_WITHIN(kToleranceLsb, FeatureBus::quantize(wf.mfcc[kNewest + c]), wq.mfcc_q[kNewest + c]);
+	}
+}
+
+int main(int argc, char** argv) {
+	UNITY_BEGIN();
+	RUN_TEST(test_modes_switch);
+	RUN_TEST(test_rows_match_quantized_float);
+	RUN_TEST(test_stages_match_float);
+	RUN_TEST(test_silence);
+	RUN_TEST(test_first_window_waits_for_kws_frames);
+	return UNITY_END();
+}
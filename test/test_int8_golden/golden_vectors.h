@@ -0,0 +1,233 @@
+#pragma once
+#include <stdint.h>
+
+// Generated by tools/int8_golden.py from lib/ManualDSCNN/model_int8.cc.bak. Do not edit.
+// Inputs run through a Python port of the TFLite reference kernels;
+// logits are the int8 dense output, probs the softmax of the dequantized
+// logits in double precision.
+
+struct GoldenVector {
+	const char*	name;
+	int8_t		input[650];
+	int8_t		logits[3];
+	float		probs[3];
+};
+
+static const GoldenVector kGolden[] = {
+	{ "silence", {
+		58, 58, 58, 58, 58, 58, 58, 58, 58, 58, 58, 58, 58, 58, 58, 58, 58, 58, 58, 58,
+		58, 58, 58, 58, 58, 58, 58, 58, 58, 58, 58, 58, 58, 58, 58, 58, 58, 58, 58, 58,
+		58, 58, 58, 58, 58, 58, 58, 58, 58, 58, 58, 58, 58, 58, 58, 58, 58, 58, 58, 58,
+		58, 58, 58, 58, 58, 58, 58, 58, 58, 58, 58, 58, 58, 58, 58, 58, 58, 58, 58, 58,
+		58, 58, 58, 58, 58, 58, 58, 58, 58, 58, 58, 58, 58, 58, 58, 58, 58, 58, 58, 58,
+		58, 58, 58, 58, 58, 58, 58, 58, 58, 58, 58, 58, 58, 58, 58, 58, 58, 58, 58, 58,
+		58, 58, 58, 58, 58, 58, 58, 58, 58, 58, 58, 58, 58, 58, 58, 58, 58, 58, 58, 58,
+		58, 58, 58, 58, 58, 58, 58, 58, 58, 58, 58, 58, 58, 58, 58, 58, 58, 58, 58, 58,
+		58, 58, 58, 58, 58, 58, 58, 58, 58, 58, 58, 58, 58, 58, 58, 58, 58, 58, 58, 58,
+		58, 58, 58, 58, 58, 58, 58, 58, 58, 58, 58, 58, 58, 58, 58, 58, 58, 58, 58, 58,
+		58, 58, 58, 58, 58, 58, 58, 58, 58, 58, 58, 58, 58, 58, 58, 58, 58, 58, 58, 58,
+		58, 58, 58, 58, 58, 58, 58, 58, 58, 58, 58, 58, 58, 58, 58, 58, 58, 58, 58, 58,
+		58, 58, 58, 58, 58, 58, 58, 58, 58, 58, 58, 58, 58, 58, 58, 58, 58, 58, 58, 58,
+		58, 58, 58, 58, 58, 58, 58, 58, 58, 58, 58, 58, 58, 58, 58, 58, 58, 58, 58, 58,
+		58, 58, 58, 58, 58, 58, 58, 58, 58, 58, 58, 58, 58, 58, 58, 58, 58, 58, 58, 58,
+		58, 58, 58, 58, 58, 58, 58, 58, 58, 58, 58, 58, 58, 58, 58, 58, 58, 58, 58, 58,
+		58, 58, 58, 58, 58, 58, 58, 58, 58, 58, 58, 58, 58, 58, 58, 58, 58, 58, 58, 58,
+		58, 58, 58, 58, 58, 58, 58, 58, 58, 58, 58, 58, 58, 58, 58, 58, 58, 58, 58, 58,
+		58, 58, 58, 58, 58, 58, 58, 58, 58, 58, 58, 58, 58, 58, 58, 58, 58, 58, 58, 58,
+		58, 58, 58, 58, 58, 58, 58, 58, 58, 58, 58, 58, 58, 58, 58, 58, 58, 58, 58, 58,
+		58, 58, 58, 58, 58, 58, 58, 58, 58, 58, 58, 58, 58, 58, 58, 58, 58, 58, 58, 58,
+		58, 58, 58, 58, 58, 58, 58, 58, 58, 58, 58, 58, 58, 58, 58, 58, 58, 58, 58, 58,
+		58, 58, 58, 58, 58, 58, 58, 58, 58, 58, 58, 58, 58, 58, 58, 58, 58, 58, 58, 58,
+		58, 58, 58, 58, 58, 58, 58, 58, 58, 58, 58, 58, 58, 58, 58, 58, 58, 58, 58, 58,
+		58, 58, 58, 58, 58, 58, 58, 58, 58, 58, 58, 58, 58, 58, 58, 58, 58, 58, 58, 58,
+		58, 58, 58, 58, 58, 58, 58, 58, 58, 58, 58, 58, 58, 58, 58, 58, 58, 58, 58, 58,
+		58, 58, 58, 58, 58, 58, 58, 58, 58, 58, 58, 58, 58, 58, 58, 58, 58, 58, 58, 58,
+		58, 58, 58, 58, 58, 58, 58, 58, 58, 58, 58, 58, 58, 58, 58, 58, 58, 58, 58, 58,
+		58, 58, 58, 58, 58, 58, 58, 58, 58, 58, 58, 58, 58, 58, 58, 58, 58, 58, 58, 58,
+		58, 58, 58, 58, 58, 58, 58, 58, 58, 58, 58, 58, 58, 58, 58, 58, 58, 58, 58, 58,
+		58, 58, 58, 58, 58, 58, 58, 58, 58, 58, 58, 58, 58, 58, 58, 58, 58, 58, 58, 58,
+		58, 58, 58, 58, 58, 58, 58, 58, 58, 58, 58, 58, 58, 58, 58, 58, 58, 58, 58, 58,
+		58, 58, 58, 58, 58, 58, 58, 58, 58, 58,
+	  }, { -50, -11, -56 },
+	  { 0.0589666254f, 0.902277322f, 0.038756053f } },
+	{ "extremes", {
+		-128, 127, 127, -128, 127, 127, -128, 127, 127, -128, 127, -128, 127, 127, -128, 127, 127, -128, 127, 127,
+		127, 127, -128, 127, 127, -128, 127, 127, -128, 127, -128, 127, 127, -128, 127, 127, -128, 127, 127, -128,
+		127, -128, 127, 127, -128, 127, 127, -128, 127, 127, 127, 127, -128, 127, 127, -128, 127, 127, -128, 127,
+		-128, 127, 127, -128, 127, 127, -128, 127, 127, -128, 127, -128, 127, 127, -128, 127, 127, -128, 127, 127,
+		127, 127, -128, 127, 127, -128, 127, 127, -128, 127, -128, 127, 127, -128, 127, 127, -128, 127, 127, -128,
+		127, -128, 127, 127, -128, 127, 127, -128, 127, 127, 127, 127, -128, 127, 127, -128, 127, 127, -128, 127,
+		-128, 127, 127, -128, 127, 127, -128, 127, 127, -128, 127, -128, 127, 127, -128, 127, 127, -128, 127, 127,
+		127, 127, -128, 127, 127, -128, 127, 127, -128, 127, -128, 127, 127, -128, 127, 127, -128, 127, 127, -128,
+		127, -128, 127, 127, -128, 127, 127, -128, 127, 127, 127, 127, -128, 127, 127, -128, 127, 127, -128, 127,
+		-128, 127, 127, -128, 127, 127, -128, 127, 127, -128, 127, -128, 127, 127, -128, 127, 127, -128, 127, 127,
+		127, 127, -128, 127, 127, -128, 127, 127, -128, 127, -128, 127, 127, -128, 127, 127, -128, 127, 127, -128,
+		127, -128, 127, 127, -128, 127, 127, -128, 127, 127, 127, 127, -128, 127, 127, -128, 127, 127, -128, 127,
+		-128, 127, 127, -128, 127, 127, -128, 127, 127, -128, 127, -128, 127, 127, -128, 127, 127, -128, 127, 127,
+		127, 127, -128, 127, 127, -128, 127, 127, -128, 127, -128, 127, 127, -128, 127, 127, -128, 127, 127, -128,
+		127, -128, 127, 127, -128, 127, 127, -128, 127, 127, 127, 127, -128, 127, 127, -128, 127, 127, -128, 127,
+		-128, 127, 127, -128, 127, 127, -128, 127, 127, -128, 127, -128, 127, 127, -128, 127, 127, -128, 127, 127,
+		127, 127, -128, 127, 127, -128, 127, 127, -128, 127, -128, 127, 127, -128, 127, 127, -128, 127, 127, -128,
+		127, -128, 127, 127, -128, 127, 127, -128, 127, 127, 127, 127, -128, 127, 127, -128, 127, 127, -128, 127,
+		-128, 127, 127, -128, 127, 127, -128, 127, 127, -128, 127, -128, 127, 127, -128, 127, 127, -128, 127, 127,
+		127, 127, -128, 127, 127, -128, 127, 127, -128, 127, -128, 127, 127, -128, 127, 127, -128, 127, 127, -128,
+		127, -128, 127, 127, -128, 127, 127, -128, 127, 127, 127, 127, -128, 127, 127, -128, 127, 127, -128, 127,
+		-128, 127, 127, -128, 127, 127, -128, 127, 127, -128, 127, -128, 127, 127, -128, 127, 127, -128, 127, 127,
+		127, 127, -128, 127, 127, -128, 127, 127, -128, 127, -128, 127, 127, -128, 127, 127, -128, 127, 127, -128,
+		127, -128, 127, 127, -128, 127, 127, -128, 127, 127, 127, 127, -128, 127, 127, -128, 127, 127, -128, 127,
+		-128, 127, 127, -128, 127, 127, -128, 127, 127, -128, 127, -128, 127, 127, -128, 127, 127, -128, 127, 127,
+		127, 127, -128, 127, 127, -128, 127, 127, -128, 127, -128, 127, 127, -128, 127, 127, -128, 127, 127, -128,
+		127, -128, 127, 127, -128, 127, 127, -128, 127, 127, 127, 127, -128, 127, 127, -128, 127, 127, -128, 127,
+		-128, 127, 127, -128, 127, 127, -128, 127, 127, -128, 127, -128, 127, 127, -128, 127, 127, -128, 127, 127,
+		127, 127, -128, 127, 127, -128, 127, 127, -128, 127, -128, 127, 127, -128, 127, 127, -128, 127, 127, -128,
+		127, -128, 127, 127, -128, 127, 127, -128, 127, 127, 127, 127, -128, 127, 127, -128, 127, 127, -128, 127,
+		-128, 127, 127, -128, 127, 127, -128, 127, 127, -128, 127, -128, 127, 127, -128, 127, 127, -128, 127, 127,
+		127, 127, -128, 127, 127, -128, 127, 127, -128, 127, -128, 127, 127, -128, 127, 127, -128, 127, 127, -128,
+		127, -128, 127, 127, -128, 127, 127, -128, 127, 127,
+	  }, { -128, 127, -128 },
+	  { 1.79334486e-08f, 0.999999964f, 1.79334486e-08f } },
+	{ "noise_2", {
+		58, 60, 57, 60, 60, 56, 59, 57, 57, 60, 57, 56, 56, 58, 60, 56, 59, 59, 56, 56,
+		57, 57, 60, 59, 58, 57, 58, 58, 58, 57, 59, 59, 57, 56, 57, 59, 59, 58, 59, 56,
+		57, 57, 60, 60, 57, 58, 58, 59, 60, 59, 59, 60, 58, 56, 56, 59, 57, 57, 60, 59,
+		60, 58, 60, 58, 59, 59, 57, 60, 57, 56, 58, 56, 60, 59, 57, 60, 57, 57, 58, 56,
+		57, 58, 57, 59, 60, 57, 60, 56, 57, 57, 60, 59, 56, 59, 58, 58, 57, 60, 58, 58,
+		58, 57, 60, 60, 57, 58, 57, 57, 57, 58, 60, 60, 60, 59, 56, 59, 57, 58, 57, 58,
+		58, 58, 58, 57, 60, 57, 57, 57, 59, 57, 57, 58, 57, 60, 56, 58, 59, 59, 56, 57,
+		58, 57, 60, 57, 56, 56, 57, 59, 56, 60, 60, 60, 56, 59, 59, 56, 58, 58, 60, 57,
+		56, 60, 57, 56, 59, 59, 59, 57, 60, 59, 56, 57, 59, 59, 56, 59, 57, 59, 56, 56,
+		60, 58, 60, 60, 57, 56, 56, 56, 57, 59, 60, 57, 56, 56, 57, 57, 59, 59, 59, 58,
+		59, 56, 60, 58, 57, 60, 60, 58, 58, 60, 57, 57, 58, 60, 56, 58, 56, 56, 60, 57,
+		57, 60, 56, 60, 56, 57, 57, 56, 60, 60, 60, 57, 59, 59, 59, 56, 59, 59, 60, 59,
+		60, 58, 58, 60, 60, 58, 59, 58, 60, 59, 60, 59, 56, 56, 56, 60, 57, 56, 58, 58,
+		59, 59, 60, 59, 60, 60, 60, 58, 59, 59, 57, 58, 57, 56, 59, 56, 58, 58, 56, 56,
+		58, 60, 60, 59, 59, 60, 57, 57, 57, 60, 56, 56, 60, 59, 57, 59, 58, 56, 56, 59,
+		56, 60, 59, 58, 58, 58, 60, 59, 57, 60, 59, 59, 60, 56, 56, 60, 60, 58, 58, 58,
+		58, 56, 60, 57, 56, 58, 60, 56, 60, 56, 59, 56, 60, 57, 59, 57, 57, 59, 59, 56,
+		59, 59, 60, 57, 57, 59, 59, 56, 59, 56, 60, 58, 56, 56, 59, 58, 56, 56, 56, 59,
+		60, 56, 58, 57, 58, 57, 59, 57, 58, 56, 57, 56, 56, 57, 57, 57, 60, 56, 58, 59,
+		58, 58, 56, 59, 59, 56, 60, 60, 59, 57, 58, 56, 57, 56, 60, 56, 57, 59, 57, 58,
+		58, 56, 59, 58, 56, 57, 57, 60, 57, 59, 57, 56, 56, 60, 60, 58, 57, 58, 58, 58,
+		60, 58, 56, 58, 57, 57, 58, 56, 60, 58, 60, 57, 57, 56, 59, 57, 59, 59, 56, 57,
+		60, 59, 60, 59, 58, 58, 57, 58, 57, 56, 57, 57, 57, 56, 56, 60, 60, 57, 58, 59,
+		59, 56, 60, 58, 60, 56, 57, 58, 56, 56, 59, 58, 58, 60, 60, 58, 60, 58, 56, 60,
+		57, 60, 60, 58, 59, 59, 60, 60, 60, 59, 59, 59, 60, 56, 56, 59, 58, 58, 60, 59,
+		59, 60, 59, 57, 60, 56, 59, 57, 57, 57, 59, 60, 56, 56, 60, 56, 56, 56, 57, 56,
+		59, 59, 58, 59, 58, 57, 57, 57, 56, 58, 56, 60, 60, 57, 58, 60, 57, 56, 57, 59,
+		58, 60, 60, 59, 57, 59, 59, 59, 58, 59, 58, 59, 60, 58, 60, 57, 59, 60, 58, 58,
+		59, 60, 56, 59, 59, 56, 58, 59, 59, 56, 56, 58, 60, 56, 56, 58, 56, 59, 59, 59,
+		60, 57, 57, 56, 58, 57, 57, 56, 57, 59, 57, 56, 60, 57, 58, 58, 57, 59, 59, 59,
+		60, 60, 56, 56, 59, 59, 59, 57, 59, 60, 59, 60, 59, 56, 60, 58, 57, 57, 59, 57,
+		56, 57, 58, 59, 56, 57, 60, 60, 60, 56, 60, 57, 59, 57, 60, 58, 57, 58, 59, 59,
+		56, 60, 57, 60, 59, 57, 59, 58, 58, 57,
+	  }, { -63, 7, -64 },
+	  { 0.00736761748f, 0.9857625f, 0.00686988205f } },
+	{ "noise_4", {
+		62, 54, 60, 54, 56, 58, 59, 60, 56, 56, 55, 56, 56, 61, 62, 58, 56, 59, 59, 55,
+		54, 61, 62, 58, 60, 55, 59, 61, 55, 61, 61, 57, 57, 54, 57, 59, 60, 55, 60, 62,
+		57, 56, 56, 62, 62, 55, 57, 61, 62, 59, 56, 57, 54, 60, 56, 56, 54, 56, 56, 54,
+		55, 54, 54, 62, 62, 58, 57, 56, 54, 62, 57, 62, 60, 55, 61, 56, 60, 55, 57, 62,
+		59, 57, 62, 56, 61, 54, 58, 60, 61, 56, 56, 55, 55, 59, 55, 59, 55, 55, 62, 57,
+		57, 57, 54, 54, 61, 62, 58, 57, 61, 62, 59, 54, 55, 54, 58, 55, 60, 62, 55, 61,
+		61, 54, 56, 61, 54, 59, 59, 60, 54, 58, 55, 59, 55, 56, 54, 55, 56, 59, 58, 56,
+		60, 60, 60, 59, 60, 55, 56, 56, 55, 59, 55, 62, 59, 55, 55, 62, 54, 56, 55, 57,
+		60, 60, 59, 55, 58, 54, 61, 57, 58, 54, 55, 60, 60, 57, 58, 59, 57, 55, 60, 59,
+		60, 62, 60, 54, 59, 55, 58, 58, 57, 58, 56, 60, 56, 60, 60, 58, 61, 59, 57, 60,
+		60, 57, 62, 55, 59, 61, 61, 61, 55, 54, 54, 59, 62, 62, 55, 58, 55, 61, 60, 59,
+		61, 61, 54, 54, 54, 56, 56, 59, 58, 59, 58, 57, 59, 58, 61, 59, 56, 62, 60, 54,
+		61, 59, 54, 55, 61, 55, 62, 54, 56, 58, 62, 59, 60, 54, 57, 57, 58, 58, 57, 54,
+		58, 59, 60, 55, 58, 58, 56, 61, 55, 59, 62, 59, 60, 56, 57, 55, 55, 58, 56, 57,
+		55, 60, 62, 55, 55, 61, 55, 61, 58, 54, 56, 59, 55, 56, 56, 58, 62, 59, 55, 56,
+		55, 55, 62, 62, 60, 57, 58, 61, 58, 60, 62, 55, 55, 54, 59, 56, 59, 56, 55, 57,
+		60, 57, 55, 54, 56, 60, 61, 62, 62, 62, 54, 59, 55, 58, 59, 56, 61, 57, 60, 55,
+		59, 61, 60, 61, 62, 59, 54, 54, 61, 60, 62, 60, 55, 62, 57, 59, 55, 60, 56, 60,
+		58, 58, 55, 56, 59, 57, 56, 56, 58, 55, 59, 59, 58, 59, 55, 62, 54, 56, 57, 61,
+		58, 56, 57, 61, 61, 57, 59, 61, 59, 61, 57, 58, 55, 59, 54, 57, 55, 58, 62, 60,
+		61, 54, 62, 58, 58, 56, 58, 54, 58, 58, 60, 62, 57, 59, 60, 56, 55, 57, 61, 61,
+		61, 55, 61, 56, 55, 58, 56, 54, 58, 58, 60, 57, 57, 61, 55, 57, 60, 59, 60, 54,
+		57, 59, 58, 59, 61, 55, 58, 59, 57, 55, 54, 54, 59, 60, 61, 58, 57, 59, 58, 54,
+		58, 62, 54, 55, 55, 60, 55, 59, 59, 57, 60, 61, 59, 61, 60, 59, 54, 54, 55, 56,
+		59, 54, 58, 57, 59, 54, 55, 59, 54, 62, 54, 62, 58, 59, 56, 62, 59, 61, 60, 58,
+		60, 54, 58, 56, 61, 56, 62, 61, 56, 54, 60, 54, 62, 55, 56, 55, 54, 59, 61, 58,
+		60, 61, 55, 55, 57, 54, 60, 56, 60, 62, 60, 57, 62, 60, 59, 59, 58, 59, 58, 58,
+		55, 58, 58, 56, 59, 59, 59, 60, 60, 54, 55, 62, 55, 62, 57, 57, 61, 57, 55, 61,
+		59, 58, 54, 58, 55, 62, 54, 58, 54, 61, 55, 56, 58, 54, 56, 55, 61, 62, 57, 58,
+		61, 60, 57, 61, 59, 55, 62, 55, 62, 56, 59, 60, 62, 56, 55, 54, 58, 61, 54, 59,
+		58, 59, 56, 59, 60, 56, 54, 56, 59, 55, 55, 61, 62, 57, 59, 59, 56, 57, 56, 59,
+		62, 57, 56, 60, 57, 56, 60, 62, 61, 59, 58, 60, 59, 55, 62, 55, 56, 58, 60, 55,
+		55, 57, 62, 61, 60, 58, 59, 55, 55, 62,
+	  }, { -91, 52, -85 },
+	  { 4.52821038e-05f, 0.999885822f, 6.88958924e-05f } },
+	{ "smooth", {
+		58, 60, 61, 61, 59, 57, 55, 55, 56, 58, 59, 60, 61, 60, 58, 56, 55, 55, 57, 59,
+		59, 61, 61, 60, 58, 56, 55, 56, 57, 59, 60, 61, 61, 59, 57, 55, 55, 56, 58, 60,
+		60, 61, 60, 59, 57, 55, 55, 56, 58, 60, 61, 61, 60, 58, 56, 55, 55, 57, 59, 61,
+		61, 61, 59, 57, 56, 55, 56, 58, 60, 61, 61, 60, 59, 57, 55, 55, 56, 58, 60, 61,
+		61, 60, 58, 56, 55, 55, 57, 59, 61, 61, 61, 60, 58, 56, 55, 56, 57, 59, 61, 61,
+		61, 59, 57, 55, 55, 56, 58, 60, 61, 61, 60, 58, 56, 55, 55, 57, 59, 60, 61, 60,
+		60, 58, 56, 55, 56, 57, 59, 61, 61, 60, 59, 57, 55, 55, 56, 58, 60, 61, 61, 59,
+		59, 57, 55, 55, 56, 58, 60, 61, 60, 59, 58, 56, 55, 55, 57, 59, 61, 61, 60, 58,
+		57, 56, 55, 56, 58, 60, 61, 61, 59, 57, 57, 55, 55, 56, 58, 60, 61, 60, 59, 57,
+		56, 55, 55, 57, 59, 61, 61, 60, 58, 56, 56, 55, 56, 57, 59, 61, 61, 60, 58, 56,
+		55, 55, 56, 58, 60, 61, 61, 59, 57, 55, 55, 55, 57, 59, 60, 61, 60, 58, 56, 55,
+		55, 56, 57, 59, 61, 61, 60, 58, 56, 55, 55, 56, 58, 60, 61, 61, 59, 57, 55, 55,
+		55, 56, 58, 60, 61, 60, 59, 57, 55, 55, 55, 57, 59, 61, 61, 60, 58, 56, 55, 55,
+		56, 58, 60, 61, 61, 59, 57, 56, 55, 56, 56, 58, 60, 61, 60, 59, 57, 55, 55, 56,
+		57, 59, 61, 61, 60, 58, 56, 55, 55, 57, 57, 59, 61, 61, 60, 58, 56, 55, 56, 57,
+		58, 60, 61, 61, 59, 57, 55, 55, 56, 58, 59, 60, 61, 60, 58, 56, 55, 55, 57, 59,
+		59, 61, 61, 60, 58, 56, 55, 56, 57, 59, 60, 61, 61, 59, 57, 55, 55, 56, 58, 60,
+		60, 61, 60, 59, 57, 55, 55, 56, 59, 60, 61, 61, 60, 58, 56, 55, 55, 57, 59, 61,
+		61, 61, 59, 57, 56, 55, 56, 58, 60, 61, 61, 60, 59, 57, 55, 55, 56, 58, 60, 61,
+		61, 60, 58, 56, 55, 55, 57, 59, 61, 61, 61, 60, 58, 56, 55, 56, 57, 60, 61, 61,
+		61, 59, 57, 55, 55, 56, 58, 60, 61, 61, 60, 58, 56, 55, 55, 57, 59, 60, 61, 60,
+		60, 58, 56, 55, 56, 57, 59, 61, 61, 60, 59, 57, 55, 55, 56, 58, 60, 61, 61, 59,
+		59, 57, 55, 55, 56, 59, 60, 61, 60, 59, 58, 56, 55, 55, 57, 59, 61, 61, 60, 58,
+		57, 56, 55, 56, 58, 60, 61, 61, 59, 57, 57, 55, 55, 56, 58, 60, 61, 60, 59, 57,
+		56, 55, 55, 57, 59, 61, 61, 60, 58, 56, 56, 55, 56, 57, 60, 61, 61, 59, 57, 56,
+		55, 55, 56, 58, 60, 61, 61, 59, 57, 55, 55, 55, 57, 59, 60, 61, 60, 58, 56, 55,
+		55, 56, 57, 59, 61, 61, 60, 58, 56, 55, 55, 56, 58, 60, 61, 61, 59, 57, 55, 55,
+		55, 56, 59, 60, 61, 60, 59, 56, 55, 55, 55, 57, 59, 61, 61, 60, 58, 56, 55, 55,
+		56, 58, 60, 61, 61, 59, 57, 56, 55, 56, 56, 58, 60, 61, 60, 59, 57, 55, 55, 56,
+		57, 59, 61, 61, 60, 58, 56, 55, 55, 57, 57, 60, 61, 61, 59, 57, 56, 55, 56, 58,
+		58, 60, 61, 61, 59, 57, 55, 55, 56, 58, 59, 60, 61, 60, 58, 56, 55, 55, 57, 59,
+		59, 61, 61, 60, 58, 56, 55, 56, 57, 59, 60, 61, 61, 59, 57, 55, 55, 56, 58, 60,
+		60, 61, 60, 59, 56, 55, 55, 57, 59, 60,
+	  }, { -88, 47, -84 },
+	  { 7.92352727e-05f, 0.999815948f, 0.000104816514f } },
+	{ "burst", {
+		58, 59, 58, 59, 58, 59, 58, 58, 58, 58, 58, 59, 58, 59, 58, 59, 58, 58, 57, 58,
+		58, 59, 58, 59, 57, 58, 57, 58, 57, 58, 58, 59, 57, 58, 57, 58, 57, 58, 57, 58,
+		57, 58, 57, 58, 56, 58, 57, 59, 58, 59, 56, 58, 56, 58, 57, 59, 58, 60, 58, 60,
+		56, 58, 56, 59, 57, 60, 58, 60, 58, 60, 56, 59, 57, 60, 58, 61, 58, 60, 57, 59,
+		57, 61, 58, 61, 58, 60, 57, 59, 56, 58, 58, 62, 58, 61, 57, 59, 55, 58, 55, 58,
+		58, 61, 57, 59, 55, 58, 54, 58, 54, 58, 56, 60, 54, 58, 53, 58, 54, 59, 56, 61,
+		54, 58, 53, 58, 53, 59, 55, 61, 58, 63, 52, 58, 53, 59, 55, 62, 58, 64, 59, 63,
+		52, 59, 55, 62, 58, 64, 59, 64, 58, 62, 55, 63, 58, 65, 59, 65, 57, 62, 55, 59,
+		58, 66, 59, 66, 57, 63, 54, 59, 51, 57, 59, 66, 57, 63, 53, 59, 50, 57, 49, 58,
+		57, 63, 52, 59, 49, 57, 48, 58, 51, 61, 52, 59, 48, 57, 48, 58, 51, 62, 55, 66,
+		47, 57, 47, 58, 50, 63, 55, 67, 59, 69, 46, 59, 50, 63, 55, 68, 59, 70, 59, 68,
+		49, 64, 55, 69, 59, 71, 59, 68, 55, 63, 55, 70, 59, 72, 59, 69, 54, 63, 48, 58,
+		59, 73, 58, 69, 53, 63, 47, 58, 44, 56, 58, 70, 53, 63, 46, 57, 43, 56, 45, 60,
+		52, 63, 45, 57, 42, 56, 44, 61, 50, 67, 45, 57, 41, 57, 44, 61, 50, 68, 57, 73,
+		41, 57, 43, 62, 50, 69, 57, 74, 60, 74, 43, 62, 51, 70, 57, 75, 60, 74, 57, 68,
+		51, 70, 58, 75, 60, 74, 57, 68, 49, 60, 58, 76, 60, 74, 56, 68, 49, 60, 42, 56,
+		60, 74, 56, 68, 48, 60, 42, 56, 41, 57, 55, 68, 48, 60, 42, 56, 41, 58, 46, 64,
+		47, 60, 41, 56, 41, 58, 46, 65, 54, 72, 41, 56, 41, 59, 46, 65, 54, 72, 60, 75,
+		42, 59, 47, 66, 54, 72, 60, 75, 59, 71, 48, 66, 55, 72, 60, 74, 59, 71, 54, 64,
+		55, 72, 59, 74, 59, 70, 53, 63, 46, 57, 59, 73, 58, 70, 53, 63, 46, 57, 43, 56,
+		58, 69, 53, 63, 47, 57, 43, 56, 45, 60, 53, 62, 47, 57, 44, 57, 46, 61, 52, 66,
+		47, 57, 45, 57, 47, 61, 52, 66, 58, 70, 46, 57, 48, 61, 53, 66, 58, 70, 60, 69,
+		49, 61, 53, 66, 58, 69, 59, 69, 57, 65, 54, 66, 58, 68, 59, 68, 57, 64, 53, 59,
+		58, 68, 59, 67, 57, 63, 53, 59, 49, 57, 59, 66, 57, 63, 53, 59, 50, 57, 49, 58,
+		57, 62, 53, 59, 50, 57, 50, 58, 53, 61, 53, 59, 51, 57, 51, 58, 53, 61, 56, 64,
+		52, 57, 52, 58, 54, 61, 57, 64, 59, 64, 52, 58, 54, 61, 57, 63, 59, 64, 58, 63,
+		55, 61, 57, 63, 59, 63, 58, 62, 57, 60, 57, 62, 58, 63, 58, 61, 57, 59, 55, 58,
+		58, 62, 58, 61, 57, 59, 55, 58, 54, 58, 58, 61, 57, 59, 55, 58, 55, 58, 55, 59,
+		57, 59, 56, 58, 55, 58, 55, 59, 57, 60, 56, 58, 55, 58, 56, 59, 57, 60, 58, 60,
+		56, 58, 56, 59, 57, 60, 58, 60, 58, 60, 56, 59, 57, 59, 58, 60, 58, 60, 58, 59,
+		57, 59, 58, 60, 58, 59, 58, 59, 57, 58, 58, 59, 58, 59, 58, 59, 57, 58, 57, 58,
+		58, 59, 58, 59, 57, 58, 57, 58, 57, 58, 58, 58, 57, 58, 57, 58, 57, 58, 57, 58,
+		58, 58, 57, 58, 57, 58, 58, 58, 58, 59,
+	  }, { 8, -22, -102 },
+	  { 0.890388613f, 0.109205857f, 0.000405529841f } },
+};
@@ -0,0 +1,63 @@
+// Int8DSCNN against golden vectors from tools/int8_golden.py, which runs the
+// flatbuffer model through an independent port of the TFLite reference
+// kernels. The int8 logits must match exactly; the probabilities (float
+// softmax here, double there) to within kProbTolerance.
+#include <unity.h>
+#include <stdio.h>
+#include "Int8DSCNN.h"
+#include "FeatureBus.h"
+#include "env.h"
+#include "golden_vectors.h"
+
+static Int8DSCNN g_net;
+
+static const float kProbTolerance = 1e-5f;
+static const int kCases = (int)(sizeof(kGolden) / sizeof(kGolden[0]));
+
+void setUp(void) {}
+void tearDown(void) {}
+
+static void checkLogits(const GoldenVector& g, const float* probs) {
+	char msg[64];
+	snprintf(msg, sizeof(msg), "vector %s", g.name);
+	TEST_ASSERT_EQUAL_INT8_ARRAY_MESSAGE(g.logits, g_net.lastLogitsQ(), KWS_NUM_CLASSES, msg);
+	for (int c = 0; c < KWS_NUM_CLASSES; ++c) {
+		TEST_ASSERT_FLOAT_WITHIN_MESSAGE(kProbTolerance, g.probs[c], probs[c], msg);
+	}
+}
+
+static void test_predict_full_q_matches_golden(void) {
+	TEST_ASSERT_TRUE(g_net.begin());
+	for (int i = 0; i < kCases; ++i) {
+		float probs[KWS_NUM_CLASSES];
+		g_net.predict_full_q(kGolden[i].input, probs);
+		checkLogits(kGolden[i], probs);
+	}
+}
+
+// The float entry point quantizes with the same input scale, so the
+// dequantized golden input must land on the same logits.
+static void test_predict_full_matches_golden(void) {
+	static float mfcc[Int8DSCNN::kWindow];
+	for (int i = 0; i < kCases; ++i) {
+		for (int k = 0; k < Int8DSCNN::kWindow; ++k) mfcc[k] = FeatureBus::dequantize(kGolden[i].input[k]);
+		float probs[KWS_NUM_CLASSES];
+		g_net.predict_full(mfcc, probs);
+		checkLogits(kGolden[i], probs);
+	}
+}
+
+static void test_predict_proba_is_wake_class(void) {
+	for (int i = 0; i < kCases; ++i) {
+		TEST_ASSERT_FLOAT_WITHIN(kProbTolerance, kGolden[i].probs[WAKE_CLASS_INDEX],
+		                         g_net.predict_proba_q(kGolden[i].input));
+	}
+}
+
+int main(int argc, char** argv) {
+	UNITY_BEGIN();
+	RUN_TEST(test_predict_full_q_matches_golden);
+	RUN_TEST(test_predict_full_matches_golden);
+	RUN_TEST(test_predict_proba_is_wake_class);
+	return UNITY_END();
+}
@@ -0,0 +1,255 @@
+// ModelRuntime on the generated blobs, and ModelStore's two slots. The int8
+// blob must give Int8DSCNN's results on the golden vectors, and the float
+// blob ManualDSCNN's. load() must reject a blob that is corrupt, truncated
+// or misaligned. ModelStore must reject an update whose CRC or size does
+// not check out, and keep running from its valid slot. The store tests work
+// in a scratch directory, since the host slots are files in the current one.
+#include <unity.h>
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include "ModelRuntime.h"
+#include "ModelStore.h"
+#include "Int8DSCNN.h"
+#include "ManualDSCNN.h"
+#include "FeatureBus.h"
+#include "env.h"
+#include "../test_int8_golden/golden_vectors.h"
+
+#ifndef MODEL_DIR
+#define MODEL_DIR "models"
+#endif
+
+static const float kProbTolerance = 1e-5f;
+static const int kCases = (int)(sizeof(kGolden) / sizeof(kGolden[0]));
+static const size_t kMaxBlob = 16 * 1024;
+
+static ModelRuntime g_rt;
+static Int8DSCNN g_int8;
+static ManualDSCNN g_float;
+
+struct Blob {
+	alignas(16) uint8_t data[kMaxBlob];
+	size_t size;
+};
+static Blob g_int8_blob, g_float_blob, g_scratch;
+static char g_dir[] = "/tmp/kws_store_XXXXXX";
+
+void setUp(void) {}
+void tearDown(void) {}
+
+static bool readBlob(const char* path, Blob& b) {
+	FILE* f = fopen(path, "rb");
+	if (!f) return false;
+	b.size = fread(b.data, 1, sizeof(b.data), f);
+	fclose(f);
+	return b.size > sizeof(BlobHeader) && b.size < sizeof(b.data);
+}
+
+static void copyBlob(const Blob& from, Blob& to) {
+	memcpy(to.data, from.data, from.size);
+	to.size = from.size;
+}
+
+static BlobHeader* header(Blob& b) {
+	return reinterpret_cast<BlobHeader*>(b.data);
+}
+
+// After patching a blob's body.
+static void resign(Blob& b) {
+	header(b)->crc32 = ModelRuntime::crc32(b.data + sizeof(BlobHeader), b.size - sizeof(BlobHeader));
+}
+
+static void test_int8_blob_matches_int8dscnn(void) {
+	TEST_ASSERT_TRUE(readBlob(MODEL_DIR "/ds_cnn_tiny_v2_int8.kwsm", g_int8_blob));
+	TEST_ASSERT_TRUE(readBlob(MODEL_DIR "/manual_dscnn_f32.kwsm", g_float_blob));
+	TEST_ASSERT_TRUE(g_rt.loadFile(MODEL_DIR "/ds_cnn_tiny_v2_int8.kwsm"));
+	TEST_ASSERT_TRUE(g_rt.begin());
+	TEST_ASSERT_EQUAL_INT(KWS_NUM_CLASSES, g_rt.numClasses());
+	TEST_ASSERT_TRUE(g_int8.begin());
+
+	static float mfcc[Int8DSCNN::kWindow];
+	for (int i = 0; i < kCases; ++i) {
+		const GoldenVector& g = kGolden[i];
+		float p[KWS_NUM_CLASSES], l[KWS_NUM_CLASSES], ref_p[KWS_NUM_CLASSES], ref_l[KWS_NUM_CLASSES];
+		g_rt.predict_full_q(g.input, p, l);
+		g_int8.predict_full_q(g.input, ref_p, ref_l);
+		TEST_ASSERT_EQUAL_MEMORY_MESSAGE(ref_l, l, sizeof(l), g.name);
+		for (int c = 0; c < KWS_NUM_CLASSES; ++c) {
+			TEST_ASSERT_FLOAT_WITHIN_MESSAGE(kProbTolerance, g.probs[c], p[c], g.name);
+			TEST_ASSERT_FLOAT_WITHIN_MESSAGE(1e-6f, ref_p[c], p[c], g.name);
+		}
+		TEST_ASSERT_FLOAT_WITHIN(1e-6f, p[WAKE_CLASS_INDEX], g_rt.predict_proba_q(g.input));
+
+		// The float entry point quantizes with the blob's own input scale.
+		for (int k = 0; k < Int8DSCNN::kWindow; ++k) mfcc[k] = FeatureBus::dequantize(g.input[k]);
+		g_rt.predict_full(mfcc, p, l);
+		TEST_ASSERT_EQUAL_MEMORY_MESSAGE(ref_l, l, sizeof(l), g.name);
+	}
+	g_rt.unload();
+	TEST_ASSERT_FALSE(g_rt.loaded());
+}
+
+// The shipped float dense layer is a zero stub, so this compares little more
+// than the bias; test_float_blob_features checks the layers before it.
+static void test_float_blob_matches_manual_dscnn(void) {
+	TEST_ASSERT_TRUE(g_rt.load(g_float_blob.data, g_float_blob.size));
+	TEST_ASSERT_TRUE(g_rt.arenaBytes() <= MODELRUNTIME_ARENA_BUDGET);
+	TEST_ASSERT_TRUE(g_float.begin());
+
+	static float mfcc[ManualDSCNN::kWindow];
+	for (int i = 0; i < kCases; ++i) {
+		for (int k = 0; k < ManualDSCNN::kWindow; ++k) mfcc[k] = FeatureBus::dequantize(kGolden[i].input[k]);
+		float p[KWS_NUM_CLASSES], l[KWS_NUM_CLASSES], ref_p[KWS_NUM_CLASSES], ref_l[KWS_NUM_CLASSES];
+		g_rt.predict_full(mfcc, p, l);
+		g_float.predict_full(mfcc, ref_p, ref_l);
+		for (int c = 0; c < KWS_NUM_CLASSES; ++c) {
+			TEST_ASSERT_FLOAT_WITHIN_MESSAGE(1e-5f, ref_l[c], l[c], kGolden[i].name);
+			TEST_ASSERT_FLOAT_WITHIN_MESSAGE(kProbTolerance, ref_p[c], p[c], kGolden[i].name);
+		}
+	}
+}
+
+// A copy of the float blob whose dense layer sums every third pooled
+// channel into each logit, so the logits follow ManualDSCNN::lastPooled().
+static void test_float_blob_features(void) {
+	copyBlob(g_float_blob, g_scratch);
+	const BlobHeader* h = header(g_scratch);
+	const BlobLayer* layers = reinterpret_cast<const BlobLayer*>(g_scratch.data + h->layers);
+	const BlobLayer* dense = nullptr;
+	for (int i = 0; i < h->layer_count; ++i) {
+		if (layers[i].op == kOpDense) dense = &layers[i];
+	}
+	TEST_ASSERT_NOT_NULL(dense);
+	TEST_ASSERT_EQUAL_INT(ManualDSCNN::kPooled, dense->in_c);
+	float* w = reinterpret_cast<float*>(g_scratch.data + dense->weights);
+	float* b = reinterpret_cast<float*>(g_scratch.data + dense->bias);
+	for (int k = 0; k < dense->out_c; ++k) {
+		b[k] = 0.0f;
+		for (int c = 0; c < dense->in_c; ++c) w[k * dense->in_c + c] = c % dense->out_c == k ? 1.0f : 0.0f;
+	}
+	resign(g_scratch);
+	TEST_ASSERT_TRUE(g_rt.load(g_scratch.data, g_scratch.size));
+
+	static float mfcc[ManualDSCNN::kWindow];
+	for (int i = 0; i < kCases; ++i) {
+		for (int k = 0; k < ManualDSCNN::kWindow; ++k) mfcc[k] = FeatureBus::dequantize(kGolden[i].input[k]);
+		float p[KWS_NUM_CLASSES], l[KWS_NUM_CLASSES];
+		g_rt.predict_full(mfcc, p, l);
+		g_float.predict_full(mfcc, p);
+		const float* pooled = g_float.lastPooled();
+		for (int k = 0; k < KWS_NUM_CLASSES; ++k) {
+			float want = 0.0f;
+			for (int c = k; c < ManualDSCNN::kPooled; c += KWS_NUM_CLASSES) want += pooled[c];
+			TEST_ASSERT_FLOAT_WITHIN_MESSAGE(1e-4f * (1.0f + fabsf(want)), want, l[k], kGolden[i].name);
+		}
+	}
+}
+
+static void test_load_rejects_bad_blobs(void) {
+	copyBlob(g_int8_blob, g_scratch);
+	g_scratch.data[g_scratch.size - 1] ^= 0x01;
+	TEST_ASSERT_FALSE(g_rt.load(g_scratch.data, g_scratch.size));
+	TEST_ASSERT_EQUAL_STRING("CRC mismatch", g_rt.error());
+	TEST_ASSERT_FALSE(g_rt.loaded());
+
+	copyBlob(g_int8_blob, g_scratch);
+	TEST_ASSERT_FALSE(g_rt.load(g_scratch.data, g_scratch.size - 1));
+	TEST_ASSERT_EQUAL_STRING("truncated blob", g_rt.error());
+	TEST_ASSERT_FALSE(g_rt.load(g_scratch.data, sizeof(BlobHeader) - 1));
+
+	header(g_scratch)->magic ^= 1;
+	TEST_ASSERT_FALSE(g_rt.load(g_scratch.data, g_scratch.size));
+	TEST_ASSERT_EQUAL_STRING("bad magic", g_rt.error());
+
+	// A body whose CRC is right but whose shapes do not chain.
+	copyBlob(g_int8_blob, g_scratch);
+	BlobLayer* layers = reinterpret_cast<BlobLayer*>(g_scratch.data + header(g_scratch)->layers);
+	layers[1].in_c += 1;
+	resign(g_scratch);
+	TEST_ASSERT_FALSE(g_rt.load(g_scratch.data, g_scratch.size));
+
+	memmove(g_scratch.data + 1, g_int8_blob.data, g_int8_blob.size);
+	TEST_ASSERT_FALSE(g_rt.load(g_scratch.data + 1, g_int8_blob.size));
+
+	TEST_ASSERT_TRUE(g_rt.load(g_int8_blob.data, g_int8_blob.size));
+	TEST_ASSERT_NULL(g_rt.error());
+}
+
+static bool writeUpdate(ModelStore& s, const Blob& b, size_t bytes) {
+	if (!s.beginUpdate()) return false;
+	for (size_t off = 0; off < bytes; off += 100) {
+		if (!s.writeUpdate(b.data + off, bytes - off < 100 ? bytes - off : 100)) return false;
+	}
+	return s.finishUpdate();
+}
+
+static void test_store_commits_and_falls_back(void) {
+	TEST_ASSERT_NOT_NULL(mkdtemp(g_dir));
+	TEST_ASSERT_EQUAL_INT(0, chdir(g_dir));
+
+	ModelStore store;
+	TEST_ASSERT_FALSE(store.begin());
+	TEST_ASSERT_EQUAL_INT(-1, store.activeSlot());
+
+	TEST_ASSERT_TRUE(writeUpdate(store, g_int8_blob, g_int8_blob.size));
+	TEST_ASSERT_TRUE(store.begin());
+	TEST_ASSERT_EQUAL_INT(0, store.activeSlot());
+	TEST_ASSERT_EQUAL_UINT32(1, store.sequence());
+	TEST_ASSERT_EQUAL_UINT32(g_int8_blob.size, (uint32_t)store.size());
+	TEST_ASSERT_EQUAL_MEMORY(g_int8_blob.data, store.data(), g_int8_blob.size);
+	TEST_ASSERT_TRUE(g_rt.load(store.data(), store.size()));
+
+	// The update goes to the other slot and wins on the next begin().
+	TEST_ASSERT_TRUE(writeUpdate(store, g_float_blob, g_float_blob.size));
+	TEST_ASSERT_EQUAL_INT(0, store.activeSlot());
+	TEST_ASSERT_TRUE(store.begin());
+	TEST_ASSERT_EQUAL_INT(1, store.activeSlot());
+	TEST_ASSERT_EQUAL_UINT32(2, store.sequence());
+	TEST_ASSERT_EQUAL_MEMORY(g_float_blob.data, store.data(), g_float_blob.size);
+
+	TEST_ASSERT_TRUE(store.fallback());
+	TEST_ASSERT_EQUAL_INT(0, store.activeSlot());
+	TEST_ASSERT_EQUAL_MEMORY(g_int8_blob.data, store.data(), g_int8_blob.size);
+}
+
+// Still in the scratch directory, slot 0 (int8) active after the fallback.
+static void test_store_rejects_bad_updates(void) {
+	ModelStore store;
+	TEST_ASSERT_TRUE(store.begin());
+	TEST_ASSERT_EQUAL_INT(1, store.activeSlot());
+	TEST_ASSERT_TRUE(store.fallback());
+
+	copyBlob(g_float_blob, g_scratch);
+	g_scratch.data[g_scratch.size / 2] ^= 0x40;
+	TEST_ASSERT_FALSE(writeUpdate(store, g_scratch, g_scratch.size));
+	TEST_ASSERT_EQUAL_STRING("CRC mismatch", store.error());
+
+	TEST_ASSERT_FALSE(writeUpdate(store, g_float_blob, g_float_blob.size - 16));
+	TEST_ASSERT_EQUAL_STRING("blob size does not match its header", store.error());
+
+	// Slot 1 was erased by the failed updates; slot 0 was never touched.
+	TEST_ASSERT_EQUAL_INT(0, store.activeSlot());
+	TEST_ASSERT_EQUAL_MEMORY(g_int8_blob.data, store.data(), g_int8_blob.size);
+	TEST_ASSERT_TRUE(store.begin());
+	TEST_ASSERT_EQUAL_INT(0, store.activeSlot());
+	TEST_ASSERT_FALSE(store.fallback());
+
+	unlink(MODELSTORE_LABEL_A ".bin");
+	unlink(MODELSTORE_LABEL_B ".bin");
+	TEST_ASSERT_EQUAL_INT(0, chdir("/"));
+	rmdir(g_dir);
+}
+
+int main(int argc, char** argv) {
+	UNITY_BEGIN();
+	RUN_TEST(test_int8_blob_matches_int8dscnn);
+	RUN_TEST(test_float_blob_matches_manual_dscnn);
+	RUN_TEST(test_float_blob_features);
+	RUN_TEST(test_load_rejects_bad_blobs);
+	RUN_TEST(test_store_commits_and_falls_back);
+	RUN_TEST(test_store_rejects_bad_updates);
+	return UNITY_END();
+}
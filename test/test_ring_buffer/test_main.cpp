@@ -0,0 +1,107 @@
+// RingBuffer under two threads: a producer and a consumer hand a counting
+// sequence through a small ring, mixing write()/reserve() and
+// read()/peek(), in chunk sizes that keep the indices wrapping. Every value
+// must arrive once and in order. Each side yields when it cannot make
+// progress, and now and then at random, so on a single core the ring is
+// handed over part full and the spans still wrap.
+#include <unity.h>
+#include <thread>
+#include "RingBuffer.h"
+
+static const uint32_t kTotal = 1u << 21;
+static const size_t kRing = 64;
+
+void setUp(void) {}
+void tearDown(void) {}
+
+static uint32_t nextChunk(uint32_t& seed, uint32_t max) {
+	seed = seed * 1664525u + 1013904223u;
+	return 1 + (seed >> 16) % max;
+}
+
+// Runs on its own thread, so it counts failures instead of asserting.
+static void produce(RingBuffer<uint32_t, kRing>& ring, uint32_t& short_writes) {
+	uint32_t next = 0, seed = 1;
+	uint32_t buf[kRing];
+	while (next < kTotal) {
+		uint32_t n = nextChunk(seed, kRing + kRing / 2);
+		if (n > kTotal - next) n = kTotal - next;
+		if (n & 1) {
+			// Copying write of what fits right now.
+			const size_t fit = ring.space();
+			if (n > fit) n = (uint32_t)fit;
+			for (uint32_t i = 0; i < n; ++i) buf[i] = next + i;
+			short_writes += ring.write(buf, n) != n;
+		} else {
+			// In place.
+			const RingBuffer<uint32_t, kRing>::WriteSpans w = ring.reserve();
+			if (n > w.size()) n = (uint32_t)w.size();
+			for (uint32_t i = 0; i < n; ++i) {
+				(i < w.first_n ? w.first[i] : w.second[i - w.first_n]) = next + i;
+			}
+			ring.commit(n);
+		}
+		next += n;
+		if (n == 0 || (seed >> 28) == 0) std::this_thread::yield();
+	}
+}
+
+static void test_two_threads_in_order(void) {
+	static RingBuffer<uint32_t, kRing> ring;
+	uint32_t short_writes = 0;
+	std::thread producer(produce, std::ref(ring), std::ref(short_writes));
+
+	uint32_t expect = 0, seed = 2, bad = 0;
+	uint32_t buf[kRing];
+	while (expect < kTotal) {
+		uint32_t n = nextChunk(seed, kRing);
+		if (n & 1) {
+			const size_t avail = ring.available();
+			if (n > avail) n = (uint32_t)avail;
+			TEST_ASSERT_EQUAL_UINT32(n, (uint32_t)ring.read(buf, n));
+			for (uint32_t i = 0; i < n; ++i) bad += buf[i] != expect + i;
+		} else {
+			const RingBuffer<uint32_t, kRing>::Spans s = ring.peek();
+			if (n > s.size()) n = (uint32_t)s.size();
+			for (uint32_t i = 0; i < n; ++i) {
+				bad += (i < s.first_n ? s.first[i] : s.second[i - s.first_n]) != expect + i;
+			}
+			ring.consume(n);
+		}
+		expect += n;
+		if (n == 0 || (seed >> 28) == 0) std::this_thread::yield();
+	}
+	producer.join();
+
+	TEST_ASSERT_EQUAL_UINT32(0, bad);
+	TEST_ASSERT_EQUAL_UINT32(0, short_writes);
+	TEST_ASSERT_TRUE(ring.empty());
+	TEST_ASSERT_EQUAL_UINT32(0, ring.overruns());
+	TEST_ASSERT_EQUAL_UINT32(0, ring.underruns());
+	TEST_ASSERT_LESS_OR_EQUAL_UINT32(kRing, ring.highWater());
+}
+
+// Without a consumer: a write that does not fit stores what it can and
+// counts the rest, a short read counts once, and the data still wraps intact.
+static void test_overrun_and_underrun_accounting(void) {
+	static RingBuffer<uint32_t, kRing> ring;
+	uint32_t src[kRing + 10], dst[kRing];
+	for (uint32_t i = 0; i < kRing + 10; ++i) src[i] = 1000 + i;
+
+	TEST_ASSERT_EQUAL_UINT32(kRing - 5, (uint32_t)ring.write(src, kRing - 5));
+	TEST_ASSERT_EQUAL_UINT32(kRing - 5, (uint32_t)ring.read(dst, kRing - 5));
+	TEST_ASSERT_EQUAL_UINT32(kRing, (uint32_t)ring.write(src, kRing + 10));	// wraps
+	TEST_ASSERT_EQUAL_UINT32(10, ring.overruns());
+	TEST_ASSERT_EQUAL_UINT32(kRing, ring.highWater());
+	TEST_ASSERT_EQUAL_UINT32(kRing, (uint32_t)ring.read(dst, kRing));
+	TEST_ASSERT_EQUAL_MEMORY(src, dst, sizeof(dst));
+	TEST_ASSERT_EQUAL_UINT32(0, (uint32_t)ring.read(dst, 1));
+	TEST_ASSERT_EQUAL_UINT32(1, ring.underruns());
+}
+
+int main(int argc, char** argv) {
+	UNITY_BEGIN();
+	RUN_TEST(test_two_threads_in_order);
+	RUN_TEST(test_overrun_and_underrun_accounting);
+	return UNITY_END();
+}
@@ -0,0 +1,88 @@
+// InferenceScheduler's duty cycle against the wake-class probability: input
+// the model is sure is not the wake word must leave it at the idle stride,
+// even when another class is far above `suspicious`; a suspicious wake
+// probability must raise it to every hop, and it must fall back once the
+// alert hold runs out.
+#include <unity.h>
+#include <string.h>
+#include "InferenceScheduler.h"
+#include "Int8DSCNN.h"
+#include "model_weights.h"
+
+static Int8DSCNN g_net;
+static int8_t g_silence[Int8DSCNN::kWindow];
+
+static const InferenceScheduler::Policy kPolicy;
+
+void setUp(void) {}
+void tearDown(void) {}
+
+// Runs `hops` active hops, answering every inference with p; returns the
+// inferences that ran.
+static uint32_t drive(InferenceScheduler& s, int hops, float p) {
+	const uint32_t before = s.counters().inferences;
+	for (int h = 0; h < hops; ++h) {
+		if (s.shouldRun(true)) s.onResult(p, p);
+	}
+	return s.counters().inferences - before;
+}
+
+static void test_non_wake_input_stays_idle(void) {
+	TEST_ASSERT_TRUE(g_net.begin());
+	memset(g_silence, (int8_t)input_zero_point, sizeof(g_silence));
+	float probs[KWS_NUM_CLASSES];
+	g_net.predict_full_q(g_silence, probs);
+	float top = 0.0f;
+	for (int c = 0; c < KWS_NUM_CLASSES; ++c) top = probs[c] > top ? probs[c] : top;
+	// The case the wake-class policy exists for: some class is confident.
+	TEST_ASSERT_TRUE(top >= kPolicy.suspicious);
+	TEST_ASSERT_TRUE(probs[WAKE_CLASS_INDEX] < kPolicy.suspicious);
+
+	InferenceScheduler s(kPolicy);
+	const int hops = 100 * kPolicy.idle_stride;
+	uint32_t runs = 0;
+	for (int h = 0; h < hops; ++h) {
+		if (!s.shouldRun(true)) continue;
+		const float p = g_net.predict_proba_q(g_silence);
+		s.onResult(p, p);
+		++runs;
+	}
+	TEST_ASSERT_EQUAL_UINT32(hops / kPolicy.idle_stride, runs);
+	TEST_ASSERT_FALSE(s.alert());
+	TEST_ASSERT_EQUAL_UINT32(0, s.counters().alert_hops);
+	TEST_ASSERT_FLOAT_WITHIN(1e-6f, 1.0f / (float)kPolicy.idle_stride, s.duty());
+}
+
+static void test_duty_rises_and_drops_with_wake_probability(void) {
+	InferenceScheduler s(kPolicy);
+	const int span = 4 * kPolicy.alert_hold;
+
+	// Quiet, then something wake-like: every hop runs.
+	TEST_ASSERT_EQUAL_UINT32(span / kPolicy.idle_stride, drive(s, span, 0.0f));
+	drive(s, kPolicy.idle_stride, kPolicy.suspicious);
+	TEST_ASSERT_TRUE(s.alert());
+	TEST_ASSERT_EQUAL_UINT32(span, drive(s, span, kPolicy.suspicious));
+
+	// Back to non-wake input: the hold runs out, then the idle stride returns.
+	const uint32_t hold = drive(s, kPolicy.alert_hold, 0.0f);
+	TEST_ASSERT_EQUAL_UINT32(kPolicy.alert_hold, hold);
+	TEST_ASSERT_FALSE(s.alert());
+	TEST_ASSERT_EQUAL_UINT32(span / kPolicy.idle_stride, drive(s, span, 0.0f));
+}
+
+static void test_closed_gate_never_runs(void) {
+	InferenceScheduler s(kPolicy);
+	drive(s, kPolicy.idle_stride, 1.0f);
+	TEST_ASSERT_TRUE(s.alert());
+	for (int h = 0; h < 50; ++h) TEST_ASSERT_FALSE(s.shouldRun(false));
+	TEST_ASSERT_FALSE(s.alert());
+	TEST_ASSERT_EQUAL_UINT32(50, s.counters().skipped_silence);
+}
+
+int main(int argc, char** argv) {
+	UNITY_BEGIN();
+	RUN_TEST(test_non_wake_input_stays_idle);
+	RUN_TEST(test_duty_rises_and_drops_with_wake_probability);
+	RUN_TEST(test_closed_gate_never_runs);
+	return UNITY_END();
+}
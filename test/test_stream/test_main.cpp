@@ -0,0 +1,114 @@
+// ManualDSCNN::predict_stream() against predict_full() on the same window,
+// for a window sliding over one long feature stream. Steps of one row run
+// past the periodic rebuild of the running sum; there are also steps of a
+// few rows, the largest incremental step (kMaxStreamStep), a gap above it,
+// a repeated seq and reset_stream(). The shipped float dense layer is a zero
+// stub, so the pooled features are compared as well as the probabilities.
+// The running sum adds and subtracts column sums in a different order from
+// a full pass, so the pooled values agree to kTolerance of their magnitude.
+#include <unity.h>
+#include <math.h>
+#include <stdio.h>
+#include "ManualDSCNN.h"
+
+static const int kRows = 600;
+static const float kTolerance = 1e-5f;
+
+static ManualDSCNN g_net;
+static float g_stream[kRows * KWS_NUM_MFCC];
+
+void setUp(void) {}
+void tearDown(void) {}
+
+// Slowly varying features with some noise, in the normalized MFCC range.
+static void fill(void) {
+	uint32_t seed = 99;
+	for (int r = 0; r < kRows; ++r) {
+		for (int c = 0; c < KWS_NUM_MFCC; ++c) {
+			seed = seed * 1664525u + 1013904223u;
+			const float noise = (float)(seed >> 8) / 16777216.0f - 0.5f;
+			g_stream[r * KWS_NUM_MFCC + c] = 2.0f * sinf(0.05f * r + 0.7f * c) + noise;
+		}
+	}
+}
+
+// The window of the first `seq` rows of the stream.
+static const float* window(uint32_t seq) {
+	return &g_stream[(seq - KWS_FRAMES) * KWS_NUM_MFCC];
+}
+
+// Streams the window ending at seq and checks it against a full pass;
+// returns the columns the stream recomputed.
+static uint32_t check(uint32_t seq) {
+	char msg[32];
+	snprintf(msg, sizeof(msg), "seq %u", (unsigned)seq);
+	float p[KWS_NUM_CLASSES], pooled[ManualDSCNN::kPooled];
+	float ref_p[KWS_NUM_CLASSES];
+	g_net.predict_stream(window(seq), seq, p);
+	const uint32_t columns = g_net.streamColumns();
+	for (int c = 0; c < ManualDSCNN::kPooled; ++c) pooled[c] = g_net.lastPooled()[c];
+
+	g_net.predict_full(window(seq), ref_p);
+	const float* ref = g_net.lastPooled();
+	float mag = 0.0f;
+	for (int c = 0; c < ManualDSCNN::kPooled; ++c) mag = fabsf(ref[c]) > mag ? fabsf(ref[c]) : mag;
+	TEST_ASSERT_TRUE_MESSAGE(mag > 0.0f, msg);
+	for (int c = 0; c < ManualDSCNN::kPooled; ++c) {
+		TEST_ASSERT_FLOAT_WITHIN_MESSAGE(kTolerance * mag, ref[c], pooled[c], msg);
+	}
+	for (int k = 0; k < KWS_NUM_CLASSES; ++k) {
+		TEST_ASSERT_FLOAT_WITHIN_MESSAGE(1e-6f, ref_p[k], p[k], msg);
+	}
+	return columns;
+}
+
+static void test_single_row_steps(void) {
+	TEST_ASSERT_TRUE(g_net.begin());
+	fill();
+	g_net.reset_stream();
+	uint32_t seq = KWS_FRAMES;
+	TEST_ASSERT_EQUAL_UINT32(KWS_FRAMES, check(seq));
+	// Three times round the window, so the running sum is rebuilt twice.
+	for (int i = 0; i < 3 * KWS_FRAMES; ++i) TEST_ASSERT_EQUAL_UINT32(3, check(++seq));
+}
+
+static void test_multi_row_steps(void) {
+	const int steps[] = { 2, 3, 5, 7, 11, 4, 9, 1, 6 };
+	g_net.reset_stream();
+	uint32_t seq = KWS_FRAMES + 10;
+	check(seq);
+	for (int round = 0; round < 4; ++round) {
+		for (int s : steps) {
+			seq += s;
+			TEST_ASSERT_EQUAL_UINT32(s + 2, check(seq));
+		}
+	}
+}
+
+static void test_gaps_and_resets(void) {
+	g_net.reset_stream();
+	uint32_t seq = KWS_FRAMES;
+	check(seq);
+	// The largest step still taken incrementally.
+	seq += ManualDSCNN::kMaxStreamStep;
+	TEST_ASSERT_EQUAL_UINT32(ManualDSCNN::kMaxStreamStep + 2, check(seq));
+	TEST_ASSERT_EQUAL_UINT32(3, check(++seq));
+	// One more row than that is a full pass.
+	seq += ManualDSCNN::kMaxStreamStep + 1;
+	TEST_ASSERT_EQUAL_UINT32(KWS_FRAMES, check(seq));
+	TEST_ASSERT_EQUAL_UINT32(3, check(++seq));
+	// As is the same window again, or a reset.
+	TEST_ASSERT_EQUAL_UINT32(KWS_FRAMES, check(seq));
+	g_net.reset_stream();
+	TEST_ASSERT_EQUAL_UINT32(KWS_FRAMES, check(++seq));
+	TEST_ASSERT_EQUAL_UINT32(3, check(++seq));
+	TEST_ASSERT_TRUE(seq <= (uint32_t)kRows);
+}
+
+int main(int argc, char** argv) {
+	UNITY_BEGIN();
+	RUN_TEST(test_single_row_steps);
+	RUN_TEST(test_multi_row_steps);
+	RUN_TEST(test_gaps_and_resets);
+	return UNITY_END();
+}
@@ -0,0 +1,196 @@
+// VadGate::update() on hand-made level and spectrum sequences: silence never
+// opens the gate; a tonal burst opens it onset_frames in, holds it for the
+// hangover and counts no missed onset; a burst that only turns speech-like
+// after a loud flat stretch opens late and counts a missed onset, as does
+// an on-time opening once pre_roll_frames is below the debounce; a sustained
+// tone keeps the gate open. The noise floor must not move while the gate is
+// open, and gated must count exactly the frames that returned false.
+#include <unity.h>
+#include <string.h>
+#include "VadGate.h"
+
+static const float kQuiet = 0.01f;		// pcm rms, about -39 dB
+static const float kLoud = 0.1f;		// about -20 dB, well over the margin
+static const int kToneBin = 40;			// inside the speech band
+
+static float g_flat[AP_FFT_BINS];
+static float g_tone[AP_FFT_BINS];
+
+void setUp(void) {}
+void tearDown(void) {}
+
+static VadGate::Config config(void) {
+	VadGate::Config c;
+	c.margin_db = 6.0f;
+	c.flatness_max = 0.5f;
+	c.flux_min = 0.5f;
+	c.onset_frames = 3;
+	c.hangover_frames = 5;
+	c.pre_roll_frames = 4;
+	return c;
+}
+
+// Power spectra for a pcm rms: white (flatness 1) or one tone (flatness ~0),
+// both with the same total power.
+static const float* flat(float rms) {
+	for (int k = 0; k < AP_FFT_BINS; ++k) g_flat[k] = rms * rms;
+	return g_flat;
+}
+
+static const float* tone(float rms) {
+	for (int k = 0; k < AP_FFT_BINS; ++k) g_tone[k] = 0.0f;
+	g_tone[kToneBin] = rms * rms * AP_FFT_BINS;
+	return g_tone;
+}
+
+// Runs n frames of one level and spectrum (nullptr for none); returns how
+// many left the gate open and counts the closed ones into *closed. While the
+// gate stays open the noise floor must not change.
+static int feed(VadGate& v, int n, float rms, bool tonal, bool spectrum, uint32_t* closed) {
+	int open = 0;
+	for (int i = 0; i < n; ++i) {
+		const float floor_db = v.stats().noise_floor_db;
+		const bool was_open = v.isOpen();
+		const float* power = spectrum ? (tonal ? tone(rms) : flat(rms)) : nullptr;
+		const bool is_open = v.update(rms, power);
+		TEST_ASSERT_EQUAL(is_open, v.isOpen());
+		if (is_open) {
+			++open;
+			if (was_open) TEST_ASSERT_EQUAL_FLOAT(floor_db, v.stats().noise_floor_db);
+		} else {
+			++*closed;
+		}
+	}
+	return open;
+}
+
+static void test_silence_stays_closed(void) {
+	for (int spectrum = 0; spectrum < 2; ++spectrum) {
+		VadGate v(config());
+		uint32_t closed = 0;
+		TEST_ASSERT_EQUAL_INT(0, feed(v, 200, kQuiet, false, spectrum, &closed));
+		TEST_ASSERT_EQUAL_UINT32(200, v.stats().frames);
+		TEST_ASSERT_EQUAL_UINT32(200, v.stats().gated);
+		TEST_ASSERT_EQUAL_UINT32(0, v.stats().opens);
+		TEST_ASSERT_EQUAL_UINT32(0, v.stats().missed_onsets);
+		TEST_ASSERT_FLOAT_WITHIN(0.01f, v.stats().last_energy_db, v.stats().noise_floor_db);
+		TEST_ASSERT_FLOAT_WITHIN(1e-3f, 0.0f, v.gatedShare() - 1.0f);
+	}
+}
+
+// Burst of kLoud frames after silence, with and without a spectrum.
+static void checkBurst(bool spectrum) {
+	const VadGate::Config c = config();
+	VadGate v(c);
+	uint32_t closed = 0;
+	feed(v, 50, kQuiet, false, spectrum, &closed);
+	const float floor_db = v.stats().noise_floor_db;
+
+	// Closed for the first onset_frames - 1 loud frames, then open.
+	TEST_ASSERT_EQUAL_INT(0, feed(v, c.onset_frames - 1, kLoud, true, spectrum, &closed));
+	TEST_ASSERT_EQUAL_INT(1, feed(v, 1, kLoud, true, spectrum, &closed));
+	TEST_ASSERT_EQUAL_UINT32(1, v.stats().opens);
+	TEST_ASSERT_EQUAL_UINT32(0, v.stats().missed_onsets);
+	// The debounce frames were still closed, so they nudged the floor up.
+	const float open_floor_db = v.stats().noise_floor_db;
+	TEST_ASSERT_TRUE(open_floor_db > floor_db);
+	TEST_ASSERT_TRUE(open_floor_db < floor_db + 1.0f);
+
+	TEST_ASSERT_EQUAL_INT(20, feed(v, 20, kLoud, true, spectrum, &closed));
+	// Hangover: the gate closes on the hangover_frames-th quiet frame.
+	TEST_ASSERT_EQUAL_INT(c.hangover_frames - 1, feed(v, c.hangover_frames - 1, kQuiet, false, spectrum, &closed));
+	TEST_ASSERT_EQUAL_FLOAT(open_floor_db, v.stats().noise_floor_db);
+	TEST_ASSERT_EQUAL_INT(0, feed(v, 1, kQuiet, false, spectrum, &closed));
+	TEST_ASSERT_EQUAL_INT(0, feed(v, 50, kQuiet, false, spectrum, &closed));
+
+	TEST_ASSERT_EQUAL_UINT32(1, v.stats().opens);
+	TEST_ASSERT_EQUAL_UINT32(closed, v.stats().gated);
+	TEST_ASSERT_EQUAL_UINT32(50 + c.onset_frames - 1 + 1 + 50, v.stats().gated);
+}
+
+static void test_speech_burst(void) {
+	checkBurst(true);
+}
+
+static void test_speech_burst_without_spectrum(void) {
+	checkBurst(false);
+}
+
+// Loud but flat: only the first loud frame is speech-like (by its flux), so
+// the run restarts and the opening comes from the tone that follows, long
+// after the first loud frame.
+static void test_late_onset_is_missed(void) {
+	const VadGate::Config c = config();
+	VadGate v(c);
+	uint32_t closed = 0;
+	feed(v, 50, kQuiet, false, true, &closed);
+	TEST_ASSERT_EQUAL_INT(0, feed(v, 1, kLoud, false, true, &closed));
+	TEST_ASSERT_TRUE(v.stats().last_flux > c.flux_min);
+	TEST_ASSERT_EQUAL_INT(0, feed(v, 9, kLoud, false, true, &closed));
+	TEST_ASSERT_FLOAT_WITHIN(1e-3f, 1.0f, v.stats().last_flatness);
+	TEST_ASSERT_EQUAL_INT(0, feed(v, c.onset_frames - 1, kLoud, true, true, &closed));
+	TEST_ASSERT_EQUAL_INT(1, feed(v, 1, kLoud, true, true, &closed));
+	TEST_ASSERT_TRUE(v.stats().last_flatness < c.flatness_max);
+	// Opened 10 + onset_frames - 1 frames after the onset, over pre_roll_frames.
+	TEST_ASSERT_EQUAL_UINT32(1, v.stats().opens);
+	TEST_ASSERT_EQUAL_UINT32(1, v.stats().missed_onsets);
+
+	// The next burst, after the gate has closed, is on time again.
+	feed(v, c.hangover_frames + 50, kQuiet, false, true, &closed);
+	TEST_ASSERT_FALSE(v.isOpen());
+	feed(v, c.onset_frames, kLoud, true, true, &closed);
+	TEST_ASSERT_TRUE(v.isOpen());
+	TEST_ASSERT_EQUAL_UINT32(2, v.stats().opens);
+	TEST_ASSERT_EQUAL_UINT32(1, v.stats().missed_onsets);
+	TEST_ASSERT_EQUAL_UINT32(closed, v.stats().gated);
+}
+
+// The opening lags the onset by onset_frames - 1: safe at that pre-roll,
+// missed one frame below it.
+static void test_pre_roll_bound(void) {
+	for (int slack = 0; slack < 2; ++slack) {
+		VadGate::Config c = config();
+		c.pre_roll_frames = c.onset_frames - 1 - slack;
+		VadGate v(c);
+		uint32_t closed = 0;
+		feed(v, 50, kQuiet, false, false, &closed);
+		TEST_ASSERT_EQUAL_INT(1, feed(v, c.onset_frames, kLoud, false, false, &closed));
+		TEST_ASSERT_EQUAL_UINT32(1, v.stats().opens);
+		TEST_ASSERT_EQUAL_UINT32(slack, v.stats().missed_onsets);
+	}
+}
+
+// A tone that never stops: one opening, never closed, and the floor stays
+// where the gate opened instead of creeping up to the tone.
+static void test_sustained_tone_holds_the_gate(void) {
+	const VadGate::Config c = config();
+	VadGate v(c);
+	uint32_t closed = 0;
+	feed(v, 50, kQuiet, false, true, &closed);
+	feed(v, c.onset_frames, kLoud, true, true, &closed);
+	TEST_ASSERT_TRUE(v.isOpen());
+	const float floor_db = v.stats().noise_floor_db;
+	TEST_ASSERT_EQUAL_INT(2000, feed(v, 2000, kLoud, true, true, &closed));
+	TEST_ASSERT_EQUAL_FLOAT(floor_db, v.stats().noise_floor_db);
+	TEST_ASSERT_EQUAL_UINT32(1, v.stats().opens);
+	TEST_ASSERT_EQUAL_UINT32(0, v.stats().missed_onsets);
+	TEST_ASSERT_EQUAL_UINT32(50 + c.onset_frames - 1, v.stats().gated);
+	TEST_ASSERT_EQUAL_UINT32(closed, v.stats().gated);
+
+	// reset() forgets the floor and the counters.
+	v.reset();
+	TEST_ASSERT_FALSE(v.isOpen());
+	TEST_ASSERT_EQUAL_UINT32(0, v.stats().frames);
+	TEST_ASSERT_EQUAL_UINT32(0, v.stats().opens);
+}
+
+int main(int argc, char** argv) {
+	UNITY_BEGIN();
+	RUN_TEST(test_silence_stays_closed);
+	RUN_TEST(test_speech_burst);
+	RUN_TEST(test_speech_burst_without_spectrum);
+	RUN_TEST(test_late_onset_is_missed);
+	RUN_TEST(test_pre_roll_bound);
+	RUN_TEST(test_sustained_tone_holds_the_gate);
+	return UNITY_END();
+}
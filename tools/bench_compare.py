@@ -0,0 +1,99 @@
+#!/usr/bin/env python3
+"""Check a kws_bench result against a stored baseline.
+
+The result is the JSON kws_bench writes (env:native_bench), or a serial log
+from env:bench containing it between BENCH_JSON_BEGIN/BENCH_JSON_END lines.
+A stage regresses when its median grows by more than --tolerance (default
+10%) or its p99 by more than --p99-tolerance (default 50%), both measured
+in cycles, so baselines only compare within one target and DSP variant.
+A stage missing from the result also fails.
+
+Baselines are per machine; record one with --update on a quiet system:
+    python3 tools/bench_compare.py result.json bench/host-avx2.json --update
+    python3 tools/bench_compare.py result.json bench/host-avx2.json
+
+Exits 1 on a regression, 2 on unusable input. Standard library only.
+"""
+import json
+import os
+import sys
+
+
+def load(path):
+    with open(path) as fh:
+        text = fh.read()
+    if "BENCH_JSON_BEGIN" in text:
+        text = text.split("BENCH_JSON_BEGIN", 1)[1].split("BENCH_JSON_END", 1)[0]
+    return json.loads(text)
+
+
+def option(args, name, default):
+    if name not in args:
+        return default
+    i = args.index(name)
+    value = float(args[i + 1])
+    del args[i:i + 2]
+    return value
+
+
+def main():
+    args = sys.argv[1:]
+    tol = option(args, "--tolerance", 0.10)
+    p99_tol = option(args, "--p99-tolerance", 0.50)
+    update = "--update" in args
+    args = [a for a in args if a != "--update"]
+    if len(args) != 2:
+        print(__doc__.strip(), file=sys.stderr)
+        return 2
+    result_path, baseline_path = args
+    try:
+        result = load(result_path)
+    except (OSError, ValueError) as e:
+        print("cannot read %s: %s" % (result_path, e), file=sys.stderr)
+        return 2
+
+    if update:
+        os.makedirs(os.path.dirname(os.path.abspath(baseline_path)), exist_ok=True)
+        with open(baseline_path, "w") as fh:
+            json.dump(result, fh, indent=1)
+            fh.write("\n")
+        print("baseline %s: %d stages" % (baseline_path, len(result["stages"])))
+        return 0
+
+    try:
+        base = load(baseline_path)
+    except (OSError, ValueError) as e:
+        print("cannot read %s: %s" % (baseline_path, e), file=sys.stderr)
+        return 2
+    for key in ("target", "dsp"):
+        if result.get(key) != base.get(key):
+            print("%s differs: result %s, baseline %s" % (key, result.get(key), base.get(key)),
+                  file=sys.stderr)
+            return 2
+
+    now = {s["name"]: s for s in result["stages"]}
+    failed = 0
+    print("%-28s %12s %12s %8s %8s" % ("stage", "median", "baseline", "change", "p99"))
+    for b in base["stages"]:
+        s = now.pop(b["name"], None)
+        if s is None:
+            print("%-28s missing from the result" % b["name"])
+            failed += 1
+            continue
+        change = s["median"] / b["median"] - 1.0 if b["median"] else 0.0
+        p99_change = s["p99"] / b["p99"] - 1.0 if b["p99"] else 0.0
+        bad = change > tol or p99_change > p99_tol
+        failed += bad
+        print("%-28s %12d %12d %+7.1f%% %+7.1f%%%s" % (
+            b["name"], s["median"], b["median"], 100 * change, 100 * p99_change,
+            "  REGRESSION" if bad else ""))
+    for name in now:
+        print("%-28s new stage, not in the baseline" % name)
+    if failed:
+        print("%d stage(s) regressed" % failed)
+        return 1
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
@@ -0,0 +1,239 @@
+#!/usr/bin/env python3
+"""Export the requantization parameters of the int8 DS-CNN.
+
+models/model_weights.h carries the int8 weights and int32 biases of
+ds_cnn_tiny_v2 but none of the per-layer scales. This reads them from the
+TFLite flatbuffer embedded in model_int8.cc.bak and writes
+models/model_int8_quant.h: per-channel multiplier/shift pairs (computed the
+way TFLite's QuantizeMultiplier does), zero points and activation ranges,
+in the layer order Int8DSCNN runs them.
+
+Standard library only:
+    python3 tools/export_int8_quant.py [model_int8.cc] [out.h]
+"""
+import math
+import os
+import re
+import struct
+import sys
+
+ROOT = os.path.dirname(os.path.dirname(os.path.abspath(__file__)))
+DEFAULT_SRC = os.path.join(ROOT, "lib", "ManualDSCNN", "model_int8.cc.bak")
+DEFAULT_OUT = os.path.join(ROOT, "models", "model_int8_quant.h")
+
+# Builtin opcodes used by the model.
+AVERAGE_POOL_2D, CONV_2D, DEPTHWISE_CONV_2D, FULLY_CONNECTED, SOFTMAX, MEAN = 1, 3, 4, 9, 25, 40
+
+# Expected op sequence and the C prefix of each layer.
+LAYERS = [
+    ("conv", CONV_2D),
+    ("b1_dw", DEPTHWISE_CONV_2D),
+    ("b1_pw", CONV_2D),
+    ("pool1", AVERAGE_POOL_2D),
+    ("b2_dw", DEPTHWISE_CONV_2D),
+    ("b2_pw", CONV_2D),
+    ("b3_dw", DEPTHWISE_CONV_2D),
+    ("b3_pw", CONV_2D),
+    ("pool2", AVERAGE_POOL_2D),
+    ("gap", MEAN),
+    ("dense", FULLY_CONNECTED),
+    ("softmax", SOFTMAX),
+]
+
+
+class FlatBuffer:
+    """Just enough of the flatbuffer wire format to walk a TFLite model."""
+
+    def __init__(self, data):
+        self.b = data
+
+    def u8(self, o):
+        return self.b[o]
+
+    def u16(self, o):
+        return struct.unpack_from("<H", self.b, o)[0]
+
+    def i32(self, o):
+        return struct.unpack_from("<i", self.b, o)[0]
+
+    def u32(self, o):
+        return struct.unpack_from("<I", self.b, o)[0]
+
+    def ref(self, o):
+        return o + self.u32(o)
+
+    def field(self, table, i):
+        vt = table - self.i32(table)
+        if 4 + 2 * i >= self.u16(vt):
+            return None
+        off = self.u16(vt + 4 + 2 * i)
+        return table + off if off else None
+
+    def vector(self, o):
+        o = self.ref(o)
+        return o + 4, self.u32(o)
+
+    def tables(self, o):
+        p, n = self.vector(o)
+        return [self.ref(p + 4 * k) for k in range(n)]
+
+    def ints(self, o):
+        p, n = self.vector(o)
+        return [self.i32(p + 4 * k) for k in range(n)]
+
+    def string(self, o):
+        p, n = self.vector(o)
+        return self.b[p:p + n].decode()
+
+
+def load_model_bytes(path):
+    src = open(path).read()
+    start = src.index("{", src.index("[]")) + 1
+    body = src[start:src.index("};", start)]
+    return bytes(int(x, 16) for x in re.findall(r"0x([0-9a-fA-F]{2})", body))
+
+
+def quantize_multiplier(real):
+    """TFLite QuantizeMultiplier: real = q * 2^(shift - 31), q in [2^30, 2^31)."""
+    if real == 0.0:
+        return 0, 0
+    m, shift = math.frexp(real)
+    q = int(round(m * (1 << 31)))
+    if q == (1 << 31):
+        q //= 2
+        shift += 1
+    if shift < -31:
+        return 0, 0
+    return q, shift
+
+
+def read_model(path):
+    fb = FlatBuffer(load_model_bytes(path))
+    root = fb.ref(0)
+    opcodes = []
+    for t in fb.tables(fb.field(root, 1)):
+        dep = fb.u8(fb.field(t, 0)) if fb.field(t, 0) else 0
+        new = fb.i32(fb.field(t, 3)) if fb.field(t, 3) else 0
+        opcodes.append(max(dep, new))
+    sg = fb.tables(fb.field(root, 2))[0]
+    buffers = []
+    for t in fb.tables(fb.field(root, 4)):
+        if fb.field(t, 0):
+            p, n = fb.vector(fb.field(t, 0))
+            buffers.append(fb.b[p:p + n])
+        else:
+            buffers.append(b"")
+
+    tensors = []
+    for t in fb.tables(fb.field(sg, 0)):
+        scales, zps = [], []
+        q = fb.field(t, 4)
+        if q:
+            q = fb.ref(q)
+            if fb.field(q, 2):
+                p, n = fb.vector(fb.field(q, 2))
+                scales = [struct.unpack_from("<f", fb.b, p + 4 * k)[0] for k in range(n)]
+            if fb.field(q, 3):
+                p, n = fb.vector(fb.field(q, 3))
+                zps = [struct.unpack_from("<q", fb.b, p + 8 * k)[0] for k in range(n)]
+        tensors.append({
+            "name": fb.string(fb.field(t, 3)),
+            "shape": fb.ints(fb.field(t, 0)) if fb.field(t, 0) else [],
+            "scale": scales,
+            "zp": zps,
+            "type": fb.u8(fb.field(t, 1)) if fb.field(t, 1) else 0,
+            "data": buffers[fb.u32(fb.field(t, 2))] if fb.field(t, 2) else b"",
+        })
+
+    ops = []
+    for o in fb.tables(fb.field(sg, 3)):
+        idx = fb.u32(fb.field(o, 0)) if fb.field(o, 0) else 0
+        ops.append({
+            "code": opcodes[idx],
+            "inputs": fb.ints(fb.field(o, 1)),
+            "outputs": fb.ints(fb.field(o, 2)),
+        })
+    return tensors, ops
+
+
+def act_range(t, relu6):
+    lo, hi = -128, 127
+    if relu6:
+        s, zp = t["scale"][0], t["zp"][0]
+        lo = max(lo, zp + int(round(0.0 / s)))
+        hi = min(hi, zp + int(round(6.0 / s)))
+    return lo, hi
+
+
+def emit(tensors, ops, src_name):
+    if [op["code"] for op in ops] != [code for _, code in LAYERS]:
+        sys.exit("unexpected op sequence: %s" % [op["code"] for op in ops])
+
+    out = [
+        "#pragma once",
+        "#include <cstdint>",
+        "",
+        "// Generated by tools/export_int8_quant.py from %s. Do not edit." % src_name,
+        "// Requantization of the int8 DS-CNN in models/model_weights.h, in execution",
+        "// order. x_mult/x_shift: q = MultiplyByQuantizedMultiplier(acc, mult, shift),",
+        "// per output channel (one entry for per-tensor layers); x_out_zp and",
+        "// x_act_min/max give the output zero point and clamp range.",
+        "",
+    ]
+
+    def scalar(name, ctype, value):
+        out.append("constexpr %s %s = %s;" % (ctype, name, value))
+
+    def array(name, ctype, values):
+        out.append("constexpr %s %s[%d] = {" % (ctype, name, len(values)))
+        for k in range(0, len(values), 8):
+            out.append("  " + ", ".join(str(v) for v in values[k:k + 8]) + ",")
+        out.append("};")
+
+    for (prefix, code), op in zip(LAYERS, ops):
+        tin = tensors[op["inputs"][0]]
+        tout = tensors[op["outputs"][0]]
+        out.append("// %s" % prefix)
+        if code in (CONV_2D, DEPTHWISE_CONV_2D, FULLY_CONNECTED):
+            w = tensors[op["inputs"][1]]
+            mults, shifts = [], []
+            for ws in w["scale"]:
+                q, s = quantize_multiplier(tin["scale"][0] * ws / tout["scale"][0])
+                mults.append(q)
+                shifts.append(s)
+            array("q8_%s_mult" % prefix, "int32_t", mults)
+            array("q8_%s_shift" % prefix, "int8_t", shifts)
+            lo, hi = act_range(tout, code != FULLY_CONNECTED)
+        elif code == MEAN:
+            q, s = quantize_multiplier(tin["scale"][0] / tout["scale"][0])
+            scalar("q8_%s_mult" % prefix, "int32_t", q)
+            scalar("q8_%s_shift" % prefix, "int", s)
+            lo, hi = act_range(tout, False)
+        elif code == AVERAGE_POOL_2D:
+            if tin["scale"] != tout["scale"] or tin["zp"] != tout["zp"]:
+                sys.exit("%s: pooling must keep the input quantization" % prefix)
+            lo, hi = act_range(tout, False)
+        else:  # SOFTMAX: the float API dequantizes the logits instead
+            scalar("q8_%s_in_scale" % prefix, "float", "%.9gf" % tin["scale"][0])
+            scalar("q8_%s_in_zp" % prefix, "int32_t", tin["zp"][0])
+            out.append("")
+            continue
+        scalar("q8_%s_in_zp" % prefix, "int32_t", tin["zp"][0])
+        scalar("q8_%s_out_zp" % prefix, "int32_t", tout["zp"][0])
+        scalar("q8_%s_act_min" % prefix, "int32_t", lo)
+        scalar("q8_%s_act_max" % prefix, "int32_t", hi)
+        out.append("")
+    return "\n".join(out)
+
+
+def main():
+    src = sys.argv[1] if len(sys.argv) > 1 else DEFAULT_SRC
+    dst = sys.argv[2] if len(sys.argv) > 2 else DEFAULT_OUT
+    tensors, ops = read_model(src)
+    with open(dst, "w") as f:
+        f.write(emit(tensors, ops, os.path.relpath(src, ROOT)))
+    print("wrote %s" % dst)
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,315 @@
+#!/usr/bin/env python3
+"""Write golden vectors for the int8 DS-CNN.
+
+Runs the int8 model in model_int8.cc.bak through a plain-Python port of the
+TFLite reference kernels (conv, depthwise conv, average pool, mean, fully
+connected), taking weights, biases, scales, strides, padding and fused
+activations from the flatbuffer itself. It shares nothing with
+lib/ManualDSCNN or models/*.h except QuantizeMultiplier, so
+test/test_int8_golden checks the weights, the exported requantization and
+the C++ kernels together.
+
+The inputs are fixed: silence (every value at the input zero point), the
+int8 extremes, uniform noise of +-2 and +-4 LSB from a 32-bit LCG, a smooth
+pattern in the range the frontend produces, and a burst the model scores
+as the wake word. The header holds each input, its int8 logits and the
+softmax of the dequantized logits.
+
+Standard library only (about a second per vector):
+    python3 tools/int8_golden.py [model_int8.cc] [out.h]
+"""
+import math
+import os
+import sys
+
+sys.path.insert(0, os.path.dirname(os.path.abspath(__file__)))
+import export_int8_quant as q8x  # noqa: E402
+
+ROOT = q8x.ROOT
+DEFAULT_OUT = os.path.join(ROOT, "test", "test_int8_golden", "golden_vectors.h")
+
+SAME, VALID = 0, 1
+RELU, RELU6 = 1, 3
+
+
+def srdhm(a, b):
+    """gemmlowp SaturatingRoundingDoublingHighMul, C division semantics."""
+    if a == b == -(1 << 31):
+        return (1 << 31) - 1
+    ab = a * b
+    nudge = (1 << 30) if ab >= 0 else 1 - (1 << 30)
+    n = ab + nudge
+    return abs(n) >> 31 if n >= 0 else -(abs(n) >> 31)
+
+
+def rounding_divide_by_pot(x, e):
+    mask = (1 << e) - 1
+    threshold = (mask >> 1) + (1 if x < 0 else 0)
+    return (x >> e) + (1 if (x & mask) > threshold else 0)
+
+
+def mbqm(x, mult, shift):
+    """MultiplyByQuantizedMultiplier, 32-bit accumulator."""
+    left = max(shift, 0)
+    return rounding_divide_by_pot(srdhm(x * (1 << left), mult), max(-shift, 0))
+
+
+def mbqm64(x, mult, shift):
+    """MultiplyByQuantizedMultiplier, 64-bit accumulator: the reduction path
+    (QuantizedMeanOrSum) TFLite takes for a MEAN that drops its dims."""
+    reduced = (mult + (1 << 15)) >> 16 if mult < 0x7FFF0000 else 0x7FFF
+    total = 15 - shift
+    return (x * reduced + (1 << (total - 1))) >> total
+
+
+def cdiv(a, b):
+    """C integer division (truncates toward zero)."""
+    return abs(a) // b * (1 if a >= 0 else -1)
+
+
+def clamp(v, lo, hi):
+    return lo if v < lo else hi if v > hi else v
+
+
+def options(fb, op_table):
+    """Builtin options table of an operator as {field: raw offset}."""
+    f = fb.field(op_table, 4)
+    if not f:
+        return None, {}
+    t = fb.ref(f)
+    return t, {i: fb.field(t, i) for i in range(8) if fb.field(t, i)}
+
+
+def read_graph(path):
+    tensors, ops = q8x.read_model(path)
+    fb = q8x.FlatBuffer(q8x.load_model_bytes(path))
+    sg = fb.tables(fb.field(fb.ref(0), 2))[0]
+    for op, t in zip(ops, fb.tables(fb.field(sg, 3))):
+        _, f = options(fb, t)
+        u8 = lambda i, d: fb.u8(f[i]) if i in f else d
+        i32 = lambda i, d: fb.i32(f[i]) if i in f else d
+        if op["code"] == q8x.CONV_2D:
+            op.update(padding=u8(0, SAME), stride=(i32(2, 1), i32(1, 1)), act=u8(3, 0))
+        elif op["code"] == q8x.DEPTHWISE_CONV_2D:
+            op.update(padding=u8(0, SAME), stride=(i32(2, 1), i32(1, 1)), mult=i32(3, 1), act=u8(4, 0))
+        elif op["code"] == q8x.AVERAGE_POOL_2D:
+            op.update(padding=u8(0, SAME), stride=(i32(2, 1), i32(1, 1)),
+                      filter=(i32(4, 1), i32(3, 1)), act=u8(5, 0))
+        elif op["code"] == q8x.FULLY_CONNECTED:
+            op.update(act=u8(0, 0))
+    return tensors, ops
+
+
+def values(t):
+    signed = t["type"] == 9
+    size = 1 if signed else 4
+    raw = t["data"]
+    if signed:
+        return [b - 256 if b > 127 else b for b in raw]
+    return [int.from_bytes(raw[k:k + 4], "little", signed=True) for k in range(0, len(raw), size)]
+
+
+def act_bounds(t, act):
+    s, zp = t["scale"][0], t["zp"][0]
+    lo, hi = -128, 127
+    if act in (RELU, RELU6):
+        lo = max(lo, zp + int(round(0.0 / s)))
+    if act == RELU6:
+        hi = min(hi, zp + int(round(6.0 / s)))
+    return lo, hi
+
+
+def pad_before(size, out, stride, k, padding):
+    if padding == VALID:
+        return 0
+    return max((out - 1) * stride + k - size, 0) // 2
+
+
+def conv(x, shape, op, tensors, depthwise):
+    h, w, c = shape
+    tin, tw, tb, tout = (tensors[i] for i in op["inputs"][:3] + op["outputs"][:1])
+    wv, bv = values(tw), values(tb)
+    _, oh, ow, oc = tout["shape"]
+    kh, kw = tw["shape"][1:3]
+    sh, sw = op["stride"]
+    ph = pad_before(h, oh, sh, kh, op["padding"])
+    pw = pad_before(w, ow, sw, kw, op["padding"])
+    in_zp, out_zp = tin["zp"][0], tout["zp"][0]
+    lo, hi = act_bounds(tout, op["act"])
+    mults = [q8x.quantize_multiplier(tin["scale"][0] * s / tout["scale"][0]) for s in tw["scale"]]
+    out = [0] * (oh * ow * oc)
+    for y in range(oh):
+        for xo in range(ow):
+            for o in range(oc):
+                acc = bv[o]
+                for ky in range(kh):
+                    iy = y * sh - ph + ky
+                    if iy < 0 or iy >= h:
+                        continue
+                    for kx in range(kw):
+                        ix = xo * sw - pw + kx
+                        if ix < 0 or ix >= w:
+                            continue
+                        base = (iy * w + ix) * c
+                        if depthwise:
+                            acc += (x[base + o // op["mult"]] - in_zp) * wv[(ky * kw + kx) * oc + o]
+                        else:
+                            wo = ((o * kh + ky) * kw + kx) * c
+                            for i in range(c):
+                                acc += (x[base + i] - in_zp) * wv[wo + i]
+                m, s = mults[o if len(mults) > 1 else 0]
+                out[(y * ow + xo) * oc + o] = clamp(mbqm(acc, m, s) + out_zp, lo, hi)
+    return out, (oh, ow, oc)
+
+
+def avg_pool(x, shape, op, tensors):
+    h, w, c = shape
+    tout = tensors[op["outputs"][0]]
+    _, oh, ow, _ = tout["shape"]
+    fh, fw = op["filter"]
+    sh, sw = op["stride"]
+    ph = pad_before(h, oh, sh, fh, op["padding"])
+    pw = pad_before(w, ow, sw, fw, op["padding"])
+    lo, hi = act_bounds(tout, op["act"])
+    out = [0] * (oh * ow * c)
+    for y in range(oh):
+        for xo in range(ow):
+            y0, x0 = y * sh - ph, xo * sw - pw
+            ys = range(max(y0, 0), min(y0 + fh, h))
+            xs = range(max(x0, 0), min(x0 + fw, w))
+            n = len(ys) * len(xs)
+            for ch in range(c):
+                acc = sum(x[(iy * w + ix) * c + ch] for iy in ys for ix in xs)
+                acc = cdiv(acc + n // 2, n) if acc > 0 else cdiv(acc - n // 2, n)
+                out[(y * ow + xo) * c + ch] = clamp(acc, lo, hi)
+    return out, (oh, ow, c)
+
+
+def mean(x, shape, op, tensors):
+    h, w, c = shape
+    tin, tout = tensors[op["inputs"][0]], tensors[op["outputs"][0]]
+    m, s = q8x.quantize_multiplier(tin["scale"][0] / tout["scale"][0])
+    n = h * w
+    out = []
+    for ch in range(c):
+        acc = sum(x[p * c + ch] - tin["zp"][0] for p in range(n))
+        acc = mbqm64(acc, m, s)
+        acc = cdiv(acc + n // 2, n) if acc > 0 else cdiv(acc - n // 2, n)
+        out.append(clamp(acc + tout["zp"][0], -128, 127))
+    return out, (1, 1, c)
+
+
+def fully_connected(x, op, tensors):
+    tin, tw, tb, tout = (tensors[i] for i in op["inputs"][:3] + op["outputs"][:1])
+    wv, bv = values(tw), values(tb)
+    oc, ic = tw["shape"]
+    lo, hi = act_bounds(tout, op["act"])
+    out = []
+    for o in range(oc):
+        acc = bv[o] + sum((x[i] - tin["zp"][0]) * wv[o * ic + i] for i in range(ic))
+        m, s = q8x.quantize_multiplier(tin["scale"][0] * tw["scale"][min(o, len(tw["scale"]) - 1)] / tout["scale"][0])
+        out.append(clamp(mbqm(acc, m, s) + tout["zp"][0], lo, hi))
+    return out
+
+
+def run(x, tensors, ops):
+    shape = tuple(tensors[ops[0]["inputs"][0]]["shape"][1:])
+    for op in ops:
+        code = op["code"]
+        if code == q8x.CONV_2D:
+            x, shape = conv(x, shape, op, tensors, False)
+        elif code == q8x.DEPTHWISE_CONV_2D:
+            x, shape = conv(x, shape, op, tensors, True)
+        elif code == q8x.AVERAGE_POOL_2D:
+            x, shape = avg_pool(x, shape, op, tensors)
+        elif code == q8x.MEAN:
+            x, shape = mean(x, shape, op, tensors)
+        elif code == q8x.FULLY_CONNECTED:
+            x = fully_connected(x, op, tensors)
+        else:  # SOFTMAX: Int8DSCNN takes float softmax of the dequantized logits
+            t = tensors[op["inputs"][0]]
+            real = [(v - t["zp"][0]) * t["scale"][0] for v in x]
+            top = max(real)
+            e = [math.exp(v - top) for v in real]
+            return x, [v / sum(e) for v in e]
+    sys.exit("model has no softmax")
+
+
+def inputs(n, zp):
+    state = [12345]
+
+    def lcg():
+        state[0] = (state[0] * 1664525 + 1013904223) & 0xFFFFFFFF
+        return state[0] >> 16
+
+    noise = lambda span: [clamp(zp + lcg() % (2 * span + 1) - span, -128, 127) for _ in range(n)]
+    rows = n // 10
+    smooth = [clamp(zp + int(round(3 * math.sin(0.21 * r + 0.7 * k))), -128, 127)
+              for r in range(rows) for k in range(10)]
+    # A windowed burst the model scores as the wake word (p ~ 0.9).
+    burst = [clamp(zp + int(round(math.exp(-((r - 32) / 18.0) ** 2) *
+                                  (10 * math.sin(0.84 * r + 0.4 * k) - 8 * math.cos(3.1 * k)))), -128, 127)
+             for r in range(rows) for k in range(10)]
+    return [
+        ("silence", [zp] * n),
+        ("extremes", [127 if (i // 10 + i) % 3 else -128 for i in range(n)]),
+        ("noise_2", noise(2)),
+        ("noise_4", noise(4)),
+        ("smooth", smooth),
+        ("burst", burst),
+    ]
+
+
+def emit(cases, src_name):
+    out = [
+        "#pragma once",
+        "#include <stdint.h>",
+        "",
+        "// Generated by tools/int8_golden.py from %s. Do not edit." % src_name,
+        "// Inputs run through a Python port of the TFLite reference kernels;",
+        "// logits are the int8 dense output, probs the softmax of the dequantized",
+        "// logits in double precision.",
+        "",
+        "struct GoldenVector {",
+        "\tconst char*\tname;",
+        "\tint8_t\t\tinput[%d];" % len(cases[0][1]),
+        "\tint8_t\t\tlogits[%d];" % len(cases[0][2]),
+        "\tfloat\t\tprobs[%d];" % len(cases[0][3]),
+        "};",
+        "",
+        "static const GoldenVector kGolden[] = {",
+    ]
+    for name, x, logits, probs in cases:
+        out.append("\t{ \"%s\", {" % name)
+        for k in range(0, len(x), 20):
+            out.append("\t\t" + ", ".join(str(v) for v in x[k:k + 20]) + ",")
+        out.append("\t  }, { %s }," % ", ".join(str(v) for v in logits))
+        out.append("\t  { %s } }," % ", ".join("%.9gf" % p for p in probs))
+    out.append("};")
+    out.append("")
+    return "\n".join(out)
+
+
+def main():
+    src = sys.argv[1] if len(sys.argv) > 1 else q8x.DEFAULT_SRC
+    dst = sys.argv[2] if len(sys.argv) > 2 else DEFAULT_OUT
+    tensors, ops = read_graph(src)
+    if [op["code"] for op in ops] != [code for _, code in q8x.LAYERS]:
+        sys.exit("unexpected op sequence: %s" % [op["code"] for op in ops])
+    tin = tensors[ops[0]["inputs"][0]]
+    n = 1
+    for d in tin["shape"]:
+        n *= d
+    cases = []
+    for name, x in inputs(n, tin["zp"][0]):
+        logits, probs = run(x, tensors, ops)
+        cases.append((name, x, logits, probs))
+        print("%-12s logits %s probs %s" % (name, logits, ["%.4f" % p for p in probs]))
+    os.makedirs(os.path.dirname(dst), exist_ok=True)
+    with open(dst, "w") as f:
+        f.write(emit(cases, os.path.relpath(src, ROOT)))
+    print("wrote %s" % dst)
+
+
+if __name__ == "__main__":
+    main()
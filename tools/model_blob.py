@@ -0,0 +1,199 @@
+#!/usr/bin/env python3
+"""Write KWSM model blobs for lib/ModelRuntime.
+
+  models/ds_cnn_tiny_v2_int8.kwsm  full int8 DS-CNN, straight from the TFLite
+                                   flatbuffer in model_int8.cc.bak
+  models/manual_dscnn_f32.kwsm     the float ManualDSCNN graph, BatchNorm folded
+                                   by tools/model_compiler.py
+
+The layout is documented in lib/ModelRuntime/ModelBlob.h: a 64-byte header,
+a table of 32-byte layer records, then every weight, bias and quantization
+array on a 16-byte boundary. Int8 pointwise biases get the input zero point
+folded in here, so the runtime never writes to the blob.
+
+With --slot each blob is also written as <name>.slot.bin: the ModelStore
+slot record followed by the blob, ready to flash into an empty model
+partition (e.g. esptool.py write_flash 0x610000 ds_cnn_tiny_v2_int8.slot.bin).
+Boards that already run the firmware take the plain .kwsm over HTTP instead.
+
+Standard library only:
+    python3 tools/model_blob.py [out_dir] [--slot]
+"""
+import os
+import struct
+import sys
+import zlib
+
+sys.path.insert(0, os.path.dirname(os.path.abspath(__file__)))
+import export_int8_quant as q8x  # noqa: E402
+import model_compiler as mc  # noqa: E402
+
+ROOT = q8x.ROOT
+MAGIC, VERSION, ALIGN = 0x4D53574B, 1, 16
+SLOT_MAGIC = 0x5353574B
+F32, I8 = 0, 1
+ACT_NONE, ACT_RELU = 0, 1
+CONV, DW, PW, BN, RELU, AVGPOOL, GAP, DENSE, SOFTMAX = range(1, 10)
+
+HEADER = struct.Struct("<IHHII3HBBfiI28s")
+LAYER = struct.Struct("<8B6H3I")
+QUANT = struct.Struct("<4ifIIHH")
+assert (HEADER.size, LAYER.size, QUANT.size) == (64, 32, 32)
+
+
+class Blob:
+    def __init__(self, name, in_shape, in_type, in_scale, in_zp):
+        self.name, self.in_shape, self.in_type = name, in_shape, in_type
+        self.in_scale, self.in_zp = in_scale, in_zp
+        self.layers = []
+        self.data = bytearray()
+
+    def _put(self, raw):
+        """Appends raw bytes at the next aligned slot; returns the offset relative to the data area."""
+        self.data += b"\0" * (-len(self.data) % ALIGN)
+        at = len(self.data)
+        self.data += raw
+        return at
+
+    def f32(self, values):
+        return self._put(struct.pack("<%df" % len(values), *values))
+
+    def i8(self, values):
+        return self._put(struct.pack("<%db" % len(values), *values))
+
+    def i32(self, values):
+        return self._put(struct.pack("<%di" % len(values), *values))
+
+    def quant(self, in_zp=0, out_zp=0, lo=-128, hi=127, in_scale=0.0, mult=(), shift=()):
+        m = self.i32(mult) if mult else None
+        s = self.i8(shift) if shift else None
+        return ("quant", in_zp, out_zp, lo, hi, in_scale, m, s, len(mult))
+
+    def layer(self, op, typ, in_shape, out_shape, act=ACT_NONE, kernel=(0, 0), stride=(0, 0),
+              weights=None, bias=None, quant=None):
+        self.layers.append((op, typ, act, kernel, stride, in_shape, out_shape, weights, bias, quant))
+
+    def build(self):
+        table_at = HEADER.size
+        data_at = table_at + LAYER.size * len(self.layers)
+        data_at += -data_at % ALIGN
+        # Quant records go after the arrays; everything is then rebased.
+        data = bytearray(self.data)
+        quant_at = {}
+        for i, l in enumerate(self.layers):
+            q = l[9]
+            if q:
+                data += b"\0" * (-len(data) % ALIGN)
+                quant_at[i] = len(data)
+                _, in_zp, out_zp, lo, hi, sc, m, s, n = q
+                data += QUANT.pack(in_zp, out_zp, lo, hi, sc,
+                                   data_at + m if m is not None else 0,
+                                   data_at + s if s is not None else 0, n, 0)
+        table = bytearray()
+        for i, (op, typ, act, k, st, ish, osh, w, b, q) in enumerate(self.layers):
+            table += LAYER.pack(op, typ, act, k[0], k[1], st[0], st[1], 0, *ish, *osh,
+                                data_at + w if w is not None else 0,
+                                data_at + b if b is not None else 0,
+                                data_at + quant_at[i] if i in quant_at else 0)
+        body = table + b"\0" * (data_at - table_at - len(table)) + data
+        total = HEADER.size + len(body)
+        hdr = HEADER.pack(MAGIC, VERSION, len(self.layers), total, zlib.crc32(body) & 0xFFFFFFFF,
+                          *self.in_shape, self.in_type, 0, self.in_scale, self.in_zp, table_at,
+                          self.name.encode()[:27])
+        return hdr + body
+
+
+def hwc(shape):
+    """TFLite [1, h, w, c] / [1, n] to (h, w, c)."""
+    if len(shape) == 4:
+        return tuple(shape[1:])
+    return (1, 1, shape[-1])
+
+
+def unpack(t):
+    fmt = "<%db" if t["type"] == 9 else "<%di"
+    size = 1 if t["type"] == 9 else 4
+    return list(struct.unpack(fmt % (len(t["data"]) // size), t["data"]))
+
+
+def int8_blob(path):
+    tensors, ops = q8x.read_model(path)
+    if [op["code"] for op in ops] != [code for _, code in q8x.LAYERS]:
+        sys.exit("unexpected op sequence")
+    tin = tensors[ops[0]["inputs"][0]]
+    blob = Blob("ds_cnn_tiny_v2_int8", hwc(tin["shape"]), I8, tin["scale"][0], tin["zp"][0])
+
+    for (prefix, code), op in zip(q8x.LAYERS, ops):
+        ti, to = tensors[op["inputs"][0]], tensors[op["outputs"][0]]
+        ish, osh = hwc(ti["shape"]), hwc(to["shape"])
+        in_zp, out_zp = ti["zp"][0], to["zp"][0]
+        if code in (q8x.CONV_2D, q8x.DEPTHWISE_CONV_2D, q8x.FULLY_CONNECTED):
+            tw, tb = tensors[op["inputs"][1]], tensors[op["inputs"][2]]
+            w, b = unpack(tw), unpack(tb)
+            mult, shift = zip(*(q8x.quantize_multiplier(ti["scale"][0] * s / to["scale"][0]) for s in tw["scale"]))
+            lo, hi = q8x.act_range(to, code != q8x.FULLY_CONNECTED)
+            q = blob.quant(in_zp, out_zp, lo, hi, mult=mult, shift=shift)
+            if code == q8x.DEPTHWISE_CONV_2D:
+                blob.layer(DW, I8, ish, osh, kernel=(3, 3), stride=(1, 1), weights=blob.i8(w), bias=blob.i32(b), quant=q)
+            elif code == q8x.FULLY_CONNECTED:
+                blob.layer(DENSE, I8, ish, osh, weights=blob.i8(w), bias=blob.i32(b), quant=q)
+            elif tw["shape"][1:3] == [1, 1]:
+                ic = tw["shape"][3]
+                b = [b[o] - in_zp * sum(w[o * ic:(o + 1) * ic]) for o in range(len(b))]
+                blob.layer(PW, I8, ish, osh, kernel=(1, 1), stride=(1, 1), weights=blob.i8(w), bias=blob.i32(b), quant=q)
+            else:
+                blob.layer(CONV, I8, ish, osh, kernel=(3, 3), stride=(1, 1), weights=blob.i8(w), bias=blob.i32(b), quant=q)
+        elif code == q8x.AVERAGE_POOL_2D:
+            if osh[0] != (ish[0] + 1) // 2 or osh[1] != ish[1]:
+                sys.exit("%s: only 2x1 pooling is supported" % prefix)
+            blob.layer(AVGPOOL, I8, ish, osh, kernel=(2, 1), stride=(2, 1))
+        elif code == q8x.MEAN:
+            m, s = q8x.quantize_multiplier(ti["scale"][0] / to["scale"][0])
+            q = blob.quant(in_zp, out_zp, mult=[m], shift=[s])
+            blob.layer(GAP, I8, ish, (1, 1, osh[2]), quant=q)
+        else:
+            blob.layer(SOFTMAX, I8, ish, osh, quant=blob.quant(in_zp, in_scale=ti["scale"][0]))
+    return blob
+
+
+def float_blob(path, in_scale, in_zp):
+    packed, _ = mc.compile_model(mc.read_export(path))
+    arr = {name: values for name, _, _, values in packed}
+    c1, c2, n = mc.C1, mc.C2, mc.NUM_CLASSES
+    h, w = 65, 10
+    # [tap][oc] -> [oc][kh][kw][ic]
+    conv_w = [arr["fp_conv_w"][tap * c1 + oc] for oc in range(c1) for tap in range(9)]
+    blob = Blob("manual_dscnn_f32", (h, w, 1), F32, in_scale, in_zp)
+    blob.layer(CONV, F32, (h, w, 1), (h, w, c1), ACT_RELU, (3, 3), (1, 1), weights=blob.f32(conv_w))
+    blob.layer(PW, F32, (h, w, c1), (h, w, c2), ACT_RELU, (1, 1), (1, 1),
+               weights=blob.f32(arr["fp_pw_w"]), bias=blob.f32(arr["fp_pw_b"]))
+    blob.layer(GAP, F32, (h, w, c2), (1, 1, c2))
+    blob.layer(DENSE, F32, (1, 1, c2), (1, 1, n), weights=blob.f32(arr["fp_dense_w"]), bias=blob.f32(arr["fp_dense_b"]))
+    blob.layer(SOFTMAX, F32, (1, 1, n), (1, 1, n))
+    return blob
+
+
+def slot_image(raw, sequence=1):
+    """ModelSlotRecord + blob, as ModelStore::finishUpdate() leaves a slot."""
+    record = struct.pack("<4I", SLOT_MAGIC, sequence, len(raw), zlib.crc32(raw) & 0xFFFFFFFF)
+    return record + raw
+
+
+def main():
+    args = [a for a in sys.argv[1:] if a != "--slot"]
+    out = args[0] if args else os.path.join(ROOT, "models")
+    q = int8_blob(q8x.DEFAULT_SRC)
+    f = float_blob(mc.DEFAULT_SRC, q.in_scale, q.in_zp)
+    for blob in (q, f):
+        dst = os.path.join(out, blob.name + ".kwsm")
+        raw = blob.build()
+        with open(dst, "wb") as fh:
+            fh.write(raw)
+        print("wrote %s (%d layers, %d bytes)" % (dst, len(blob.layers), len(raw)))
+        if "--slot" in sys.argv:
+            with open(os.path.join(out, blob.name + ".slot.bin"), "wb") as fh:
+                fh.write(slot_image(raw))
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,158 @@
+#!/usr/bin/env python3
+"""Compile the float DS-CNN export into kernel-ready weights.
+
+models/model_weights_float.h is the raw training export: HWIO convolution
+weights plus gamma/beta/mean/var for every BatchNorm, many of which the
+float network never uses. This folds each BatchNorm ManualDSCNN applies into
+the linear layer next to it, drops every parameter it does not need, lays the
+weights out in the order its kernels stream them, and writes:
+
+  models/model_float_packed.h    aligned constexpr arrays (fp_*)
+  models/model_float_manifest.json  shapes, layouts and CRC-32 of each array
+
+so the device does no normalization arithmetic at inference time.
+
+ManualDSCNN runs conv -> ReLU -> BN7 -> pw -> ReLU -> BN9 -> GAP -> dense.
+Each BN sits after a ReLU, so it cannot move back into the convolution in
+front of it; it folds forward instead, which is exact because what follows
+is linear (pw, and GAP + dense):
+    W'[o][i] = W[i][o] * s[i]      b'[o] = b[o] + sum_i W[i][o] * t[i]
+with s = gamma / sqrt(var + eps) and t = beta - mean * s.
+
+Standard library only:
+    python3 tools/model_compiler.py [model_weights_float.h] [out.h] [manifest.json]
+"""
+import json
+import math
+import os
+import re
+import struct
+import sys
+import zlib
+
+ROOT = os.path.dirname(os.path.dirname(os.path.abspath(__file__)))
+DEFAULT_SRC = os.path.join(ROOT, "models", "model_weights_float.h")
+DEFAULT_OUT = os.path.join(ROOT, "models", "model_float_packed.h")
+DEFAULT_MANIFEST = os.path.join(ROOT, "models", "model_float_manifest.json")
+
+BN_EPS = 1e-5
+ALIGN = 16
+C1, C2 = 16, 24         # ManualDSCNN channel widths
+NUM_CLASSES = 3
+
+
+def f32(v):
+    """Round to the nearest float32, as the device would store it."""
+    return struct.unpack("<f", struct.pack("<f", v))[0]
+
+
+def read_export(path):
+    src = open(path).read()
+    arrays = {}
+    for m in re.finditer(r"//\s*(\w+) shape: \[([\d, ]*)\]\s*\nconst float (\w+)\[\] = \{([^}]*)\};", src):
+        name, shape = m.group(3), [int(d) for d in m.group(2).split(",") if d.strip()]
+        values = [float(v.strip().rstrip("f")) for v in m.group(4).replace("\n", " ").split(",") if v.strip()]
+        if math.prod(shape) != len(values):
+            sys.exit("%s: %d values for shape %s" % (name, len(values), shape))
+        arrays[name] = (shape, values)
+    return arrays
+
+
+def bn_affine(arrays, idx):
+    g = arrays["batch_normalization_%d_gamma" % idx][1]
+    b = arrays["batch_normalization_%d_beta" % idx][1]
+    m = arrays["batch_normalization_%d_mean" % idx][1]
+    v = arrays["batch_normalization_%d_var" % idx][1]
+    s = [g[c] / math.sqrt(v[c] + BN_EPS) for c in range(len(g))]
+    return s, [b[c] - m[c] * s[c] for c in range(len(g))]
+
+
+def fold_forward(w_io, bias, ic, oc, s, t):
+    """Fold y = BN(x) into the following layer; w_io is [ic][oc], result is [oc][ic]."""
+    w = [[w_io[i * oc + o] * s[i] for i in range(ic)] for o in range(oc)]
+    b = [bias[o] + sum(w_io[i * oc + o] * t[i] for i in range(ic)) for o in range(oc)]
+    return [v for row in w for v in row], b
+
+
+def compile_model(arrays):
+    """Returns [(name, shape, layout, values)] in execution order, and the dropped names."""
+    conv_w = arrays["conv2d_1_w"][1]                      # [3][3][1][16]: tap-major, oc contiguous
+    s7, t7 = bn_affine(arrays, 7)
+    pw_w, pw_b = fold_forward(arrays["b1_pw_w"][1], [0.0] * C2, C1, C2, s7, t7)
+    s9, t9 = bn_affine(arrays, 9)
+    # dense_1_w is 48x3 and belongs to the full network's 48-channel GAP;
+    # the truncated float model keeps its zero stub, folded all the same.
+    dense_w, dense_b = fold_forward([0.0] * (C2 * NUM_CLASSES), arrays["dense_1_b"][1],
+                                    C2, NUM_CLASSES, s9, t9)
+    packed = [
+        ("fp_conv_w", [9, C1], "[tap][oc], tap = (kt + 1) * 3 + (kf + 1)", conv_w),
+        ("fp_pw_w", [C2, C1], "[oc][ic], BN7 folded in", pw_w),
+        ("fp_pw_b", [C2], "[oc], BN7 shift folded in", pw_b),
+        ("fp_dense_w", [NUM_CLASSES, C2], "[oc][ic], BN9 folded in (zero stub)", dense_w),
+        ("fp_dense_b", [NUM_CLASSES], "[oc], BN9 shift folded in", dense_b),
+    ]
+    used = {"conv2d_1_w", "b1_pw_w", "dense_1_b"} | {
+        "batch_normalization_%d_%s" % (i, p) for i in (7, 9) for p in ("gamma", "beta", "mean", "var")}
+    return [(n, s, l, [f32(v) for v in vals]) for n, s, l, vals in packed], sorted(set(arrays) - used)
+
+
+def c_float(v):
+    s = "%.9g" % v
+    return s + ("f" if any(c in s for c in ".en") else ".0f")
+
+
+def crc32(values):
+    return zlib.crc32(struct.pack("<%df" % len(values), *values)) & 0xFFFFFFFF
+
+
+def emit(packed, dropped, src_name):
+    out = [
+        "#pragma once",
+        "",
+        "// Generated by tools/model_compiler.py from %s. Do not edit." % src_name,
+        "// ManualDSCNN weights with every BatchNorm folded into the next linear",
+        "// layer, in the layout its kernels read them. Shapes and CRC-32s are in",
+        "// models/model_float_manifest.json.",
+        "// Dropped (unused by the float network): %d arrays." % len(dropped),
+        "",
+    ]
+    for name, shape, layout, values in packed:
+        out.append("// %s %s: %s, crc32 %08x" % (name, "x".join(map(str, shape)), layout, crc32(values)))
+        out.append("alignas(%d) constexpr float %s[%d] = {" % (ALIGN, name, len(values)))
+        for k in range(0, len(values), 8):
+            out.append("  " + ", ".join(c_float(v) for v in values[k:k + 8]) + ",")
+        out.append("};")
+        out.append("")
+    return "\n".join(out)
+
+
+def manifest(packed, dropped, src_name):
+    return {
+        "source": src_name,
+        "bn_eps": BN_EPS,
+        "align": ALIGN,
+        "tensors": [
+            {"name": n, "shape": s, "layout": l, "dtype": "float32",
+             "bytes": 4 * len(v), "crc32": "%08x" % crc32(v)}
+            for n, s, l, v in packed
+        ],
+        "dropped": dropped,
+    }
+
+
+def main():
+    src = sys.argv[1] if len(sys.argv) > 1 else DEFAULT_SRC
+    dst = sys.argv[2] if len(sys.argv) > 2 else DEFAULT_OUT
+    man = sys.argv[3] if len(sys.argv) > 3 else DEFAULT_MANIFEST
+    packed, dropped = compile_model(read_export(src))
+    src_name = os.path.relpath(src, ROOT)
+    with open(dst, "w") as f:
+        f.write(emit(packed, dropped, src_name))
+    with open(man, "w") as f:
+        json.dump(manifest(packed, dropped, src_name), f, indent=2)
+        f.write("\n")
+    print("wrote %s, %s (%d arrays dropped)" % (dst, man, len(dropped)))
+
+
+if __name__ == "__main__":
+    main()
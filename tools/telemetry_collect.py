@@ -0,0 +1,161 @@
+#!/usr/bin/env python3
+"""Collect and summarise lib/Telemetry snapshots.
+
+Polls the firmware's endpoint and prints each interval: counter rates,
+per-stage percentiles over that interval (from the bucket deltas), CPU
+load and memory. Given files instead (kws_run -j), it prints the totals
+in each. Snapshots can be appended to a JSON-lines log for later analysis.
+    python3 tools/telemetry_collect.py http://192.168.1.50:8081/telemetry
+    python3 tools/telemetry_collect.py http://... --interval 60 --log fleet.jsonl
+    python3 tools/telemetry_collect.py telemetry.json
+
+--count N stops after N polls. Exits 2 when a source cannot be read or is
+not a telemetry snapshot. Standard library only.
+"""
+import json
+import sys
+import time
+import urllib.request
+
+
+def lower(i):
+    """Smallest value in LatencyHistogram bucket i (see LatencyHistogram.h)."""
+    if i < 4:
+        return i
+    return (4 + i % 4) << (i // 4 - 1)
+
+
+def bucket(v):
+    if v < 4:
+        return v
+    e = v.bit_length() - 1
+    return (e - 1) * 4 + ((v >> (e - 2)) & 3)
+
+
+def quantile(buckets, q, vmax):
+    """Upper edge of the bucket holding the q-quantile, as the firmware does."""
+    total = sum(n for _, n in buckets)
+    if total == 0:
+        return 0
+    rank = int(q * (total - 1))
+    seen = 0
+    for lo, n in sorted(buckets):
+        seen += n
+        if seen > rank:
+            return min(lower(bucket(lo) + 1) - 1, vmax)
+    return vmax
+
+
+def load(source):
+    if source.startswith("http://") or source.startswith("https://"):
+        with urllib.request.urlopen(source, timeout=10) as r:
+            snap = json.loads(r.read().decode())
+    else:
+        with open(source) as fh:
+            snap = json.load(fh)
+    for key in ("uptime_ms", "counters", "stages", "memory", "cpu_busy"):
+        if key not in snap:
+            raise ValueError("not a telemetry snapshot, no %s" % key)
+    return snap
+
+
+def delta(now, prev):
+    """now minus prev, or now when there is no prev or the device restarted."""
+    if prev is None or now["uptime_ms"] < prev["uptime_ms"]:
+        return now, now["uptime_ms"] / 1000.0
+    d = dict(now)
+    d["counters"] = {k: v - prev["counters"].get(k, 0) for k, v in now["counters"].items()}
+    before = {s["name"]: dict((lo, n) for lo, n in s["buckets"]) for s in prev["stages"]}
+    d["stages"] = []
+    for s in now["stages"]:
+        old = before.get(s["name"], {})
+        b = [[lo, n - old.get(lo, 0)] for lo, n in s["buckets"] if n - old.get(lo, 0) > 0]
+        d["stages"].append(dict(s, buckets=b, count=sum(n for _, n in b)))
+    return d, (now["uptime_ms"] - prev["uptime_ms"]) / 1000.0
+
+
+def show(snap, span, out):
+    c = snap["counters"]
+    rate = lambda n: n / span if span > 0 else 0.0
+    cpu = "/".join("-" if x is None else "%.0f%%" % (100 * x) for x in snap["cpu_busy"])
+    m = snap["memory"]
+    out.write("%s up %.1fs, over %.1fs: %d hops (%.1f/s), %.1f%% gated, %d inferences (%.1f/s), "
+              "%d detections, %d samples dropped, cpu %s\n" % (
+                  snap["target"], snap["uptime_ms"] / 1000.0, span, c["hops"], rate(c["hops"]),
+                  100.0 * c["gated_hops"] / c["hops"] if c["hops"] else 0.0,
+                  c["inferences"], rate(c["inferences"]), c["detections"], c["dropped_samples"], cpu))
+    out.write("  sram free %d (min %d), psram free %d (min %d), stack min free %s\n" % (
+        m["sram_free"], m["sram_min_free"], m["psram_free"], m["psram_min_free"],
+        "/".join(str(x) for x in m["stack_min_free"])))
+    hz = snap["cycle_hz"] or 1
+    for s in snap["stages"]:
+        b = [tuple(x) for x in s["buckets"]]
+        q = [quantile(b, p, s["max"]) for p in (0.50, 0.90, 0.99)]
+        if s["unit"] == "cycles":
+            ms = ["%.3f" % (1000.0 * v / hz) for v in q]
+        else:
+            ms = ["%.3f" % (v / 1000.0) for v in q]
+        out.write("  %-20s n=%-7d p50 %s  p90 %s  p99 %s ms\n" % (s["name"], s["count"], ms[0], ms[1], ms[2]))
+
+
+def option(args, name, default, kind):
+    if name not in args:
+        return default
+    i = args.index(name)
+    value = kind(args[i + 1])
+    del args[i:i + 2]
+    return value
+
+
+def main():
+    args = sys.argv[1:]
+    interval = option(args, "--interval", 10.0, float)
+    count = option(args, "--count", 0, int)
+    log = option(args, "--log", None, str)
+    if not args or any(a.startswith("--") for a in args):
+        print(__doc__.strip(), file=sys.stderr)
+        return 2
+    logf = open(log, "a") if log else None
+
+    urls = [a for a in args if "://" in a]
+    for path in (a for a in args if "://" not in a):
+        try:
+            snap = load(path)
+        except (OSError, ValueError) as e:
+            print("cannot read %s: %s" % (path, e), file=sys.stderr)
+            return 2
+        print(path)
+        show(snap, snap["uptime_ms"] / 1000.0, sys.stdout)
+        if logf:
+            logf.write(json.dumps(snap) + "\n")
+
+    prev = {}
+    polls = 0
+    while urls and (count == 0 or polls < count):
+        if polls:
+            time.sleep(interval)
+        polls += 1
+        for url in urls:
+            try:
+                snap = load(url)
+            except (OSError, ValueError) as e:
+                print("%s: %s" % (url, e), file=sys.stderr)
+                if count:
+                    return 2
+                continue
+            d, span = delta(snap, prev.get(url))
+            prev[url] = snap
+            print(url)
+            show(d, span, sys.stdout)
+            sys.stdout.flush()
+            if logf:
+                logf.write(json.dumps(snap) + "\n")
+                logf.flush()
+    return 0
+
+
+if __name__ == "__main__":
+    try:
+        sys.exit(main())
+    except KeyboardInterrupt:
+        sys.exit(0)
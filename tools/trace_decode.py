@@ -0,0 +1,167 @@
+#!/usr/bin/env python3
+"""Turn lib/Trace batches into a timeline.
+
+Input is the raw sink stream: a file from kws_run -t, a capture of the
+board's serial port with TRACE_SINK_UART (text logs in between are
+skipped), or live UDP datagrams with TRACE_SINK_UDP:
+    python3 tools/trace_decode.py trace.bin
+    python3 tools/trace_decode.py serial.log --events INFER_RESULT,DETECTION
+    python3 tools/trace_decode.py --udp 9999
+
+Event names, levels and payload formats come from TRACE_EVENT_LIST in
+lib/Trace/TraceEvents.h, so new events decode without touching this file.
+Times are milliseconds from the first event, per core; cycle counters are
+32 bits, so a gap longer than one wrap (about 17 s at 240 MHz) between
+batches of a core shifts its later times. Standard library only.
+"""
+import os
+import re
+import socket
+import struct
+import sys
+
+MAGIC = 0x5453574B
+VERSION = 1
+HEADER = struct.Struct("<IBBHII")
+EVENT = struct.Struct("<HBBIII")
+EVENTS_H = os.path.join(os.path.dirname(os.path.abspath(__file__)),
+                        "..", "lib", "Trace", "TraceEvents.h")
+
+
+def load_events(path):
+    """[(name, level, fmt_a, fmt_b, comment)] in ID order."""
+    with open(path) as fh:
+        text = fh.read()
+    pat = re.compile(r'X\((\w+),\s*(\d+),\s*"(\w|-)",\s*"(\w|-)"\)\s*(?:/\*\s*(.*?)\s*\*/)?')
+    return [(m.group(1), int(m.group(2)), m.group(3), m.group(4), m.group(5) or "")
+            for m in pat.finditer(text.split("TRACE_EVENT_LIST(X)", 1)[1])]
+
+
+def word(fmt, w):
+    if fmt == "-":
+        return None
+    if fmt == "f":
+        return "%.6g" % struct.unpack("<f", struct.pack("<I", w))[0]
+    if fmt == "i":
+        return str(struct.unpack("<i", struct.pack("<I", w))[0])
+    if fmt == "x":
+        return "0x%08x" % w
+    return str(w)
+
+
+class Decoder:
+    def __init__(self, events):
+        self.events = events
+        self.buf = b""
+        self.clock = {}    # core -> [last raw cycles, unwrapped high part]
+        self.rows = []     # (cycles, cycle_hz, core, text)
+        self.dropped = 0
+        self.skipped = 0
+
+    def feed(self, data):
+        self.buf += data
+        while True:
+            i = self.buf.find(struct.pack("<I", MAGIC))
+            if i < 0:
+                keep = len(self.buf) - 3 if len(self.buf) > 3 else 0
+                self.skipped += keep
+                self.buf = self.buf[keep:]
+                return
+            self.skipped += i
+            self.buf = self.buf[i:]
+            if len(self.buf) < HEADER.size:
+                return
+            magic, version, core, count, hz, dropped = HEADER.unpack_from(self.buf)
+            if version != VERSION or hz == 0:
+                self.buf = self.buf[1:]
+                self.skipped += 1
+                continue
+            end = HEADER.size + count * EVENT.size
+            if len(self.buf) < end:
+                return
+            self.batch(core, hz, dropped, self.buf[HEADER.size:end])
+            self.buf = self.buf[end:]
+
+    def batch(self, core, hz, dropped, body):
+        if dropped:
+            self.dropped += dropped
+            t = self.clock[core][0] + self.clock[core][1] if core in self.clock else 0
+            self.rows.append((t, hz, core, "** %d event(s) dropped, ring full" % dropped))
+        for off in range(0, len(body), EVENT.size):
+            eid, ev_core, _, cycles, a, b = EVENT.unpack_from(body, off)
+            last, high = self.clock.get(ev_core, (cycles, 0))
+            if cycles < last:
+                high += 1 << 32
+            self.clock[ev_core] = (cycles, high)
+            if eid < len(self.events):
+                name, _, fa, fb, _ = self.events[eid]
+                args = [x for x in (word(fa, a), word(fb, b)) if x is not None]
+                text = "%-18s %s" % (name, " ".join(args))
+            else:
+                text = "event#%-12d 0x%08x 0x%08x" % (eid, a, b)
+            self.rows.append((cycles + high, hz, ev_core, text))
+
+    def timeline(self, out, only):
+        if not self.rows:
+            return
+        # Cores count cycles independently; each starts at its first event.
+        start = {}
+        for cyc, hz, core, _ in self.rows:
+            start[core] = min(start.get(core, cyc), cyc)
+        rows = sorted(((cyc - start[core]) * 1000.0 / hz, core, text)
+                      for cyc, hz, core, text in self.rows)
+        for ms, core, text in rows:
+            if only and text.split()[0] not in only and not text.startswith("**"):
+                continue
+            out.write("%12.3f  c%d  %s\n" % (ms, core, text))
+
+
+def main():
+    args = sys.argv[1:]
+    only = set()
+    if "--events" in args:
+        i = args.index("--events")
+        only = set(args[i + 1].split(","))
+        del args[i:i + 2]
+    udp = None
+    if "--udp" in args:
+        i = args.index("--udp")
+        udp = int(args[i + 1])
+        del args[i:i + 2]
+    if (udp is None) == (len(args) != 1):
+        print(__doc__.strip(), file=sys.stderr)
+        return 2
+
+    try:
+        dec = Decoder(load_events(EVENTS_H))
+    except (OSError, IndexError) as e:
+        print("cannot read the event list in %s: %s" % (EVENTS_H, e), file=sys.stderr)
+        return 2
+
+    if udp is None:
+        try:
+            with open(args[0], "rb") as fh:
+                dec.feed(fh.read())
+        except OSError as e:
+            print("cannot read %s: %s" % (args[0], e), file=sys.stderr)
+            return 2
+    else:
+        # Collect until Ctrl-C, then print the timeline.
+        sock = socket.socket(socket.AF_INET, socket.SOCK_DGRAM)
+        sock.bind(("", udp))
+        print("listening on udp/%d, Ctrl-C to stop" % udp, file=sys.stderr)
+        try:
+            while True:
+                dec.feed(sock.recv(65536))
+        except KeyboardInterrupt:
+            pass
+
+    dec.timeline(sys.stdout, only)
+    print("%d event(s), %d dropped on the device, %d byte(s) of other data skipped"
+          % (sum(1 for r in dec.rows if not r[3].startswith("**")), dec.dropped, dec.skipped),
+          file=sys.stderr)
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())